@@ -1,8 +1,8 @@
 #version 330 core
-in vec4 vColor;
+in vec4 Color;
 out vec4 FragColor;
 
 void main()
 {
-    FragColor = vColor;
+    FragColor = Color;
 }
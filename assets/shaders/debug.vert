@@ -2,13 +2,17 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec4 aColor;
 
-out vec4 vColor;
+out vec4 Color;
 
-uniform mat4 view;
-uniform mat4 projection;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
 
 void main()
 {
-    vColor = aColor;
+    Color = aColor;
     gl_Position = projection * view * vec4(aPos, 1.0);
 }
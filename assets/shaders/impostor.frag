@@ -0,0 +1,37 @@
+#version 410 core
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 vWorldPos;
+
+uniform sampler2D uImpostor;
+layout(std140) uniform LightBlock {
+    mat4 lightSpaceMatrices[4];
+    vec4 cascadeSplits;
+    vec3 lightPos;
+    int cascadeCount;
+    vec3 lightColor;
+};
+
+// ----------------------------------------------------------
+// Fog of war: light factor per nav cell (R8, bilinear)
+// ----------------------------------------------------------
+uniform sampler2D uFogTexture;
+uniform bool uFogEnabled;
+uniform vec2 uFogOrigin;   // world xz of the nav grid corner
+uniform vec2 uFogInvSize;  // 1 / nav grid extent in world units
+
+float fogOfWar(vec3 worldPos)
+{
+    if (!uFogEnabled)
+        return 1.0;
+    return texture(uFogTexture, (worldPos.xz - uFogOrigin) * uFogInvSize).r;
+}
+
+void main()
+{
+    vec4 texel = texture(uImpostor, TexCoords);
+    if (texel.a < 0.5) discard;
+    FragColor = vec4(texel.rgb * lightColor * fogOfWar(vWorldPos), 1.0);
+}
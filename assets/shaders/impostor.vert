@@ -0,0 +1,34 @@
+#version 410 core
+
+layout (location = 0) in vec2 aCorner;    // x in [-0.5, 0.5], y in [0, 1]
+layout (location = 1) in vec4 iPosScale;  // xyz = world position, w = scale
+
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
+uniform vec2 uImpostorSize;  // object-space width, height
+uniform float uImpostorBase; // object-space bottom
+
+out vec2 TexCoords;
+out vec3 vWorldPos;
+
+void main()
+{
+    // Cylindrical billboard: rotate about Y to face the camera.
+    vec3 toEye = viewPos - iPosScale.xyz;
+    toEye.y = 0.0;
+    vec3 forward = dot(toEye, toEye) > 1e-6 ? normalize(toEye) : vec3(0.0, 0.0, 1.0);
+    vec3 right = vec3(forward.z, 0.0, -forward.x);
+
+    float scale = iPosScale.w;
+    vec3 worldPos = iPosScale.xyz
+                  + right * (aCorner.x * uImpostorSize.x * scale)
+                  + vec3(0.0, (uImpostorBase + aCorner.y * uImpostorSize.y) * scale, 0.0);
+
+    TexCoords = vec2(aCorner.x + 0.5, aCorner.y);
+    vWorldPos = worldPos;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
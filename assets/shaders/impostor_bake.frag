@@ -0,0 +1,20 @@
+#version 410 core
+
+out vec4 FragColor;
+
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform sampler2D texture_diffuse1;
+uniform vec3 uMaterialColor;
+uniform bool useTexture;
+uniform vec3 uLightDir;
+
+// Lighting is baked with the same ambient/diffuse split as
+// simple.frag; the runtime shader only applies lightColor.
+void main()
+{
+    vec3 albedo = useTexture ? texture(texture_diffuse1, TexCoords).rgb : uMaterialColor;
+    float diff = max(dot(normalize(Normal), uLightDir), 0.0);
+    FragColor = vec4(albedo * (0.3 + 0.7 * diff), 1.0);
+}
@@ -1,12 +1,21 @@
 #version 330 core
 in vec2 TexCoord;
+in vec4 Tint;
+in float Health;
 out vec4 FragColor;
 
 uniform sampler2D uTexture;
-uniform vec4 uTint;
+uniform int uMode;
 
 void main()
 {
-    vec4 tex = texture(uTexture, TexCoord);
-    FragColor = tex * uTint;
+    if (uMode == 0)
+    {
+        FragColor = texture(uTexture, TexCoord) * Tint;
+        return;
+    }
+
+    vec3 fill = mix(vec3(0.85, 0.15, 0.1), vec3(0.2, 0.85, 0.25), Health);
+    vec3 color = TexCoord.x <= Health ? fill : vec3(0.08);
+    FragColor = vec4(color, 0.9);
 }
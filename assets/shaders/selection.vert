@@ -1,15 +1,50 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aUV;
+// Per instance (SelectionRings)
+layout (location = 2) in vec4 iPosRadius;   // xyz ground point, w ring radius
+layout (location = 3) in vec4 iTint;
+layout (location = 4) in float iHealth;     // bar fill, < 0 = no bar
 
 out vec2 TexCoord;
+out vec4 Tint;
+out float Health;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
+
+uniform int uMode;            // 0 = ground ring, 1 = health bar
+uniform float uBarLift;
+uniform vec2 uBarHalfSize;
 
 void main()
 {
     TexCoord = aUV;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    Tint = iTint;
+    Health = iHealth;
+
+    if (uMode == 0)
+    {
+        vec3 world = iPosRadius.xyz + aPos * vec3(iPosRadius.w, 1.0, iPosRadius.w);
+        gl_Position = projection * view * vec4(world, 1.0);
+        return;
+    }
+
+    if (iHealth < 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);   // outside the clip volume
+        return;
+    }
+
+    // Camera-facing bar: quad x runs along the view's right axis, z
+    // down its up axis (uv.x = 0 is the empty end).
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up    = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 center = iPosRadius.xyz + vec3(0.0, uBarLift, 0.0);
+    vec3 world = center + right * (aPos.x * uBarHalfSize.x) - up * (aPos.z * uBarHalfSize.y);
+    gl_Position = projection * view * vec4(world, 1.0);
 }
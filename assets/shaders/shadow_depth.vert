@@ -7,19 +7,36 @@ layout (location = 3) in vec4 iRow0;
 layout (location = 4) in vec4 iRow1;
 layout (location = 5) in vec4 iRow2;
 layout (location = 6) in vec4 iRow3;
+layout (location = 10) in int iBoneBase; // bone palette offset (batched skinned units)
 
-uniform mat4 lightSpaceMatrix;
+layout(std140) uniform LightBlock {
+    mat4 lightSpaceMatrices[4];
+    vec4 cascadeSplits;
+    vec3 lightPos;
+    int cascadeCount;
+    vec3 lightColor;
+};
+uniform int uCascade;
 uniform mat4 model;
 uniform bool isInstanced;
 uniform bool uUseSkinning;
 uniform samplerBuffer uBoneTexture;
 uniform int uBoneCount;
+uniform int uBoneBase;    // bone palette offset for non-instanced draws
+uniform bool uPreskinned;  // boneBase is a vertex base into uSkinnedVertices
+uniform samplerBuffer uSkinnedVertices; // SkinningPrepass output: 2 texels per vertex
 
 void main()
 {
     mat4 M = isInstanced ? mat4(iRow0, iRow1, iRow2, iRow3) : model;
     vec4 localPos = vec4(aPos, 1.0);
-    if (uUseSkinning && uBoneCount > 0)
+    // All skinned units share one palette; each reads from its own offset.
+    int boneBase = isInstanced ? iBoneBase : uBoneBase;
+    if (uPreskinned)
+    {
+        localPos = vec4(texelFetch(uSkinnedVertices, (boneBase + gl_VertexID) * 2).xyz, 1.0);
+    }
+    else if (uUseSkinning && uBoneCount > 0)
     {
         float weightSum = aBoneWeights.x + aBoneWeights.y + aBoneWeights.z + aBoneWeights.w;
         if (weightSum > 0.0f)
@@ -27,7 +44,7 @@ void main()
             mat4 skinMat = mat4(0.0);
             if (aBoneIDs.x < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.x) * 4;
+                int base = (boneBase + int(aBoneIDs.x)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -38,7 +55,7 @@ void main()
             }
             if (aBoneIDs.y < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.y) * 4;
+                int base = (boneBase + int(aBoneIDs.y)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -49,7 +66,7 @@ void main()
             }
             if (aBoneIDs.z < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.z) * 4;
+                int base = (boneBase + int(aBoneIDs.z)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -60,7 +77,7 @@ void main()
             }
             if (aBoneIDs.w < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.w) * 4;
+                int base = (boneBase + int(aBoneIDs.w)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -72,5 +89,5 @@ void main()
             localPos = skinMat * localPos;
         }
     }
-    gl_Position = lightSpaceMatrix * M * localPos;
+    gl_Position = lightSpaceMatrices[uCascade] * M * localPos;
 }
@@ -5,50 +5,80 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
-in vec4 FragPosLightSpace;
-in float vClipDist;
+in vec4 vTint;
 
 uniform sampler2D texture_diffuse1;
-uniform sampler2D shadowMap;
+uniform sampler2DArray shadowMap;
 uniform vec3 uMaterialColor;
 uniform bool useTexture; // Pass 'false' for buildings, 'true' for trees
 uniform float uAlpha;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-
-const float SHADOW_MAP_SIZE = 2048.0;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
+
+layout(std140) uniform LightBlock {
+    mat4 lightSpaceMatrices[4];
+    vec4 cascadeSplits;
+    vec3 lightPos;
+    int cascadeCount;
+    vec3 lightColor;
+};
+
+// ----------------------------------------------------------
+// Fog of war: light factor per nav cell (R8, bilinear)
+// ----------------------------------------------------------
+uniform sampler2D uFogTexture;
+uniform bool uFogEnabled;
+uniform vec2 uFogOrigin;   // world xz of the nav grid corner
+uniform vec2 uFogInvSize;  // 1 / nav grid extent in world units
+
+float fogOfWar(vec3 worldPos)
+{
+    if (!uFogEnabled)
+        return 1.0;
+    return texture(uFogTexture, (worldPos.xz - uFogOrigin) * uFogInvSize).r;
+}
 
-float computeShadow(vec4 fragPosLightSpace)
+// ----------------------------------------------------------
+// Cascaded shadows: pick the cascade by view depth, 3x3 PCF
+// ----------------------------------------------------------
+float computeShadow(vec3 worldPos)
 {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    projCoords = projCoords * 0.5 + 0.5;
+    float depth = -(view * vec4(worldPos, 1.0)).z;
+    if (cascadeCount <= 0 || depth > cascadeSplits[cascadeCount - 1])
+        return 0.0;
+    int cascade = 0;
+    while (cascade < cascadeCount - 1 && depth > cascadeSplits[cascade])
+        ++cascade;
 
+    vec4 lightSpace = lightSpaceMatrices[cascade] * vec4(worldPos, 1.0);
+    vec3 projCoords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
     if (projCoords.z > 1.0)
         return 0.0;
 
-    float shadow = 0.0;
     float bias = 0.0015;
-    float texelSize = 1.0 / SHADOW_MAP_SIZE;
+    float currentDepth = projCoords.z - bias;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
 
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            vec2 offset = vec2(x, y) * texelSize;
-            float closestDepth = texture(shadowMap, projCoords.xy + offset).r;
-            float currentDepth = projCoords.z - bias;
+    float shadow = 0.0;
+    for (int x = -1; x <= 1; ++x)
+    {
+        for (int y = -1; y <= 1; ++y)
+        {
+            float closestDepth = texture(shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, float(cascade))).r;
             shadow += currentDepth > closestDepth ? 1.0 : 0.0;
         }
     }
-
-    shadow /= 9.0;
-    return shadow;
+    return shadow / 9.0;
 }
 
 void main()
 
 {
-    if (vClipDist < 0.0) discard;
     vec3 albedo;
     if (useTexture) {
             albedo = texture(texture_diffuse1, TexCoords).rgb;
@@ -70,9 +100,9 @@ void main()
     float spec      = pow(max(dot(viewDir, reflectDir), 0.0), 16.0);
     vec3 specular   = specularStrength * spec * lightColor;
 
-    float shadow = computeShadow(FragPosLightSpace);
+    float shadow = computeShadow(FragPos);
     vec3 lighting = ambient + (1.0 - shadow) * (diffuse + specular);
 
-    vec3 result = lighting * albedo;
-    FragColor = vec4(result, uAlpha);
+    vec3 result = lighting * albedo * vTint.rgb * fogOfWar(FragPos);
+    FragColor = vec4(result, uAlpha * vTint.a);
 }
@@ -11,25 +11,33 @@ layout (location = 3) in vec4 iRow0;
 layout (location = 4) in vec4 iRow1;
 layout (location = 5) in vec4 iRow2;
 layout (location = 6) in vec4 iRow3;
+layout (location = 9) in vec4 iTint;  // rgb multiply, a = alpha (batched entities)
+layout (location = 10) in int iBoneBase; // bone palette offset (batched skinned units)
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
-out vec4 FragPosLightSpace;
 
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
+
 uniform bool uUseSkinning;
 uniform samplerBuffer uBoneTexture;
 uniform int uBoneCount;
+uniform int uBoneBase;    // bone palette offset for non-instanced draws
+uniform bool uPreskinned;  // boneBase is a vertex base into uSkinnedVertices
+uniform samplerBuffer uSkinnedVertices; // SkinningPrepass output: 2 texels per vertex
 
 // --- NEW UNIFORMS ---
 uniform mat4 model;         // For single buildings
 uniform bool isInstanced;   // Switch: True=Trees, False=Buildings
-uniform vec4 uClipPlane;
+uniform bool uInstanceTint; // iTint is bound (EntityBatcher)
 
-out float vClipDist;
+out vec4 vTint;
 
 void main()
 {
@@ -44,7 +52,15 @@ void main()
     vec4 localPos = vec4(aPos, 1.0);
     vec3 localNormal = aNormal;
 
-    if (uUseSkinning && uBoneCount > 0)
+    // All skinned units share one palette; each reads from its own offset.
+    int boneBase = isInstanced ? iBoneBase : uBoneBase;
+    if (uPreskinned)
+    {
+        int v = (boneBase + gl_VertexID) * 2;
+        localPos = vec4(texelFetch(uSkinnedVertices, v).xyz, 1.0);
+        localNormal = texelFetch(uSkinnedVertices, v + 1).xyz;
+    }
+    else if (uUseSkinning && uBoneCount > 0)
     {
         float weightSum = aBoneWeights.x + aBoneWeights.y + aBoneWeights.z + aBoneWeights.w;
         if (weightSum > 0.0f)
@@ -52,7 +68,7 @@ void main()
             mat4 skinMat = mat4(0.0);
             if (aBoneIDs.x < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.x) * 4;
+                int base = (boneBase + int(aBoneIDs.x)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -63,7 +79,7 @@ void main()
             }
             if (aBoneIDs.y < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.y) * 4;
+                int base = (boneBase + int(aBoneIDs.y)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -74,7 +90,7 @@ void main()
             }
             if (aBoneIDs.z < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.z) * 4;
+                int base = (boneBase + int(aBoneIDs.z)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -85,7 +101,7 @@ void main()
             }
             if (aBoneIDs.w < uint(uBoneCount))
             {
-                int base = int(aBoneIDs.w) * 4;
+                int base = (boneBase + int(aBoneIDs.w)) * 4;
                 mat4 bone = mat4(
                     texelFetch(uBoneTexture, base + 0),
                     texelFetch(uBoneTexture, base + 1),
@@ -101,12 +117,13 @@ void main()
     }
 
     vec4 worldPos = finalModel * localPos;
-    vClipDist = dot(worldPos, uClipPlane);
+    // Clipped only while GL_CLIP_DISTANCE0 is on (water passes)
+    gl_ClipDistance[0] = dot(worldPos, uClipPlane);
 
     FragPos = worldPos.xyz;
     Normal  = mat3(transpose(inverse(finalModel))) * localNormal;
     TexCoords = aTexCoords;
-    FragPosLightSpace = lightSpaceMatrix * worldPos;
+    vTint = (isInstanced && uInstanceTint) ? iTint : vec4(1.0);
 
     gl_Position = projection * view * worldPos;
 }
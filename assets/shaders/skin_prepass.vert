@@ -0,0 +1,77 @@
+#version 410 core
+
+// Transform feedback only (rasteriser discarded): one point per mesh
+// vertex, written to the SkinningPrepass buffer in VBO order.
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 7) in uvec4 aBoneIDs;
+layout (location = 8) in vec4 aBoneWeights;
+
+uniform samplerBuffer uBoneTexture;
+uniform int uBoneCount;
+uniform int uBoneBase;    // palette offset, or frame in the baked texture
+
+out vec3 tfPosition;
+out vec3 tfNormal;
+
+void main()
+{
+    vec4 localPos = vec4(aPos, 1.0);
+    vec3 localNormal = aNormal;
+
+    float weightSum = aBoneWeights.x + aBoneWeights.y + aBoneWeights.z + aBoneWeights.w;
+    if (uBoneCount > 0 && weightSum > 0.0f)
+    {
+        mat4 skinMat = mat4(0.0);
+        if (aBoneIDs.x < uint(uBoneCount))
+        {
+            int base = (uBoneBase + int(aBoneIDs.x)) * 4;
+            mat4 bone = mat4(
+                texelFetch(uBoneTexture, base + 0),
+                texelFetch(uBoneTexture, base + 1),
+                texelFetch(uBoneTexture, base + 2),
+                texelFetch(uBoneTexture, base + 3)
+            );
+            skinMat += aBoneWeights.x * bone;
+        }
+        if (aBoneIDs.y < uint(uBoneCount))
+        {
+            int base = (uBoneBase + int(aBoneIDs.y)) * 4;
+            mat4 bone = mat4(
+                texelFetch(uBoneTexture, base + 0),
+                texelFetch(uBoneTexture, base + 1),
+                texelFetch(uBoneTexture, base + 2),
+                texelFetch(uBoneTexture, base + 3)
+            );
+            skinMat += aBoneWeights.y * bone;
+        }
+        if (aBoneIDs.z < uint(uBoneCount))
+        {
+            int base = (uBoneBase + int(aBoneIDs.z)) * 4;
+            mat4 bone = mat4(
+                texelFetch(uBoneTexture, base + 0),
+                texelFetch(uBoneTexture, base + 1),
+                texelFetch(uBoneTexture, base + 2),
+                texelFetch(uBoneTexture, base + 3)
+            );
+            skinMat += aBoneWeights.z * bone;
+        }
+        if (aBoneIDs.w < uint(uBoneCount))
+        {
+            int base = (uBoneBase + int(aBoneIDs.w)) * 4;
+            mat4 bone = mat4(
+                texelFetch(uBoneTexture, base + 0),
+                texelFetch(uBoneTexture, base + 1),
+                texelFetch(uBoneTexture, base + 2),
+                texelFetch(uBoneTexture, base + 3)
+            );
+            skinMat += aBoneWeights.w * bone;
+        }
+
+        localPos = skinMat * localPos;
+        localNormal = mat3(skinMat) * localNormal;
+    }
+
+    tfPosition = localPos.xyz;
+    tfNormal = localNormal;
+}
@@ -5,8 +5,6 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
-in vec4 FragPosLightSpace;
-in float vClipDist;
 
 
 // --- Grass Variations ---
@@ -21,44 +19,71 @@ uniform sampler2D texturePeak;
 uniform sampler2D sandTex;
 
 // --- Shadows & Lighting ---
-uniform sampler2D shadowMap;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
+uniform sampler2DArray shadowMap;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
+
+layout(std140) uniform LightBlock {
+    mat4 lightSpaceMatrices[4];
+    vec4 cascadeSplits;
+    vec3 lightPos;
+    int cascadeCount;
+    vec3 lightColor;
+};
 
 // (no need for peakHeightRange anymore)
 // uniform vec2 peakHeightRange;
 
 // ----------------------------------------------------------
-// Shadow Calculation (PCF)
+// Fog of war: light factor per nav cell (R8, bilinear)
 // ----------------------------------------------------------
-float ShadowCalculation(vec4 fragPosLightSpace)
+uniform sampler2D uFogTexture;
+uniform bool uFogEnabled;
+uniform vec2 uFogOrigin;   // world xz of the nav grid corner
+uniform vec2 uFogInvSize;  // 1 / nav grid extent in world units
+
+float fogOfWar(vec3 worldPos)
 {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    projCoords = projCoords * 0.5 + 0.5;
+    if (!uFogEnabled)
+        return 1.0;
+    return texture(uFogTexture, (worldPos.xz - uFogOrigin) * uFogInvSize).r;
+}
 
+// ----------------------------------------------------------
+// Cascaded shadows: pick the cascade by view depth, 3x3 PCF
+// ----------------------------------------------------------
+float computeShadow(vec3 worldPos)
+{
+    float depth = -(view * vec4(worldPos, 1.0)).z;
+    if (cascadeCount <= 0 || depth > cascadeSplits[cascadeCount - 1])
+        return 0.0;
+    int cascade = 0;
+    while (cascade < cascadeCount - 1 && depth > cascadeSplits[cascade])
+        ++cascade;
+
+    vec4 lightSpace = lightSpaceMatrices[cascade] * vec4(worldPos, 1.0);
+    vec3 projCoords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
     if (projCoords.z > 1.0)
         return 0.0;
 
-    float shadow = 0.0;
     float bias = 0.0015;
     float currentDepth = projCoords.z - bias;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
 
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-
-    // 3x3 PCF
+    float shadow = 0.0;
     for (int x = -1; x <= 1; ++x)
     {
         for (int y = -1; y <= 1; ++y)
         {
-            float pcfDepth = texture(shadowMap,
-                                     projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += currentDepth > pcfDepth ? 1.0 : 0.0;
+            float closestDepth = texture(shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, float(cascade))).r;
+            shadow += currentDepth > closestDepth ? 1.0 : 0.0;
         }
     }
-    shadow /= 9.0;
-
-    return shadow;
+    return shadow / 9.0;
 }
 
 // ----------------------------------------------------------
@@ -66,7 +91,6 @@ float ShadowCalculation(vec4 fragPosLightSpace)
 // ----------------------------------------------------------
 void main()
 {
-    if (vClipDist < 0.0) discard;
     // ======================================================
     // 1. GRASS MIXING
     // ======================================================
@@ -145,9 +169,9 @@ if (slope < 0.55)  // lower = steeper
     float spec      = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
     vec3 specular   = specularStrength * spec * lightColor;
 
-    float shadow = ShadowCalculation(FragPosLightSpace);
+    float shadow = computeShadow(FragPos);
 
     vec3 lighting = (ambient + (1.0 - shadow) * (diffuse + specular)) * col;
 
-    FragColor = vec4(lighting, 1.0);
+    FragColor = vec4(lighting * fogOfWar(FragPos), 1.0);
 }
@@ -7,27 +7,27 @@ layout (location = 2) in vec2 aTexCoords;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
-out vec4 FragPosLightSpace;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
 
-uniform vec4 uClipPlane;
-out float vClipDist;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
 
 void main()
 {
     vec4 worldPos = model * vec4(aPos, 1.0);
 
-    vClipDist = dot(worldPos, uClipPlane);
+    // Clipped only while GL_CLIP_DISTANCE0 is on (water passes)
+    gl_ClipDistance[0] = dot(worldPos, uClipPlane);
 
     FragPos = worldPos.xyz;
     Normal  = mat3(transpose(inverse(model))) * aNormal;
     TexCoords = aTexCoords;
 
-    FragPosLightSpace = lightSpaceMatrix * worldPos;
 
     gl_Position = projection * view * worldPos;
 }
@@ -1,16 +1,16 @@
 #version 330 core
 in vec2 vUV;
+in vec4 vTint;
+in float vTextured;
 out vec4 FragColor;
 
 uniform sampler2D uTex;
-uniform vec4 uTint;
-uniform int uHasTexture;  // 0 = solid color, 1 = sampled texture
 
 void main()
 {
-    if (uHasTexture == 1)
+    if (vTextured > 0.5)
     {
-        vec4 color = texture(uTex, vUV) * uTint;
+        vec4 color = texture(uTex, vUV) * vTint;
         if (color.a < 0.01)
             discard;
         FragColor = color;
@@ -18,6 +18,6 @@ void main()
     else
     {
         // solid colored quad (bar background, hover frame, etc.)
-        FragColor = uTint;
+        FragColor = vTint;
     }
 }
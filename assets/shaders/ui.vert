@@ -2,13 +2,19 @@
 
 layout (location = 0) in vec2 aPos;   
 layout (location = 1) in vec2 aUV;
+layout (location = 2) in vec4 aTint;
+layout (location = 3) in float aTextured; // 0 = solid color, 1 = sampled texture
 
 out vec2 vUV;
+out vec4 vTint;
+out float vTextured;
 
 uniform mat4 uProj;               
 
 void main()
 {
     vUV = aUV;
+    vTint = aTint;
+    vTextured = aTextured;
     gl_Position = uProj * vec4(aPos, 0.0, 1.0);
 }
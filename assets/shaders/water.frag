@@ -6,6 +6,13 @@ in float vFade;
 
 uniform float time;
 
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
+
 // legacy textures
 uniform sampler2D textureSampler;
 uniform sampler2D noiseSampler;
@@ -14,15 +21,17 @@ uniform sampler2D overlaySampler;
 // FBO pipeline
 uniform sampler2D uReflection;
 uniform sampler2D uRefraction;
-uniform sampler2D uRefractionDepth;
+// Cameras the two targets were rendered with (reflection mirrored)
+uniform mat4 uReflectionViewProj;
+uniform mat4 uRefractionViewProj;
 uniform sampler2D uFoamNoise;
 
-uniform float uNear;
-uniform float uFar;
+// shoreline signed distance (world units, > 0 in water)
+uniform sampler2D uShoreSDF;
+uniform vec4      uShoreRegion;   // xy origin, zw 1/extent
 
 // water plane info
 uniform float uWaterY;
-uniform vec3  uViewPos;
 
 // tuning
 uniform float uWaveStrength;   // ocean:0.04 lake:0.02 river:0.015
@@ -33,18 +42,34 @@ uniform float uBaseAlpha;      // ocean:0.85 lake:0.80 river:0.75
 uniform float uNoiseWorldScale; // ocean:0.015 lake:0.020 river:0.030
 uniform float uNoiseSpeed;      // ocean:0.020 lake:0.015 river:0.010
 
-// helpers
-float LinearizeDepth(float d)
+// ----------------------------------------------------------
+// Fog of war: light factor per nav cell (R8, bilinear)
+// ----------------------------------------------------------
+uniform sampler2D uFogTexture;
+uniform bool uFogEnabled;
+uniform vec2 uFogOrigin;   // world xz of the nav grid corner
+uniform vec2 uFogInvSize;  // 1 / nav grid extent in world units
+
+float fogOfWar(vec3 worldPos)
 {
-    float z = d * 2.0 - 1.0;
-    return (2.0 * uNear * uFar) / (uFar + uNear - z * (uFar - uNear));
+    if (!uFogEnabled)
+        return 1.0;
+    return texture(uFogTexture, (worldPos.xz - uFogOrigin) * uFogInvSize).r;
 }
 
+// helpers
 vec2 SafeUV(vec2 uv)
 {
     return clamp(uv, vec2(0.001), vec2(0.999));
 }
 
+// Where a world point landed in a render target
+vec2 TargetUV(mat4 viewProj, vec3 worldPos)
+{
+    vec4 clip = viewProj * vec4(worldPos, 1.0);
+    return clip.xy / clip.w * 0.5 + 0.5;
+}
+
 void main()
 {
     // ------------------------------------------------------------
@@ -57,8 +82,8 @@ void main()
 
     // apply distortion to everything (legacy + refl/refr)
     vec2 uvBase = SafeUV(vUV + distortion);
-    vec2 uvRefl = SafeUV(vUV + distortion);
-    vec2 uvRefr = SafeUV(vUV + distortion * 0.8);
+    vec2 uvRefl = SafeUV(TargetUV(uReflectionViewProj, vWorldPos) + distortion);
+    vec2 uvRefr = SafeUV(TargetUV(uRefractionViewProj, vWorldPos) + distortion * 0.8);
 
     // ------------------------------------------------------------
     // 2) Base color (legacy water texture + tint)
@@ -83,33 +108,24 @@ void main()
     vec3 refr = texture(uRefraction, uvRefr).rgb;
 
     // ------------------------------------------------------------
-    // 4) Foam from depth (correct sign)
+    // 4) Foam from the shoreline distance field
     // ------------------------------------------------------------
-    float sceneDepth01 = texture(uRefractionDepth, SafeUV(vUV)).r;
-
-    float foamMask = 0.0;
-    if (sceneDepth01 < 0.9999)
-    {
-        float sceneDepthLin = LinearizeDepth(sceneDepth01);
-        float waterSurfLin  = LinearizeDepth(gl_FragCoord.z);
-
-        // how much "stuff behind water" depth we have at this pixel
-        float waterDepth = max(sceneDepthLin - waterSurfLin, 0.0);
+    vec2  shoreUV    = (vWorldPos.xz - uShoreRegion.xy) * uShoreRegion.zw;
+    float shoreDist  = texture(uShoreSDF, shoreUV).r;
 
-        // foam strongest when shallow (small waterDepth)
-        foamMask = 1.0 - smoothstep(0.15, 2.5, waterDepth);
-        foamMask *= uFoamStrength;
+    // foam strongest right at the shore, fading out into open water
+    float foamMask = 1.0 - smoothstep(0.0, 4.0, max(shoreDist, 0.0));
+    foamMask *= uFoamStrength;
 
-        // breakup using world-space foam noise
-        float fn = texture(uFoamNoise, SafeUV(worldUV * 6.0 + vec2(time * 0.10, time * 0.08))).r;
-        foamMask *= smoothstep(0.35, 0.80, fn);
-    }
+    // breakup using world-space foam noise
+    float fn = texture(uFoamNoise, SafeUV(worldUV * 6.0 + vec2(time * 0.10, time * 0.08))).r;
+    foamMask *= smoothstep(0.35, 0.80, fn);
 
     // ------------------------------------------------------------
-    // 5) REAL Fresnel (needs vWorldPos + uViewPos)
+    // 5) REAL Fresnel (needs vWorldPos + viewPos)
     // ------------------------------------------------------------
     vec3 N = vec3(0.0, 1.0, 0.0);
-    vec3 V = normalize(uViewPos - vWorldPos);
+    vec3 V = normalize(viewPos - vWorldPos);
 
     float F0 = 0.02; // water base reflectance
     float cosTheta = clamp(dot(N, V), 0.0, 1.0);
@@ -130,5 +146,5 @@ void main()
     alpha = clamp(alpha + foamMask * 0.25, 0.0, 1.0);
     alpha *= smoothstep(0.0, 1.0, vFade);
 
-    FragColor = vec4(rr, alpha);
+    FragColor = vec4(rr * fogOfWar(vWorldPos), alpha);
 }
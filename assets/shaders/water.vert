@@ -8,8 +8,12 @@ out vec3 vWorldPos;
 out float vFade;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec4 uClipPlane;
+};
 uniform float time;
 
 uniform float uVertexWaveAmp;     // ocean 0.10, lake 0.05, river 0.02
@@ -0,0 +1,79 @@
+#include "FrameUniforms.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+void FrameUniforms::BindBlocks(GLuint program)
+{
+    GLuint frameIndex = glGetUniformBlockIndex(program, "FrameBlock");
+    if (frameIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, frameIndex, kFrameBinding);
+
+    GLuint lightIndex = glGetUniformBlockIndex(program, "LightBlock");
+    if (lightIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, lightIndex, kLightBinding);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    Shutdown();
+}
+
+bool FrameUniforms::Init()
+{
+    Shutdown();
+
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max(alignment, 1);
+    lightOffset_ = ((static_cast<GLintptr>(sizeof(FrameBlock)) + alignment - 1) / alignment) * alignment;
+    staging_.assign(static_cast<size_t>(lightOffset_) + sizeof(LightBlock), 0);
+
+    glGenBuffers(1, &buffer_);
+    if (!buffer_)
+    {
+        std::cerr << "FrameUniforms: cannot create uniform buffer" << std::endl;
+        return false;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    glBufferData(GL_UNIFORM_BUFFER, staging_.size(), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Indexed bindings persist; nothing else rebinds these points.
+    glBindBufferRange(GL_UNIFORM_BUFFER, kFrameBinding, buffer_, 0, sizeof(FrameBlock));
+    glBindBufferRange(GL_UNIFORM_BUFFER, kLightBinding, buffer_, lightOffset_, sizeof(LightBlock));
+
+    Update(frame_, light_);
+    return true;
+}
+
+void FrameUniforms::Shutdown()
+{
+    if (buffer_) glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+}
+
+void FrameUniforms::Update(const FrameBlock& frame, const LightBlock& light)
+{
+    frame_ = frame;
+    light_ = light;
+    if (!buffer_)
+        return;
+
+    std::memcpy(staging_.data(), &frame_, sizeof(FrameBlock));
+    std::memcpy(staging_.data() + lightOffset_, &light_, sizeof(LightBlock));
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, staging_.size(), staging_.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::UpdateFrame(const FrameBlock& frame)
+{
+    frame_ = frame;
+    if (!buffer_)
+        return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &frame_);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
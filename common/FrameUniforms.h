@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// ============================================================
+// FrameUniforms
+// Shared std140 uniform blocks, filled once per frame (or pass)
+// instead of per shader. The GLSL side declares, identically in
+// every shader that uses them:
+//
+//   layout(std140) uniform FrameBlock {
+//       mat4 view; mat4 projection; vec3 viewPos; vec4 uClipPlane;
+//   };
+//   layout(std140) uniform LightBlock {
+//       mat4 lightSpaceMatrices[4]; vec4 cascadeSplits;
+//       vec3 lightPos; int cascadeCount; vec3 lightColor;
+//   };
+//
+// GL 4.1 has no layout(binding), so Shader calls BindBlocks() after
+// linking. Both blocks live in one buffer, so a frame update is a
+// single glBufferSubData.
+// ============================================================
+struct FrameBlock {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec4 viewPos{0.0f};                          // xyz
+    glm::vec4 clipPlane{0.0f, 1.0f, 0.0f, 100000.0f}; // default: no clip
+};
+
+struct LightBlock {
+    glm::mat4 lightSpaceMatrices[4];                  // one per shadow cascade
+    glm::vec4 cascadeSplits{0.0f};                    // view-space end of each cascade
+    glm::vec3 lightPos{0.0f};
+    int32_t cascadeCount = 0;                         // packs into lightPos' std140 slot
+    glm::vec4 lightColor{1.0f};                       // rgb
+};
+
+static_assert(sizeof(FrameBlock) == 160, "FrameBlock must match std140 layout");
+static_assert(sizeof(LightBlock) == 304, "LightBlock must match std140 layout");
+
+class FrameUniforms {
+public:
+    static constexpr GLuint kFrameBinding = 0;
+    static constexpr GLuint kLightBinding = 1;
+
+    // Wires FrameBlock/LightBlock of `program` to their binding points.
+    static void BindBlocks(GLuint program);
+
+    FrameUniforms() = default;
+    ~FrameUniforms();
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    bool Init();
+    void Shutdown();
+
+    // Both blocks in one upload; call once per frame.
+    void Update(const FrameBlock& frame, const LightBlock& light);
+    // Frame block only, for passes with their own camera/clip plane.
+    void UpdateFrame(const FrameBlock& frame);
+
+    const FrameBlock& GetFrame() const { return frame_; }
+    const LightBlock& GetLight() const { return light_; }
+
+private:
+    GLuint buffer_ = 0;
+    GLintptr lightOffset_ = 0;   // aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    std::vector<uint8_t> staging_;
+    FrameBlock frame_;
+    LightBlock light_;
+};
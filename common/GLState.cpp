@@ -0,0 +1,187 @@
+#include "GLState.h"
+#include <algorithm>
+
+namespace {
+constexpr GLuint kUnknown = ~0u;
+constexpr int kMaxUnits = 32;
+
+enum TargetSlot { Slot2D, Slot2DArray, SlotBuffer, SlotCount };
+
+struct Cache {
+    GLuint program = kUnknown;
+    GLuint vao = kUnknown;
+    int activeUnit = -1;                    // -1 = unknown
+    GLuint textures[kMaxUnits][SlotCount];
+    int8_t blend = -1;                      // -1 unknown, 0 off, 1 on
+    int8_t cull = -1;
+    int8_t depthTest = -1;
+    int8_t depthMask = -1;
+
+    Cache() { std::fill(&textures[0][0], &textures[0][0] + kMaxUnits * SlotCount, kUnknown); }
+};
+
+Cache gCache;
+GLState::Stats gStats;
+
+int slotFor(GLenum target)
+{
+    switch (target)
+    {
+    case GL_TEXTURE_2D:       return Slot2D;
+    case GL_TEXTURE_2D_ARRAY: return Slot2DArray;
+    case GL_TEXTURE_BUFFER:   return SlotBuffer;
+    default:                  return -1;
+    }
+}
+
+int8_t* capFlag(GLenum cap)
+{
+    switch (cap)
+    {
+    case GL_BLEND:      return &gCache.blend;
+    case GL_CULL_FACE:  return &gCache.cull;
+    case GL_DEPTH_TEST: return &gCache.depthTest;
+    default:            return nullptr;
+    }
+}
+
+// True (and counted as skipped) when `cached` already holds `value`;
+// otherwise stores it and counts the call as issued.
+template <typename T>
+bool unchanged(T& cached, T value)
+{
+    if (cached == value)
+    {
+        ++gStats.skipped;
+        return true;
+    }
+    cached = value;
+    ++gStats.issued;
+    return false;
+}
+}
+
+namespace GLState {
+
+void UseProgram(GLuint program)
+{
+    if (!unchanged(gCache.program, program))
+        glUseProgram(program);
+}
+
+void BindVertexArray(GLuint vao)
+{
+    if (!unchanged(gCache.vao, vao))
+        glBindVertexArray(vao);
+}
+
+void ActiveTexture(GLenum unit)
+{
+    const int index = static_cast<int>(unit) - static_cast<int>(GL_TEXTURE0);
+    if (index < 0 || index >= kMaxUnits)
+    {
+        gCache.activeUnit = -1;
+        ++gStats.issued;
+        glActiveTexture(unit);
+        return;
+    }
+    if (!unchanged(gCache.activeUnit, index))
+        glActiveTexture(unit);
+}
+
+void BindTexture(GLenum target, GLuint texture)
+{
+    const int slot = slotFor(target);
+    if (slot < 0 || gCache.activeUnit < 0)
+    {
+        ++gStats.issued;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (!unchanged(gCache.textures[gCache.activeUnit][slot], texture))
+        glBindTexture(target, texture);
+}
+
+void Enable(GLenum cap)
+{
+    int8_t* flag = capFlag(cap);
+    if (!flag)
+    {
+        ++gStats.issued;
+        glEnable(cap);
+        return;
+    }
+    if (!unchanged(*flag, int8_t(1)))
+        glEnable(cap);
+}
+
+void Disable(GLenum cap)
+{
+    int8_t* flag = capFlag(cap);
+    if (!flag)
+    {
+        ++gStats.issued;
+        glDisable(cap);
+        return;
+    }
+    if (!unchanged(*flag, int8_t(0)))
+        glDisable(cap);
+}
+
+void DepthMask(GLboolean flag)
+{
+    if (!unchanged(gCache.depthMask, static_cast<int8_t>(flag ? 1 : 0)))
+        glDepthMask(flag);
+}
+
+void DeleteTextures(GLsizei n, const GLuint* textures)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (textures[i] == 0)
+            continue;
+        for (auto& unit : gCache.textures)
+            for (GLuint& bound : unit)
+                if (bound == textures[i])
+                    bound = 0;
+    }
+    glDeleteTextures(n, textures);
+}
+
+void DeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (arrays[i] != 0 && gCache.vao == arrays[i])
+            gCache.vao = 0;
+    }
+    glDeleteVertexArrays(n, arrays);
+}
+
+void DeleteProgram(GLuint program)
+{
+    if (program != 0 && gCache.program == program)
+    {
+        gCache.program = 0;
+        ++gStats.issued;
+        glUseProgram(0);
+    }
+    glDeleteProgram(program);
+}
+
+void Invalidate()
+{
+    gCache = Cache();
+}
+
+const Stats& GetStats()
+{
+    return gStats;
+}
+
+void ResetStats()
+{
+    gStats = Stats();
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <GL/glew.h>
+
+// ============================================================
+// GLState
+// Shadow copy of the GL state the renderer changes most: bound
+// program, vertex array, per-unit texture bindings (2D, 2D array,
+// buffer) and the blend / cull / depth-test / depth-write switches.
+// Engine code calls these instead of the matching gl* entry points,
+// so the copy stays exact and a call that would not change anything
+// is skipped. Same arguments and semantics as the GL calls.
+//
+// Anything not tracked (other caps, other texture targets) is passed
+// straight through. Single context, render thread only.
+// ============================================================
+namespace GLState {
+
+struct Stats {
+    uint64_t issued = 0;    // calls forwarded to GL
+    uint64_t skipped = 0;   // redundant calls dropped
+};
+
+void UseProgram(GLuint program);
+void BindVertexArray(GLuint vao);
+void ActiveTexture(GLenum unit);
+void BindTexture(GLenum target, GLuint texture);
+void Enable(GLenum cap);
+void Disable(GLenum cap);
+void DepthMask(GLboolean flag);
+
+// Deleting a bound object resets that binding to 0 in GL and frees
+// the name for reuse, so deletes go through here too.
+void DeleteTextures(GLsizei n, const GLuint* textures);
+void DeleteVertexArrays(GLsizei n, const GLuint* arrays);
+// A current program is only flagged by glDeleteProgram and stays in
+// use; this unbinds it first so it is freed and the cache reads 0.
+void DeleteProgram(GLuint program);
+
+// Forget everything; the next call of each kind is issued. For
+// state changed behind the cache's back (third-party code).
+void Invalidate();
+
+const Stats& GetStats();
+void ResetStats();
+
+}
@@ -1,4 +1,5 @@
 #include "Model.h"
+#include "GLState.h"
 #include <iostream>
 #include <map>
 #include <unordered_map>
@@ -60,11 +61,13 @@ Model::~Model()
 {
     if (VBO) glDeleteBuffers(1, &VBO);
     if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
-    if (VAO) glDeleteVertexArrays(1, &VAO);
+    if (VAO) GLState::DeleteVertexArrays(1, &VAO);
+    if (bakedTexture_) GLState::DeleteTextures(1, &bakedTexture_);
+    if (bakedBuffer_) glDeleteBuffers(1, &bakedBuffer_);
     for (GLuint tex : ownedGLTextures_)
     {
         if (tex != 0)
-            glDeleteTextures(1, &tex);
+            GLState::DeleteTextures(1, &tex);
     }
 }
 
@@ -110,7 +113,7 @@ bool Model::loadWithTinyObj(const char* path)
     boneMapping_.clear();
     bones_.clear();
     animations_.clear();
-    rootNode_ = NodeData();
+    skeleton_.clear();
     globalInverseTransform_ = glm::mat4(1.0f);
 
     std::map<int, std::vector<ModelVertex>> sortedVertices;
@@ -276,12 +279,12 @@ bool Model::loadWithAssimp(const char* path)
     boneMapping_.clear();
     bones_.clear();
     animations_.clear();
-    rootNode_ = NodeData();
+    skeleton_.clear();
 
     processAssimpNode(scene->mRootNode, scene);
     normalizeBoneWeights();
     loadMaterialTextures(scene);
-    readHierarchyData(rootNode_, scene->mRootNode);
+    flattenHierarchy(scene->mRootNode, -1);
     globalInverseTransform_ = glm::inverse(convertMatrix(scene->mRootNode->mTransformation));
     loadAnimations(scene);
     std::cout << "[Model] " << sourcePath_ << " detected " << bones_.size() << " bones.\n";
@@ -292,11 +295,28 @@ bool Model::loadWithAssimp(const char* path)
 void Model::setupMesh() {
     if (vertices.empty()) return;
 
+    boundsMin_ = glm::vec3(std::numeric_limits<float>::max());
+    boundsMax_ = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const ModelVertex& v : vertices)
+    {
+        boundsMin_ = glm::min(boundsMin_, v.Position);
+        boundsMax_ = glm::max(boundsMax_, v.Position);
+    }
+    // Sphere around the box centre; tighter than the box's circumsphere.
+    boundsCenter_ = (boundsMin_ + boundsMax_) * 0.5f;
+    float radiusSq = 0.0f;
+    for (const ModelVertex& v : vertices)
+    {
+        glm::vec3 d = v.Position - boundsCenter_;
+        radiusSq = std::max(radiusSq, glm::dot(d, d));
+    }
+    boundsRadius_ = std::sqrt(radiusSq);
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &instanceVBO);
 
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(ModelVertex), &vertices[0], GL_STATIC_DRAW);
 
@@ -314,49 +334,33 @@ void Model::setupMesh() {
     glEnableVertexAttribArray(8);
     glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, BoneWeights));
 
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
 void Model::Draw(Shader& shader) {
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
 
     // Draw each part with its specific material color
     for (const auto& range : meshRanges) {
-        bool boundTexture = false;
-        if (hasAnyTextures_ &&
-            range.materialIndex >= 0 &&
-            range.materialIndex < static_cast<int>(materialTextureIDs_.size()))
-        {
-            unsigned int tex = materialTextureIDs_[range.materialIndex];
-            if (tex != 0)
-            {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, tex);
-                shader.SetBool("useTexture", true);
-                boundTexture = true;
-            }
-        }
-        if (!boundTexture)
-            shader.SetBool("useTexture", false);
-
-        // Send color to shader
-        if (range.materialIndex >= 0 && range.materialIndex < materialColors.size()) {
-            shader.SetVec3("uMaterialColor", materialColors[range.materialIndex]);
-        } else {
-            shader.SetVec3("uMaterialColor", glm::vec3(1.0f));
-        }
-
+        applyRangeMaterial(shader, range);
         glDrawArrays(GL_TRIANGLES, range.startOffset, range.count);
     }
 
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
+
+void Model::DrawVertexStream() const
+{
+    if (vertices.empty()) return;
+    GLState::BindVertexArray(VAO);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(vertices.size()));
+    GLState::BindVertexArray(0);
+}
+
 void Model::DrawInstanced(Shader& shader, const std::vector<glm::mat4>& models)
 {
     if (models.empty()) return;
 
-    glBindVertexArray(VAO);
-
     // Create or update instance buffer
     if (instanceVBO == 0)
         glGenBuffers(1, &instanceVBO);
@@ -369,8 +373,66 @@ void Model::DrawInstanced(Shader& shader, const std::vector<glm::mat4>& models)
         GL_DYNAMIC_DRAW
     );
 
-    // Ensure instance attributes ALWAYS exist
-    std::size_t vec4Size = sizeof(glm::vec4);
+    const std::vector<InstanceSpan> spans = { { 0, (GLsizei)models.size() } };
+    DrawInstancedSpans(shader, instanceVBO, spans);
+}
+
+void Model::DrawInstancedSpans(Shader& shader, GLuint instanceBuffer, const std::vector<InstanceSpan>& spans,
+                               const InstanceLayout& layout)
+{
+    if (spans.empty() || instanceBuffer == 0) return;
+
+    GLState::BindVertexArray(VAO);
+
+    // Material outer, spans inner: one texture/colour change per range.
+    // GL 4.1 has no base-instance draws, so each span re-points the
+    // instance attributes at its first matrix instead.
+    for (const auto& range : meshRanges)
+    {
+        applyRangeMaterial(shader, range);
+        for (const InstanceSpan& span : spans)
+        {
+            if (span.count <= 0) continue;
+            bindInstanceAttributes(instanceBuffer, span.first, layout);
+            glDrawArraysInstanced(GL_TRIANGLES, range.startOffset, range.count, span.count);
+        }
+    }
+
+    GLState::BindVertexArray(0);
+}
+
+void Model::applyRangeMaterial(Shader& shader, const MeshRange& range)
+{
+    bool boundTexture = false;
+    if (hasAnyTextures_ &&
+        range.materialIndex >= 0 &&
+        range.materialIndex < static_cast<int>(materialTextureIDs_.size()))
+    {
+        unsigned int tex = materialTextureIDs_[range.materialIndex];
+        if (tex != 0)
+        {
+            GLState::ActiveTexture(GL_TEXTURE0);
+            GLState::BindTexture(GL_TEXTURE_2D, tex);
+            shader.SetBool("useTexture", true);
+            boundTexture = true;
+        }
+    }
+    if (!boundTexture)
+        shader.SetBool("useTexture", false);
+
+    // Send color to shader
+    glm::vec3 color = glm::vec3(1.0f);
+    if (range.materialIndex >= 0 && range.materialIndex < static_cast<int>(materialColors.size()))
+        color = materialColors[range.materialIndex];
+    shader.SetVec3("uMaterialColor", color);
+}
+
+// Instance matrix rows live at locations 3..6, the tint at 9 (see simple.vert)
+void Model::bindInstanceAttributes(GLuint buffer, GLint firstInstance, const InstanceLayout& layout)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    const std::size_t vec4Size = sizeof(glm::vec4);
+    const std::size_t base = static_cast<std::size_t>(firstInstance) * layout.stride;
     for (int i = 0; i < 4; ++i)
     {
         glEnableVertexAttribArray(3 + i);
@@ -379,45 +441,32 @@ void Model::DrawInstanced(Shader& shader, const std::vector<glm::mat4>& models)
             4,
             GL_FLOAT,
             GL_FALSE,
-            sizeof(glm::mat4),
-            (void*)(i * vec4Size)
+            layout.stride,
+            (void*)(base + i * vec4Size)
         );
         glVertexAttribDivisor(3 + i, 1);
     }
 
-    // Draw per material range
-    for (const auto& range : meshRanges)
+    if (layout.tintOffset >= 0)
     {
-        bool boundTexture = false;
-        if (hasAnyTextures_ &&
-            range.materialIndex >= 0 &&
-            range.materialIndex < static_cast<int>(materialTextureIDs_.size()))
-        {
-            unsigned int tex = materialTextureIDs_[range.materialIndex];
-            if (tex != 0)
-            {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, tex);
-                shader.SetBool("useTexture", true);
-                boundTexture = true;
-            }
-        }
-        if (!boundTexture)
-            shader.SetBool("useTexture", false);
-
-        glm::vec3 color = glm::vec3(1.0f);
-        if (range.materialIndex >= 0 && range.materialIndex < static_cast<int>(materialColors.size()))
-            color = materialColors[range.materialIndex];
-        shader.SetVec3("uMaterialColor", color);
-        glDrawArraysInstanced(
-            GL_TRIANGLES,
-            range.startOffset,
-            range.count,
-            (GLsizei)models.size()
-        );
+        glEnableVertexAttribArray(9);
+        glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, layout.stride, (void*)(base + layout.tintOffset));
+        glVertexAttribDivisor(9, 1);
+    }
+    else
+    {
+        glDisableVertexAttribArray(9);
+    }
+    if (layout.boneBaseOffset >= 0)
+    {
+        glEnableVertexAttribArray(10);
+        glVertexAttribIPointer(10, 1, GL_INT, layout.stride, (void*)(base + layout.boneBaseOffset));
+        glVertexAttribDivisor(10, 1);
+    }
+    else
+    {
+        glDisableVertexAttribArray(10);
     }
-
-    glBindVertexArray(0);
 }
 
 void Model::loadMaterialTextures(const aiScene* scene)
@@ -579,7 +628,7 @@ unsigned int Model::loadEmbeddedTexture(const aiScene* scene, const std::string&
 
     GLuint texID = 0;
     glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
+    GLState::BindTexture(GL_TEXTURE_2D, texID);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -600,7 +649,7 @@ unsigned int Model::loadEmbeddedTexture(const aiScene* scene, const std::string&
             0);
         if (!data)
         {
-            glDeleteTextures(1, &texID);
+            GLState::DeleteTextures(1, &texID);
             return 0;
         }
         GLenum format = channels == 4 ? GL_RGBA : (channels == 3 ? GL_RGB : GL_RED);
@@ -662,18 +711,20 @@ glm::quat Model::convertQuat(const aiQuaternion& quat) const
     return glm::quat(quat.w, quat.x, quat.y, quat.z);
 }
 
-void Model::readHierarchyData(NodeData& dest, const aiNode* src)
+void Model::flattenHierarchy(const aiNode* src, int parent)
 {
-    dest.name = src->mName.C_Str();
-    dest.transform = convertMatrix(src->mTransformation);
-    dest.children.clear();
-    dest.children.reserve(src->mNumChildren);
+    const int index = static_cast<int>(skeleton_.size());
+    SkeletonNode node;
+    node.name = src->mName.C_Str();
+    node.parent = parent;
+    node.transform = convertMatrix(src->mTransformation);
+    auto boneIt = boneMapping_.find(node.name);
+    if (boneIt != boneMapping_.end())
+        node.bone = boneIt->second;
+    skeleton_.push_back(std::move(node));
+
     for (unsigned int i = 0; i < src->mNumChildren; ++i)
-    {
-        NodeData child;
-        readHierarchyData(child, src->mChildren[i]);
-        dest.children.push_back(std::move(child));
-    }
+        flattenHierarchy(src->mChildren[i], index);
 }
 
 void Model::extractBoneWeights(const aiMesh* mesh, std::vector<ModelVertex>& tempVertices)
@@ -734,6 +785,12 @@ void Model::loadAnimations(const aiScene* scene)
         return;
     }
 
+    // Name resolution happens here, once; clips store node indices.
+    std::unordered_map<std::string, int> nodeIndex;
+    nodeIndex.reserve(skeleton_.size());
+    for (size_t n = 0; n < skeleton_.size(); ++n)
+        nodeIndex.emplace(skeleton_[n].name, static_cast<int>(n));
+
     animations_.reserve(scene->mNumAnimations);
     std::cout << "[Model] " << sourcePath_ << " loading " << scene->mNumAnimations << " animation(s):\n";
     for (unsigned int i = 0; i < scene->mNumAnimations; ++i)
@@ -744,28 +801,43 @@ void Model::loadAnimations(const aiScene* scene)
         clip.duration = anim->mDuration;
         clip.ticksPerSecond = anim->mTicksPerSecond != 0 ? anim->mTicksPerSecond : 25.0;
 
+        clip.nodeChannel.assign(skeleton_.size(), -1);
+        clip.channels.reserve(anim->mNumChannels);
         for (unsigned int c = 0; c < anim->mNumChannels; ++c)
         {
             const aiNodeAnim* channel = anim->mChannels[c];
-            NodeAnimationChannel animChannel;
+            auto nodeIt = nodeIndex.find(channel->mNodeName.C_Str());
+            if (nodeIt == nodeIndex.end())
+                continue;   // animates a node that is not in the hierarchy
 
+            NodeAnimationChannel animChannel;
+            KeyTrack<glm::vec3>& positions = animChannel.positions;
+            positions.times.reserve(channel->mNumPositionKeys);
+            positions.values.reserve(channel->mNumPositionKeys);
             for (unsigned int k = 0; k < channel->mNumPositionKeys; ++k)
             {
-                animChannel.positions.emplace_back(channel->mPositionKeys[k].mTime,
-                                                   convertVector(channel->mPositionKeys[k].mValue));
+                positions.times.push_back(static_cast<float>(channel->mPositionKeys[k].mTime));
+                positions.values.push_back(convertVector(channel->mPositionKeys[k].mValue));
             }
+            KeyTrack<glm::quat>& rotations = animChannel.rotations;
+            rotations.times.reserve(channel->mNumRotationKeys);
+            rotations.values.reserve(channel->mNumRotationKeys);
             for (unsigned int k = 0; k < channel->mNumRotationKeys; ++k)
             {
-                animChannel.rotations.emplace_back(channel->mRotationKeys[k].mTime,
-                                                   convertQuat(channel->mRotationKeys[k].mValue));
+                rotations.times.push_back(static_cast<float>(channel->mRotationKeys[k].mTime));
+                rotations.values.push_back(convertQuat(channel->mRotationKeys[k].mValue));
             }
+            KeyTrack<glm::vec3>& scales = animChannel.scales;
+            scales.times.reserve(channel->mNumScalingKeys);
+            scales.values.reserve(channel->mNumScalingKeys);
             for (unsigned int k = 0; k < channel->mNumScalingKeys; ++k)
             {
-                animChannel.scales.emplace_back(channel->mScalingKeys[k].mTime,
-                                                convertVector(channel->mScalingKeys[k].mValue));
+                scales.times.push_back(static_cast<float>(channel->mScalingKeys[k].mTime));
+                scales.values.push_back(convertVector(channel->mScalingKeys[k].mValue));
             }
 
-            clip.channels[channel->mNodeName.C_Str()] = std::move(animChannel);
+            clip.nodeChannel[nodeIt->second] = static_cast<int>(clip.channels.size());
+            clip.channels.push_back(std::move(animChannel));
         }
 
         animations_.push_back(std::move(clip));
@@ -773,88 +845,62 @@ void Model::loadAnimations(const aiScene* scene)
     }
 }
 
-glm::vec3 Model::interpolateVec3(const std::vector<std::pair<double, glm::vec3>>& keys,
-                                 double timeTicks) const
-{
-    if (keys.empty())
-        return glm::vec3(0.0f);
-    if (keys.size() == 1)
-        return keys[0].second;
+namespace {
 
-    size_t index = 0;
-    for (; index < keys.size() - 1; ++index)
-    {
-        if (timeTicks < keys[index + 1].first)
-            break;
-    }
-    size_t nextIndex = std::min(index + 1, keys.size() - 1);
-    double delta = keys[nextIndex].first - keys[index].first;
-    double factor = 0.0;
-    if (delta > std::numeric_limits<double>::epsilon())
-        factor = (timeTicks - keys[index].first) / delta;
-    return glm::mix(keys[index].second, keys[nextIndex].second, static_cast<float>(factor));
+// Index of the key at or before t (binary search; keys are sorted).
+inline size_t findKey(const std::vector<float>& times, float t)
+{
+    auto it = std::upper_bound(times.begin(), times.end(), t);
+    return it == times.begin() ? 0 : static_cast<size_t>(it - times.begin()) - 1;
 }
 
-glm::quat Model::interpolateQuat(const std::vector<std::pair<double, glm::quat>>& keys,
-                                 double timeTicks) const
+inline float keyFactor(const std::vector<float>& times, size_t index, float t)
 {
-    if (keys.empty())
-        return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-    if (keys.size() == 1)
-        return keys[0].second;
-
-    size_t index = 0;
-    for (; index < keys.size() - 1; ++index)
-    {
-        if (timeTicks < keys[index + 1].first)
-            break;
-    }
-    size_t nextIndex = std::min(index + 1, keys.size() - 1);
-    double delta = keys[nextIndex].first - keys[index].first;
-    double factor = 0.0;
-    if (delta > std::numeric_limits<double>::epsilon())
-        factor = (timeTicks - keys[index].first) / delta;
-    return glm::slerp(keys[index].second, keys[nextIndex].second, static_cast<float>(factor));
+    float delta = times[index + 1] - times[index];
+    return delta > std::numeric_limits<float>::epsilon()
+        ? glm::clamp((t - times[index]) / delta, 0.0f, 1.0f)
+        : 0.0f;
 }
 
-glm::mat4 Model::interpolateChannelTransform(const NodeAnimationChannel& channel,
-                                             double timeTicks) const
+template <typename Track>
+glm::vec3 sampleVec3(const Track& track, float t, const glm::vec3& fallback)
 {
-    glm::vec3 translation = interpolateVec3(channel.positions, timeTicks);
-    glm::quat rotation = interpolateQuat(channel.rotations, timeTicks);
-    glm::vec3 scale = interpolateVec3(channel.scales, timeTicks);
-
-    glm::mat4 t = glm::translate(glm::mat4(1.0f), translation);
-    glm::mat4 r = glm::toMat4(rotation);
-    glm::mat4 s = glm::scale(glm::mat4(1.0f), scale);
-    return t * r * s;
+    const size_t count = track.times.size();
+    if (count == 0)
+        return fallback;
+    size_t index = findKey(track.times, t);
+    if (index + 1 >= count)
+        return track.values[count - 1];
+    return glm::mix(track.values[index], track.values[index + 1], keyFactor(track.times, index, t));
 }
 
-void Model::calculateBoneTransforms(const AnimationClip& clip,
-                                    double timeTicks,
-                                    const NodeData& node,
-                                    const glm::mat4& parent,
-                                    std::vector<glm::mat4>& outMatrices) const
+template <typename Track>
+glm::quat sampleQuat(const Track& track, float t)
 {
-    glm::mat4 nodeTransform = node.transform;
-    auto channelIt = clip.channels.find(node.name);
-    if (channelIt != clip.channels.end())
-    {
-        nodeTransform = interpolateChannelTransform(channelIt->second, timeTicks);
-    }
+    const size_t count = track.times.size();
+    if (count == 0)
+        return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    size_t index = findKey(track.times, t);
+    if (index + 1 >= count)
+        return track.values[count - 1];
+    return glm::slerp(track.values[index], track.values[index + 1], keyFactor(track.times, index, t));
+}
 
-    glm::mat4 globalTransform = parent * nodeTransform;
-    auto boneIt = boneMapping_.find(node.name);
-    if (boneIt != boneMapping_.end() && boneIt->second < static_cast<int>(outMatrices.size()))
-    {
-        int index = boneIt->second;
-        outMatrices[index] = globalInverseTransform_ * globalTransform * bones_[index].offsetMatrix;
-    }
+} // namespace
 
-    for (const auto& child : node.children)
-    {
-        calculateBoneTransforms(clip, timeTicks, child, globalTransform, outMatrices);
-    }
+glm::mat4 Model::interpolateChannelTransform(const NodeAnimationChannel& channel, float timeTicks)
+{
+    glm::vec3 translation = sampleVec3(channel.positions, timeTicks, glm::vec3(0.0f));
+    glm::quat rotation = sampleQuat(channel.rotations, timeTicks);
+    glm::vec3 scale = sampleVec3(channel.scales, timeTicks, glm::vec3(1.0f));
+
+    // T * R * S without the two full matrix products.
+    glm::mat4 m = glm::toMat4(rotation);
+    m[0] *= scale.x;
+    m[1] *= scale.y;
+    m[2] *= scale.z;
+    m[3] = glm::vec4(translation, 1.0f);
+    return m;
 }
 
 void Model::EvaluateAnimation(size_t animationIndex, double timeInSeconds, std::vector<glm::mat4>& outMatrices) const
@@ -867,10 +913,95 @@ void Model::EvaluateAnimation(size_t animationIndex, double timeInSeconds, std::
 
     const AnimationClip& clip = animations_[animationIndex % animations_.size()];
     double ticks = timeInSeconds * clip.ticksPerSecond;
-    double cycle = fmod(ticks, clip.duration);
+    const float cycle = static_cast<float>(clip.duration > 0.0 ? fmod(ticks, clip.duration) : 0.0);
 
     outMatrices.assign(bones_.size(), glm::mat4(1.0f));
-    calculateBoneTransforms(clip, cycle, rootNode_, glm::mat4(1.0f), outMatrices);
+
+    // Per-thread scratch: Model is shared by every unit of its type.
+    static thread_local std::vector<glm::mat4> globals;
+    globals.resize(skeleton_.size());
+
+    for (size_t i = 0; i < skeleton_.size(); ++i)
+    {
+        const SkeletonNode& node = skeleton_[i];
+        const int channel = clip.nodeChannel[i];
+        glm::mat4 local = channel >= 0
+            ? interpolateChannelTransform(clip.channels[channel], cycle)
+            : node.transform;
+        globals[i] = node.parent >= 0 ? globals[node.parent] * local : local;
+
+        if (node.bone >= 0)
+            outMatrices[node.bone] = globalInverseTransform_ * globals[i] * bones_[node.bone].offsetMatrix;
+    }
+}
+
+bool Model::BakeAnimations(float framesPerSecond)
+{
+    if (animations_.empty() || bones_.empty() || framesPerSecond <= 0.0f)
+        return false;
+
+    const size_t boneCount = bones_.size();
+    std::vector<BakedClip> clips;
+    clips.reserve(animations_.size());
+    size_t totalFrames = 0;
+    for (const AnimationClip& clip : animations_)
+    {
+        double seconds = clip.ticksPerSecond > 0.0 ? clip.duration / clip.ticksPerSecond : 0.0;
+        BakedClip baked;
+        baked.firstFrame = static_cast<int>(totalFrames);
+        baked.frameCount = std::max(1, static_cast<int>(std::ceil(seconds * framesPerSecond)));
+        totalFrames += static_cast<size_t>(baked.frameCount);
+        clips.push_back(baked);
+    }
+
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    const size_t texels = totalFrames * boneCount * 4;
+    if (texels > static_cast<size_t>(maxTexels))
+    {
+        std::cout << "[Model] " << sourcePath_ << " baked animation needs " << texels
+                  << " texels (limit " << maxTexels << "); keeping CPU skinning.\n";
+        return false;
+    }
+
+    std::vector<glm::mat4> frames;
+    frames.reserve(totalFrames * boneCount);
+    std::vector<glm::mat4> pose;
+    for (size_t c = 0; c < animations_.size(); ++c)
+    {
+        for (int f = 0; f < clips[c].frameCount; ++f)
+        {
+            EvaluateAnimation(c, static_cast<double>(f) / framesPerSecond, pose);
+            frames.insert(frames.end(), pose.begin(), pose.end());
+        }
+    }
+
+    if (bakedBuffer_ == 0)
+        glGenBuffers(1, &bakedBuffer_);
+    glBindBuffer(GL_TEXTURE_BUFFER, bakedBuffer_);
+    glBufferData(GL_TEXTURE_BUFFER, frames.size() * sizeof(glm::mat4), frames.data(), GL_STATIC_DRAW);
+    if (bakedTexture_ == 0)
+        glGenTextures(1, &bakedTexture_);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, bakedTexture_);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, bakedBuffer_);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    bakedClips_ = std::move(clips);
+    bakedFrameRate_ = framesPerSecond;
+    std::cout << "[Model] " << sourcePath_ << " baked " << totalFrames << " frame(s) at "
+              << framesPerSecond << " fps (" << (frames.size() * sizeof(glm::mat4)) / 1024 << " KiB).\n";
+    return true;
+}
+
+int Model::GetBakedBoneBase(size_t animationIndex, double timeInSeconds) const
+{
+    if (bakedClips_.empty())
+        return -1;
+    const BakedClip& clip = bakedClips_[animationIndex % bakedClips_.size()];
+    double frame = std::floor(std::max(0.0, timeInSeconds) * bakedFrameRate_ + 0.5);
+    int local = static_cast<int>(std::fmod(frame, static_cast<double>(clip.frameCount)));
+    return (clip.firstFrame + local) * static_cast<int>(bones_.size());
 }
 
 int Model::FindAnimationIndex(const std::string& keyword) const
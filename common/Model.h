@@ -35,12 +35,40 @@ struct MeshRange {
     int materialIndex;        // Which color to use
 };
 
+// Contiguous run of instances inside a caller-owned instance buffer.
+struct InstanceSpan {
+    GLint first;
+    GLsizei count;
+};
+
+// One record of an instance buffer: a mat4 at offset 0 (locations
+// 3..6), optionally followed by a vec4 tint (location 9) and an
+// int bone palette base (location 10).
+struct InstanceLayout {
+    GLsizei stride = sizeof(glm::mat4);
+    GLint tintOffset = -1;
+    GLint boneBaseOffset = -1;
+};
+
 class Model {
 public:
     Model(const char* path);
     ~Model();
     void Draw(Shader& shader);
     void DrawInstanced(Shader& shader, const std::vector<glm::mat4>& models);
+    // Draws spans of a persistent instance buffer (mat4 per instance)
+    // without re-uploading it.
+    void DrawInstancedSpans(Shader& shader, GLuint instanceBuffer, const std::vector<InstanceSpan>& spans,
+                            const InstanceLayout& layout = InstanceLayout());
+    // Object-space bounds of all vertices
+    const glm::vec3& GetBoundsMin() const { return boundsMin_; }
+    const glm::vec3& GetBoundsMax() const { return boundsMax_; }
+    const glm::vec3& GetBoundsCenter() const { return boundsCenter_; }
+    float GetBoundsRadius() const { return boundsRadius_; }
+    size_t GetVertexCount() const { return vertices.size(); }
+    // Every vertex once, in VBO order, as GL_POINTS: the input of a
+    // transform feedback pass (SkinningPrepass).
+    void DrawVertexStream() const;
     bool HasTextures() const { return hasAnyTextures_; }
     void SetOverrideTexture(const std::string& path);
     bool HasAnimations() const { return !animations_.empty(); }
@@ -49,6 +77,17 @@ public:
     void EvaluateAnimation(size_t animationIndex, double timeInSeconds, std::vector<glm::mat4>& outMatrices) const;
     int FindAnimationIndex(const std::string& keyword) const;
 
+    // Optional baked mode: every clip pre-sampled at `framesPerSecond`
+    // into one RGBA32F texture buffer (4 texels per bone matrix), laid
+    // out like the shared bone palette. Returns false if the model has
+    // no animations or the result exceeds GL_MAX_TEXTURE_BUFFER_SIZE.
+    bool BakeAnimations(float framesPerSecond);
+    bool HasBakedAnimations() const { return bakedTexture_ != 0; }
+    GLuint GetBakedAnimationTexture() const { return bakedTexture_; }
+    // First matrix of the baked frame nearest to `timeInSeconds`; pass
+    // as the bone base (uBoneBase / iBoneBase) with the baked texture.
+    int GetBakedBoneBase(size_t animationIndex, double timeInSeconds) const;
+
 private:
     unsigned int VAO, VBO, instanceVBO;
     std::vector<ModelVertex> vertices;
@@ -62,41 +101,71 @@ private:
     bool hasAnyTextures_ = false;
     std::string baseDirectory_;
     std::string sourcePath_;
+    glm::vec3 boundsMin_{0.0f};
+    glm::vec3 boundsMax_{0.0f};
+    glm::vec3 boundsCenter_{0.0f};
+    float boundsRadius_ = 0.0f;
 
     struct BoneInfo
     {
         glm::mat4 offsetMatrix{1.0f};
     };
 
+    // Keys in SoA form: times are searched, values only read at the hit.
+    template <typename T>
+    struct KeyTrack
+    {
+        std::vector<float> times;
+        std::vector<T> values;
+    };
+
     struct NodeAnimationChannel
     {
-        std::vector<std::pair<double, glm::vec3>> positions;
-        std::vector<std::pair<double, glm::quat>> rotations;
-        std::vector<std::pair<double, glm::vec3>> scales;
+        KeyTrack<glm::vec3> positions;
+        KeyTrack<glm::quat> rotations;
+        KeyTrack<glm::vec3> scales;
     };
 
+    // Compiled at load: channels are addressed by skeleton node index,
+    // so evaluation never touches a name.
     struct AnimationClip
     {
         std::string name;
         double duration = 0.0;
         double ticksPerSecond = 25.0;
-        std::unordered_map<std::string, NodeAnimationChannel> channels;
+        std::vector<int> nodeChannel;                 // per skeleton node, -1 = bind pose
+        std::vector<NodeAnimationChannel> channels;
     };
 
-    struct NodeData
+    // Node hierarchy flattened in pre-order: a parent always precedes
+    // its children, so one forward pass computes every global transform.
+    struct SkeletonNode
     {
         std::string name;
+        int parent = -1;
+        int bone = -1;                                // index into bones_, -1 = helper node
         glm::mat4 transform{1.0f};
-        std::vector<NodeData> children;
     };
 
-    std::unordered_map<std::string, int> boneMapping_;
+    std::unordered_map<std::string, int> boneMapping_;   // load time only
     std::vector<BoneInfo> bones_;
     std::vector<AnimationClip> animations_;
-    NodeData rootNode_;
+    std::vector<SkeletonNode> skeleton_;
     glm::mat4 globalInverseTransform_{1.0f};
 
+    struct BakedClip
+    {
+        int firstFrame = 0;
+        int frameCount = 1;
+    };
+    std::vector<BakedClip> bakedClips_;
+    float bakedFrameRate_ = 0.0f;
+    GLuint bakedBuffer_ = 0;
+    GLuint bakedTexture_ = 0;
+
     void setupMesh();
+    void applyRangeMaterial(Shader& shader, const MeshRange& range);
+    void bindInstanceAttributes(GLuint buffer, GLint firstInstance, const InstanceLayout& layout);
     bool loadWithTinyObj(const char* path);
     bool loadWithAssimp(const char* path);
     void processAssimpNode(const aiNode* node, const aiScene* scene);
@@ -104,23 +173,13 @@ private:
     void loadMaterialTextures(const aiScene* scene);
     unsigned int loadTextureForMaterial(const std::string& relPath);
     unsigned int loadEmbeddedTexture(const aiScene* scene, const std::string& token);
-    void readHierarchyData(NodeData& dest, const aiNode* src);
+    void flattenHierarchy(const aiNode* src, int parent);
     void loadAnimations(const aiScene* scene);
     void extractBoneWeights(const aiMesh* mesh, std::vector<ModelVertex>& tempVertices);
     void normalizeBoneWeights();
-    void calculateBoneTransforms(const AnimationClip& clip,
-                                 double timeTicks,
-                                 const NodeData& node,
-                                 const glm::mat4& parent,
-                                 std::vector<glm::mat4>& outMatrices) const;
     glm::mat4 convertMatrix(const aiMatrix4x4& mat) const;
     glm::vec3 convertVector(const aiVector3D& vec) const;
     glm::quat convertQuat(const aiQuaternion& quat) const;
-    glm::mat4 interpolateChannelTransform(const NodeAnimationChannel& channel,
-                                          double timeTicks) const;
-    glm::vec3 interpolateVec3(const std::vector<std::pair<double, glm::vec3>>& keys,
-                              double timeTicks) const;
-    glm::quat interpolateQuat(const std::vector<std::pair<double, glm::quat>>& keys,
-                              double timeTicks) const;
+    static glm::mat4 interpolateChannelTransform(const NodeAnimationChannel& channel, float timeTicks);
     std::string toLower(const std::string& value) const;
 };
@@ -0,0 +1,176 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ============================================================
+// ParallelFor
+// Splits [0, count) into tiles of `grain` items and hands them
+// out to worker threads. fn(begin, end) must only write to its
+// own range. Blocks until every tile is done.
+//
+// ForTiles() starts and joins its threads on every call, which is
+// fine for one-time generation. Work that runs every frame or tick
+// goes through a Pool, whose workers stay alive between calls.
+// ============================================================
+namespace Parallel {
+
+inline unsigned WorkerCount()
+{
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 4u : hw;
+}
+
+template <typename Fn>
+void ForTiles(int count, int grain, Fn&& fn)
+{
+    if (count <= 0)
+        return;
+    grain = std::max(1, grain);
+
+    const int tiles = (count + grain - 1) / grain;
+    const int workers = std::min<int>(static_cast<int>(WorkerCount()), tiles);
+    if (workers <= 1)
+    {
+        fn(0, count);
+        return;
+    }
+
+    std::atomic<int> next{0};
+    auto worker = [&]()
+    {
+        for (int tile = next.fetch_add(1); tile < tiles; tile = next.fetch_add(1))
+        {
+            int begin = tile * grain;
+            int end = std::min(count, begin + grain);
+            fn(begin, end);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (int i = 1; i < workers; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+}
+
+// Persistent workers for per-frame ForTiles calls. `threads` counts
+// the calling thread, which runs tiles too. One caller at a time.
+class Pool {
+public:
+    explicit Pool(unsigned threads)
+    {
+        const unsigned helpers = std::max(1u, threads) - 1;
+        workers_.reserve(helpers);
+        for (unsigned i = 0; i < helpers; ++i)
+            workers_.emplace_back(&Pool::workerLoop, this);
+    }
+
+    ~Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& t : workers_)
+            t.join();
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template <typename Fn>
+    void ForTiles(int count, int grain, Fn&& fn)
+    {
+        if (count <= 0)
+            return;
+        grain = std::max(1, grain);
+
+        const int tiles = (count + grain - 1) / grain;
+        if (workers_.empty() || tiles <= 1)
+        {
+            fn(0, count);
+            return;
+        }
+
+        using Callable = typename std::remove_reference<Fn>::type;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            context_ = const_cast<void*>(static_cast<const void*>(&fn));
+            invoke_ = [](void* context, int begin, int end)
+            {
+                (*static_cast<Callable*>(context))(begin, end);
+            };
+            count_ = count;
+            grain_ = grain;
+            tiles_ = tiles;
+            next_.store(0);
+            busy_ = static_cast<int>(workers_.size());
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        runTiles();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return busy_ == 0; });
+    }
+
+private:
+    void runTiles()
+    {
+        for (int tile = next_.fetch_add(1); tile < tiles_; tile = next_.fetch_add(1))
+        {
+            int begin = tile * grain_;
+            int end = std::min(count_, begin + grain_);
+            invoke_(context_, begin, end);
+        }
+    }
+
+    void workerLoop()
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+            }
+
+            runTiles();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    // The current call; written under mutex_ before generation_ moves
+    void* context_ = nullptr;
+    void (*invoke_)(void*, int, int) = nullptr;
+    int count_ = 0;
+    int grain_ = 1;
+    int tiles_ = 0;
+    std::atomic<int> next_{0};
+    int busy_ = 0;              // workers still in the current call
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace Parallel
@@ -1,4 +1,6 @@
 #include "Shader.h"
+#include "FrameUniforms.h"
+#include "GLState.h"
 
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -7,6 +9,7 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // ------------------------------------------------------------
 // Load file into string
@@ -63,18 +66,157 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 
+    finishLink();
+}
+
+// ------------------------------------------------------------
+// Constructor: vertex-only transform feedback program
+// ------------------------------------------------------------
+Shader::Shader(const std::string& vertexPath, const std::vector<std::string>& feedbackVaryings)
+{
+    std::string vertexCode = LoadFileAsString(vertexPath);
+    const char* vShaderCode = vertexCode.c_str();
+
+    unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vShaderCode, nullptr);
+    glCompileShader(vertex);
+    CheckCompileErrors(vertex, "VERTEX");
+
+    ID = glCreateProgram();
+    glAttachShader(ID, vertex);
+
+    // Varyings must be declared before the link that captures them.
+    std::vector<const char*> names;
+    names.reserve(feedbackVaryings.size());
+    for (const std::string& name : feedbackVaryings)
+        names.push_back(name.c_str());
+    glTransformFeedbackVaryings(ID, static_cast<GLsizei>(names.size()), names.data(), GL_INTERLEAVED_ATTRIBS);
+
+    glLinkProgram(ID);
+    CheckCompileErrors(ID, "PROGRAM");
+    glDeleteShader(vertex);
+
+    finishLink();
+}
+
+void Shader::finishLink()
+{
+    reflectUniforms();
+    FrameUniforms::BindBlocks(ID);
+
     // Initialize bone sampler defaults if present
     Use();
-    GLint boneSamplerLoc = glGetUniformLocation(ID, "uBoneTexture");
-    if (boneSamplerLoc != -1)
+    SetInt("uBoneTexture", 13);
+    SetInt("uBoneCount", 0);
+    SetInt("uSkinnedVertices", 14);
+}
+
+// ------------------------------------------------------------
+// Reflection: flat table of active uniforms
+// ------------------------------------------------------------
+void Shader::reflectUniforms()
+{
+    uniforms_.clear();
+    uniformIndex_.clear();
+
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    if (count <= 0 || maxLength <= 0)
+        return;
+
+    std::vector<char> buffer(static_cast<size_t>(maxLength));
+    uniforms_.reserve(static_cast<size_t>(count));
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), static_cast<size_t>(length));
+
+        // Block members have no location; they are fed through UBOs.
+        GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0)
+            continue;
+
+        UniformSlot slot;
+        slot.location = location;
+        slot.type = type;
+        const int index = static_cast<int>(uniforms_.size());
+        uniforms_.push_back(slot);
+        uniformIndex_[name] = index;
+
+        // Arrays reflect as "name[0]"; also answer to the bare name.
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            uniformIndex_[name.substr(0, name.size() - 3)] = index;
+    }
+}
+
+int Shader::findSlot(const std::string& name) const
+{
+    auto it = uniformIndex_.find(name);
+    if (it != uniformIndex_.end())
+        return it->second;
+
+    // Not reflected (e.g. "bones[3]" or an inactive uniform): ask GL
+    // once and remember the answer, including misses.
+    UniformSlot slot;
+    slot.location = glGetUniformLocation(ID, name.c_str());
+    const int index = static_cast<int>(uniforms_.size());
+    uniforms_.push_back(slot);
+    uniformIndex_[name] = index;
+    return index;
+}
+
+int Shader::resolve(const std::string& name, UniformKind kind) const
+{
+    const int index = findSlot(name);
+    const UniformSlot& slot = uniforms_[index];
+    if (slot.location < 0)
+        return -1;
+    if (slot.type == 0)
+        return index; // unreflected element: type unknown, trust the caller
+
+    bool ok = false;
+    switch (kind)
     {
-        glUniform1i(boneSamplerLoc, 13);
+    case UniformKind::Bool:
+    case UniformKind::Int:
+        ok = slot.type == GL_BOOL || slot.type == GL_INT || slot.type == GL_UNSIGNED_INT ||
+             slot.type == GL_SAMPLER_2D || slot.type == GL_SAMPLER_3D ||
+             slot.type == GL_SAMPLER_CUBE || slot.type == GL_SAMPLER_BUFFER ||
+             slot.type == GL_SAMPLER_2D_SHADOW || slot.type == GL_SAMPLER_2D_ARRAY ||
+             slot.type == GL_SAMPLER_2D_ARRAY_SHADOW || slot.type == GL_INT_SAMPLER_BUFFER ||
+             slot.type == GL_UNSIGNED_INT_SAMPLER_BUFFER;
+        break;
+    case UniformKind::Float: ok = slot.type == GL_FLOAT; break;
+    case UniformKind::Vec2:  ok = slot.type == GL_FLOAT_VEC2; break;
+    case UniformKind::Vec3:  ok = slot.type == GL_FLOAT_VEC3; break;
+    case UniformKind::Vec4:  ok = slot.type == GL_FLOAT_VEC4; break;
+    case UniformKind::Mat4:  ok = slot.type == GL_FLOAT_MAT4; break;
     }
-    GLint boneCountLoc = glGetUniformLocation(ID, "uBoneCount");
-    if (boneCountLoc != -1)
+    if (!ok)
     {
-        glUniform1i(boneCountLoc, 0);
+        std::cerr << "Shader " << ID << ": uniform '" << name << "' has a different type" << std::endl;
+        return -1;
     }
+    return index;
+}
+
+bool Shader::update(int slot, const void* data, size_t bytes) const
+{
+    if (slot < 0)
+        return false;
+    UniformSlot& u = uniforms_[slot];
+    if (u.location < 0)
+        return false;
+    if (u.known && std::memcmp(u.value, data, bytes) == 0)
+        return false;
+    std::memcpy(u.value, data, bytes);
+    u.known = true;
+    return true;
 }
 
 // ------------------------------------------------------------
@@ -82,7 +224,7 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
 // ------------------------------------------------------------
 void Shader::Use() const
 {
-    glUseProgram(ID);
+    GLState::UseProgram(ID);
 }
 
 // ------------------------------------------------------------
@@ -90,47 +232,98 @@ void Shader::Use() const
 // ------------------------------------------------------------
 void Shader::SetBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    Set(UniformHandle<bool>{ findSlot(name) }, value);
 }
 
 void Shader::SetInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    Set(UniformHandle<int>{ findSlot(name) }, value);
 }
 
 void Shader::SetFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    Set(UniformHandle<float>{ findSlot(name) }, value);
 }
 
 void Shader::SetVec2(const std::string& name, const glm::vec2& value) const
 {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    Set(UniformHandle<glm::vec2>{ findSlot(name) }, value);
 }
 
 void Shader::SetVec3(const std::string& name, const glm::vec3& value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    Set(UniformHandle<glm::vec3>{ findSlot(name) }, value);
 }
 
 void Shader::SetVec4(const std::string &name, const glm::vec4 &value) const
 { 
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+    Set(UniformHandle<glm::vec4>{ findSlot(name) }, value);
 }
 
 void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    Set(UniformHandle<glm::mat4>{ findSlot(name) }, mat);
+}
+
+// glProgramUniform* (GL 4.1) targets this program even when another
+// one is bound, so the shadow values can never go stale.
+// Bools go up as ints, so `true` and `1` share one shadow value.
+void Shader::Set(UniformHandle<bool> h, bool value) const
+{
+    Set(UniformHandle<int>{ h.slot }, value ? 1 : 0);
+}
+
+void Shader::Set(UniformHandle<int> h, int value) const
+{
+    if (update(h.slot, &value, sizeof(value)))
+        glProgramUniform1i(ID, uniforms_[h.slot].location, value);
+}
+
+void Shader::Set(UniformHandle<float> h, float value) const
+{
+    if (update(h.slot, &value, sizeof(value)))
+        glProgramUniform1f(ID, uniforms_[h.slot].location, value);
+}
+
+void Shader::Set(UniformHandle<glm::vec2> h, const glm::vec2& value) const
+{
+    if (update(h.slot, glm::value_ptr(value), sizeof(value)))
+        glProgramUniform2fv(ID, uniforms_[h.slot].location, 1, glm::value_ptr(value));
+}
+
+void Shader::Set(UniformHandle<glm::vec3> h, const glm::vec3& value) const
+{
+    if (update(h.slot, glm::value_ptr(value), sizeof(value)))
+        glProgramUniform3fv(ID, uniforms_[h.slot].location, 1, glm::value_ptr(value));
+}
+
+void Shader::Set(UniformHandle<glm::vec4> h, const glm::vec4& value) const
+{
+    if (update(h.slot, glm::value_ptr(value), sizeof(value)))
+        glProgramUniform4fv(ID, uniforms_[h.slot].location, 1, glm::value_ptr(value));
+}
+
+void Shader::Set(UniformHandle<glm::mat4> h, const glm::mat4& value) const
+{
+    if (update(h.slot, glm::value_ptr(value), sizeof(value)))
+        glProgramUniformMatrix4fv(ID, uniforms_[h.slot].location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
 void Shader::BindBoneTexture(unsigned int textureID, int boneCount, int unit) const
 {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_BUFFER, textureID);
+    GLState::ActiveTexture(GL_TEXTURE0 + unit);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, textureID);
     SetInt("uBoneTexture", unit);
     SetInt("uBoneCount", boneCount);
 }
 
+void Shader::BindSkinnedVertexTexture(unsigned int textureID, int unit) const
+{
+    GLState::ActiveTexture(GL_TEXTURE0 + unit);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, textureID);
+    SetInt("uSkinnedVertices", unit);
+}
+
 // ------------------------------------------------------------
 // Error checking
 // ------------------------------------------------------------
@@ -1,19 +1,34 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
+// Typed uniform handle, resolved once with Shader::GetUniform<T>().
+// An invalid handle (missing or mistyped uniform) makes Set() a no-op,
+// like setting location -1.
+template <typename T>
+struct UniformHandle {
+    int slot = -1;
+    bool IsValid() const { return slot >= 0; }
+};
+
 class Shader {
 public:
     unsigned int ID;
 
     // Constructor: loads & builds shader
     Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    // Vertex-only program whose `feedbackVaryings` are captured
+    // interleaved by transform feedback (no rasterisation).
+    Shader(const std::string& vertexPath, const std::vector<std::string>& feedbackVaryings);
 
     // Activate shader program
     void Use() const;
 
     // --- Uniform setters ---
+    // By name: a hash lookup into the reflected table, no GL query.
     void SetBool (const std::string& name, bool value) const;
     void SetInt  (const std::string& name, int value) const;
     void SetFloat(const std::string& name, float value) const;
@@ -24,8 +39,55 @@ public:
 
     void SetMat4 (const std::string& name, const glm::mat4& mat) const;
     void BindBoneTexture(unsigned int textureID, int boneCount, int unit = 13) const;
+    // Pre-skinned vertex stream (SkinningPrepass), read when uPreskinned.
+    void BindSkinnedVertexTexture(unsigned int textureID, int unit = 14) const;
+
+    // --- Typed handles ---
+    template <typename T>
+    UniformHandle<T> GetUniform(const std::string& name) const
+    {
+        return UniformHandle<T>{ resolve(name, kindOf(static_cast<T*>(nullptr))) };
+    }
+
+    void Set(UniformHandle<bool> h, bool value) const;
+    void Set(UniformHandle<int> h, int value) const;
+    void Set(UniformHandle<float> h, float value) const;
+    void Set(UniformHandle<glm::vec2> h, const glm::vec2& value) const;
+    void Set(UniformHandle<glm::vec3> h, const glm::vec3& value) const;
+    void Set(UniformHandle<glm::vec4> h, const glm::vec4& value) const;
+    void Set(UniformHandle<glm::mat4> h, const glm::mat4& value) const;
 
 private:
+    enum class UniformKind { Bool, Int, Float, Vec2, Vec3, Vec4, Mat4 };
+
+    // One entry per active uniform, filled by reflection after link.
+    // `value` shadows what was last sent so repeated sets are skipped;
+    // it is only valid because every upload goes through this class.
+    struct UniformSlot {
+        int location = -1;
+        unsigned int type = 0;
+        bool known = false;
+        float value[16] = {};
+    };
+
+    mutable std::vector<UniformSlot> uniforms_;
+    mutable std::unordered_map<std::string, int> uniformIndex_;
+
+    static UniformKind kindOf(bool*)      { return UniformKind::Bool; }
+    static UniformKind kindOf(int*)       { return UniformKind::Int; }
+    static UniformKind kindOf(float*)     { return UniformKind::Float; }
+    static UniformKind kindOf(glm::vec2*) { return UniformKind::Vec2; }
+    static UniformKind kindOf(glm::vec3*) { return UniformKind::Vec3; }
+    static UniformKind kindOf(glm::vec4*) { return UniformKind::Vec4; }
+    static UniformKind kindOf(glm::mat4*) { return UniformKind::Mat4; }
+
+    void reflectUniforms();
+    void finishLink();
+    int findSlot(const std::string& name) const;
+    int resolve(const std::string& name, UniformKind kind) const;
+    // True (and shadow updated) when `bytes` differ from the shadow.
+    bool update(int slot, const void* data, size_t bytes) const;
+
     // Utility: read shader file to string
     std::string LoadFileAsString(const std::string& path);
 
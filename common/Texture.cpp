@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "GLState.h"
 #include <iostream>
 
 // This defines the library implementation logic
@@ -34,7 +35,7 @@ Texture::Texture(const char* path) {
     else if (nrChannels == 4)
         format = GL_RGBA;
 
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLState::BindTexture(GL_TEXTURE_2D, ID);
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -48,6 +49,6 @@ Texture::Texture(const char* path) {
 }
 
 void Texture::Bind(unsigned int slot) {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLState::ActiveTexture(GL_TEXTURE0 + slot);
+    GLState::BindTexture(GL_TEXTURE_2D, ID);
 }
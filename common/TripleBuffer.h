@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// ============================================================
+// TripleBuffer
+// Lock-free hand-off of whole values from one writer thread to one
+// reader thread. The writer fills Back() and Publish()es it; the
+// reader's Acquire() swaps in the newest published slot. Neither
+// side ever waits: the reader always sees a complete value, and a
+// value the reader never picked up is simply replaced by the next.
+//
+// Each side keeps its slot until its next Publish()/Acquire(), so
+// the three values are reused and their containers keep capacity.
+// Back() still holds whatever that slot held last; overwrite it.
+// ============================================================
+template <typename T>
+class TripleBuffer {
+public:
+    // --- Writer thread ---
+    T& Back() { return slots_[back_]; }
+
+    void Publish()
+    {
+        const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh),
+                                                  std::memory_order_acq_rel);
+        back_ = static_cast<uint8_t>(previous & kIndexMask);
+    }
+
+    // --- Reader thread ---
+    // True when a newer value was swapped in; Front() is unchanged
+    // otherwise.
+    bool Acquire()
+    {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0)
+            return false;
+        const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = static_cast<uint8_t>(previous & kIndexMask);
+        return true;
+    }
+
+    const T& Front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh     = 0x4;   // middle_ not read yet
+
+    std::array<T, 3> slots_;
+    uint8_t back_ = 0;
+    std::atomic<uint8_t> middle_{1};
+    uint8_t front_ = 2;
+};
@@ -0,0 +1,47 @@
+#include "AnimationBudget.h"
+#include "SceneConstants.h"
+#include <algorithm>
+#include <iterator>
+
+void AnimationBudget::BeginFrame(const View& view)
+{
+    view_ = view;
+    frustum_ = Frustum::FromMatrix(view.viewProj);
+    ++frame_;
+    std::fill(std::begin(counts_), std::end(counts_), 0);
+    evaluations_ = 0;
+}
+
+AnimationBudget::Rate AnimationBudget::ChooseRate(const glm::vec3& center, float radius,
+                                                  bool visibleToPlayer) const
+{
+    if (!visibleToPlayer)
+        return Rate::Frozen;
+
+    const glm::vec3 extent(radius);
+    // Off-screen units still cast shadows into view; keep them slow, not frozen.
+    if (!frustum_.IntersectsAABB(center - extent, center + extent))
+        return Rate::Quarter;
+
+    const float distance = std::max(glm::length(center - view_.eye), 1.0f);
+    const float pixels = (2.0f * radius / distance) * view_.pixelsPerUnit;
+    if (pixels >= SceneConst::kAnimFullRatePixels)
+        return Rate::EveryFrame;
+    if (pixels >= SceneConst::kAnimHalfRatePixels)
+        return Rate::Half;
+    return Rate::Quarter;
+}
+
+bool AnimationBudget::Schedule(Rate rate)
+{
+    static const unsigned kInterval[] = { 1, 2, 4, 0 };
+    size_t& slot = counts_[static_cast<int>(rate)];
+    const unsigned interval = kInterval[static_cast<int>(rate)];
+    const size_t k = slot++;
+    if (interval == 0)
+        return false;
+    const bool due = (k + frame_) % interval == 0;
+    if (due)
+        ++evaluations_;
+    return due;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "../rendering/Frustum.h"
+
+// ============================================================
+// AnimationBudget
+// Chooses how often each CPU-skinned unit re-evaluates its pose:
+// every frame, every 2nd, every 4th, or frozen. The rate follows
+// the unit's projected height on screen and whether the active
+// player can see it at all. Units in a rate tier are staggered
+// round-robin, so a tier of N units at 1/k costs about N/k pose
+// evaluations every frame instead of N every k-th frame.
+// ============================================================
+class AnimationBudget {
+public:
+    enum class Rate { EveryFrame = 0, Half, Quarter, Frozen, Count };
+
+    struct View {
+        glm::mat4 viewProj{1.0f};
+        glm::vec3 eye{0.0f};
+        float pixelsPerUnit = 1.0f;   // screen height / (2 tan(fovY / 2))
+    };
+
+    void BeginFrame(const View& view);
+
+    // Rate for a unit whose bounding sphere is (center, radius).
+    Rate ChooseRate(const glm::vec3& center, float radius, bool visibleToPlayer) const;
+
+    // True when a unit in `rate` should evaluate this frame. Call once
+    // per unit per frame, in a stable order.
+    bool Schedule(Rate rate);
+
+    size_t GetCount(Rate rate) const { return counts_[static_cast<int>(rate)]; }
+    size_t GetEvaluations() const { return evaluations_; }
+
+private:
+    View view_;
+    Frustum frustum_{};
+    unsigned frame_ = 0;
+    size_t counts_[static_cast<int>(Rate::Count)] = {};
+    size_t evaluations_ = 0;
+};
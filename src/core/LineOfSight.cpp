@@ -0,0 +1,124 @@
+#include "LineOfSight.h"
+#include <cmath>
+#include <cstdint>
+
+namespace {
+// Octant transforms (xx, xy, yx, yy) mapping octant-local (dx, dy)
+// onto grid offsets.
+constexpr int kOctants[8][4] = {
+    {  1,  0,  0,  1 }, {  0,  1,  1,  0 }, {  0, -1,  1,  0 }, { -1,  0,  0,  1 },
+    { -1,  0,  0, -1 }, {  0, -1, -1,  0 }, {  0,  1, -1,  0 }, {  1,  0,  0, -1 },
+};
+
+struct CastState {
+    const float* heights;
+    int cols, rows;
+    int originCol, originRow;
+    int extent;                // ceil(radius)
+    float radiusSq;
+    float blockAbove;          // absolute height that blocks; +inf = never
+    std::vector<uint8_t>* seen; // (2 * extent + 1)^2, dedupes octant borders
+    LineOfSight::Mask* out;
+};
+
+void reveal(const CastState& s, int dc, int dr)
+{
+    const int side = 2 * s.extent + 1;
+    uint8_t& flag = (*s.seen)[static_cast<size_t>((dr + s.extent) * side + (dc + s.extent))];
+    if (flag)
+        return;
+    flag = 1;
+    s.out->emplace_back(dc, dr);
+}
+
+void castLight(const CastState& s, int row, float start, float end, const int* t)
+{
+    if (start < end)
+        return;
+
+    float newStart = 0.0f;
+    for (int j = row; j <= s.extent; ++j)
+    {
+        bool blocked = false;
+        for (int dx = -j; dx <= 0; ++dx)
+        {
+            const int dy = -j;
+            const float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+            const float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rightSlope)
+                continue;
+            if (end > leftSlope)
+                break;
+
+            const int dc = dx * t[0] + dy * t[1];
+            const int dr = dx * t[2] + dy * t[3];
+            const int col = s.originCol + dc;
+            const int cellRow = s.originRow + dr;
+            const bool inside = col >= 0 && cellRow >= 0 && col < s.cols && cellRow < s.rows;
+
+            if (inside && static_cast<float>(dc * dc + dr * dr) <= s.radiusSq)
+                reveal(s, dc, dr);
+
+            const bool opaque = !inside ||
+                s.heights[static_cast<size_t>(cellRow) * static_cast<size_t>(s.cols) + static_cast<size_t>(col)] > s.blockAbove;
+            if (blocked)
+            {
+                if (opaque)
+                {
+                    newStart = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                start = newStart;
+            }
+            else if (opaque && j < s.extent)
+            {
+                blocked = true;
+                castLight(s, j + 1, start, leftSlope, t);
+                newStart = rightSlope;
+            }
+        }
+        if (blocked)
+            break;
+    }
+}
+}
+
+void LineOfSight::SetHeightfield(int cols, int rows, std::vector<float> heights)
+{
+    cols_ = cols;
+    rows_ = rows;
+    heights_ = std::move(heights);
+    if (heights_.size() != static_cast<size_t>(cols_) * static_cast<size_t>(rows_))
+        heights_.assign(static_cast<size_t>(cols_) * static_cast<size_t>(rows_), 0.0f);
+}
+
+void LineOfSight::Compute(int col, int row, float radius, float blockHeight, Mask& out) const
+{
+    out.clear();
+    if (col < 0 || row < 0 || col >= cols_ || row >= rows_ || radius <= 0.0f)
+        return;
+
+    thread_local std::vector<uint8_t> seen;
+    const int extent = static_cast<int>(std::ceil(radius));
+    const size_t side = static_cast<size_t>(2 * extent + 1);
+    seen.assign(side * side, 0);
+
+    CastState s;
+    s.heights = heights_.data();
+    s.cols = cols_;
+    s.rows = rows_;
+    s.originCol = col;
+    s.originRow = row;
+    s.extent = extent;
+    s.radiusSq = radius * radius;
+    s.blockAbove = blockHeight > 0.0f
+        ? heights_[static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col)] + blockHeight
+        : INFINITY;
+    s.seen = &seen;
+    s.out = &out;
+
+    reveal(s, 0, 0);
+    for (const int* t : kOctants)
+        castLight(s, 1, 1.0f, 0.0f, t);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ============================================================
+// LineOfSight
+// Height-aware vision over the nav grid. Compute() runs recursive
+// shadowcasting (eight octants) from a viewer cell: a cell whose
+// terrain rises more than `blockHeight` above the viewer's cell is
+// seen but hides everything behind it, so units on the plains do
+// not see over a ridge while units on high ground see down.
+//
+// The heightfield is read-only after SetHeightfield(), so Compute()
+// may run on several threads at once.
+// ============================================================
+class LineOfSight {
+public:
+    // Visible cells as offsets from the viewer cell.
+    using Mask = std::vector<glm::ivec2>;
+
+    // One height per cell, row-major, cols * rows entries.
+    void SetHeightfield(int cols, int rows, std::vector<float> heights);
+
+    // Cells within `radius` cells of (col, row) visible from it.
+    // blockHeight <= 0 disables occlusion (a flat disc).
+    void Compute(int col, int row, float radius, float blockHeight, Mask& out) const;
+
+private:
+    int cols_ = 0;
+    int rows_ = 0;
+    std::vector<float> heights_;
+};
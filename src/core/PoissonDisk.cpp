@@ -0,0 +1,199 @@
+#include "PoissonDisk.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+uint32_t hash32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Small xorshift generator; std distributions are not portable
+// across standard libraries, which would break per-seed output.
+struct TileRng {
+    uint32_t state;
+    explicit TileRng(uint32_t seed) : state(seed ? seed : 0x9e3779b9U) {}
+    uint32_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    float unit() { return (next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+struct BackgroundGrid {
+    glm::vec2 origin{0.0f};
+    float cellSize = 1.0f;
+    int cols = 0;
+    int rows = 0;
+    std::vector<glm::vec2> points;
+    std::vector<uint8_t> used;
+
+    bool cellOf(const glm::vec2& p, int& col, int& row) const
+    {
+        col = static_cast<int>((p.x - origin.x) / cellSize);
+        row = static_cast<int>((p.y - origin.y) / cellSize);
+        return col >= 0 && row >= 0 && col < cols && row < rows;
+    }
+
+    bool fits(const glm::vec2& p, float minDistSq) const
+    {
+        int col = 0, row = 0;
+        if (!cellOf(p, col, row))
+            return false;
+        for (int r = std::max(0, row - 2); r <= std::min(rows - 1, row + 2); ++r)
+        {
+            for (int c = std::max(0, col - 2); c <= std::min(cols - 1, col + 2); ++c)
+            {
+                size_t idx = static_cast<size_t>(r) * cols + c;
+                if (!used[idx])
+                    continue;
+                glm::vec2 d = points[idx] - p;
+                if (glm::dot(d, d) < minDistSq)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void insert(const glm::vec2& p)
+    {
+        int col = 0, row = 0;
+        if (!cellOf(p, col, row))
+            return;
+        size_t idx = static_cast<size_t>(row) * cols + col;
+        points[idx] = p;
+        used[idx] = 1;
+    }
+};
+
+} // namespace
+
+namespace PoissonDisk {
+
+float RandomUnit(uint32_t random, uint32_t channel)
+{
+    return (hash32(random ^ (channel * 0x9e3779b9U)) >> 8) * (1.0f / 16777216.0f);
+}
+
+std::vector<Sample> Generate(const Params& params,
+                             const std::function<float(float, float)>& density)
+{
+    std::vector<Sample> result;
+    const glm::vec2 extent = params.max - params.min;
+    if (params.minDistance <= 0.0f || extent.x <= 0.0f || extent.y <= 0.0f)
+        return result;
+
+    const float r = params.minDistance;
+    const float rSq = r * r;
+    // Same-phase tiles are one tile apart; 3r keeps their neighbour
+    // lookups (two grid cells, ~1.4r) from ever overlapping.
+    const float tile = std::max(params.tileSize, 3.0f * r);
+
+    BackgroundGrid grid;
+    grid.origin = params.min;
+    grid.cellSize = r / std::sqrt(2.0f);
+    grid.cols = static_cast<int>(std::ceil(extent.x / grid.cellSize));
+    grid.rows = static_cast<int>(std::ceil(extent.y / grid.cellSize));
+    grid.points.assign(static_cast<size_t>(grid.cols) * grid.rows, glm::vec2(0.0f));
+    grid.used.assign(static_cast<size_t>(grid.cols) * grid.rows, 0);
+
+    const int tilesX = static_cast<int>(std::ceil(extent.x / tile));
+    const int tilesZ = static_cast<int>(std::ceil(extent.y / tile));
+    std::vector<std::vector<Sample>> tileOutput(static_cast<size_t>(tilesX) * tilesZ);
+
+    auto fillTile = [&](int tx, int tz)
+    {
+        const glm::vec2 lo = params.min + glm::vec2(tx * tile, tz * tile);
+        const glm::vec2 hi = glm::min(lo + glm::vec2(tile), params.max);
+        TileRng rng(hash32(params.seed ^ hash32(static_cast<uint32_t>(tx) * 73856093U ^
+                                                static_cast<uint32_t>(tz) * 19349663U)));
+        std::vector<Sample>& out = tileOutput[static_cast<size_t>(tz) * tilesX + tx];
+        std::vector<glm::vec2> active;
+
+        auto accept = [&](const glm::vec2& p)
+        {
+            grid.insert(p);
+            active.push_back(p);
+            uint32_t random = rng.next();
+            float keep = density ? density(p.x, p.y) : 1.0f;
+            if (keep > 0.0f && RandomUnit(random, 0) < keep)
+                out.push_back({ p, hash32(random) });
+        };
+
+        auto inside = [&](const glm::vec2& p)
+        {
+            return p.x >= lo.x && p.y >= lo.y && p.x < hi.x && p.y < hi.y;
+        };
+
+        // A few independent seeds pick up free space that is cut off
+        // from the first seed by neighbouring tiles.
+        const int seedTries = 8;
+        for (int s = 0; s < seedTries; ++s)
+        {
+            glm::vec2 seedPoint(glm::mix(lo.x, hi.x, rng.unit()), glm::mix(lo.y, hi.y, rng.unit()));
+            if (!inside(seedPoint) || !grid.fits(seedPoint, rSq))
+                continue;
+            accept(seedPoint);
+
+            while (!active.empty())
+            {
+                size_t pick = rng.next() % active.size();
+                glm::vec2 base = active[pick];
+                bool placed = false;
+                for (int k = 0; k < params.attempts; ++k)
+                {
+                    float angle = rng.unit() * 6.2831853f;
+                    float dist = r * (1.0f + rng.unit());
+                    glm::vec2 candidate = base + dist * glm::vec2(std::cos(angle), std::sin(angle));
+                    if (!inside(candidate) || !grid.fits(candidate, rSq))
+                        continue;
+                    accept(candidate);
+                    placed = true;
+                    break;
+                }
+                if (!placed)
+                {
+                    active[pick] = active.back();
+                    active.pop_back();
+                }
+            }
+        }
+    };
+
+    // Four checkerboard phases; tiles inside a phase are independent.
+    for (int phase = 0; phase < 4; ++phase)
+    {
+        const int px = phase & 1;
+        const int pz = phase >> 1;
+        std::vector<glm::ivec2> phaseTiles;
+        for (int tz = pz; tz < tilesZ; tz += 2)
+            for (int tx = px; tx < tilesX; tx += 2)
+                phaseTiles.emplace_back(tx, tz);
+
+        Parallel::ForTiles(static_cast<int>(phaseTiles.size()), 1, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+                fillTile(phaseTiles[i].x, phaseTiles[i].y);
+        });
+    }
+
+    size_t total = 0;
+    for (const auto& tileSamples : tileOutput)
+        total += tileSamples.size();
+    result.reserve(total);
+    for (const auto& tileSamples : tileOutput)
+        result.insert(result.end(), tileSamples.begin(), tileSamples.end());
+    return result;
+}
+
+} // namespace PoissonDisk
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ============================================================
+// PoissonDisk
+// Tiled Bridson sampling. Tiles run in four checkerboard phases
+// so tiles of one phase never touch and can be filled on worker
+// threads; each tile has its own RNG seeded from (seed, tile), so
+// the output is identical for a given seed regardless of thread
+// count or scheduling.
+//
+// `density(x, z)` in [0, 1] thins the blue-noise set: every accepted
+// point still reserves its disc, but is only emitted with that
+// probability. It is called from worker threads.
+// ============================================================
+namespace PoissonDisk {
+
+struct Params {
+    glm::vec2 min{0.0f};
+    glm::vec2 max{0.0f};
+    float minDistance = 1.0f;
+    float tileSize = 64.0f;      // clamped to >= minDistance
+    uint32_t seed = 0;
+    int attempts = 24;           // candidates per active point
+};
+
+struct Sample {
+    glm::vec2 position;
+    uint32_t random;             // per-sample hash for rotation/scale etc.
+};
+
+std::vector<Sample> Generate(const Params& params,
+                             const std::function<float(float, float)>& density);
+
+// Deterministic [0, 1) from a sample hash and a channel index.
+float RandomUnit(uint32_t random, uint32_t channel);
+
+} // namespace PoissonDisk
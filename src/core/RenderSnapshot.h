@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../rendering/EntityProxy.h"
+#include "../rendering/DebugDraw.h"
+#include "../gui/UIManager.h"
+
+class Model;
+
+// ============================================================
+// RenderSnapshot
+// Everything the GL thread draws for one simulation tick. Written by
+// Scene::WriteRenderSnapshot() at the end of the tick into the back
+// slot of a TripleBuffer and read-only once published. Nothing in it
+// points at simulation objects; models and textures are assets that
+// outlive both threads.
+//
+// Changes that are events rather than state (vegetation removals)
+// carry the tick they happened in and are repeated in every snapshot
+// until the GL thread has picked up a snapshot of that tick or later,
+// so skipping snapshots loses none of them. Fog rows and unit poses
+// record the tick they last changed in for the same reason.
+// ============================================================
+struct RenderSnapshot {
+    struct VegetationRemoval {
+        uint64_t tick;
+        bool rock;          // rock layer, else tree layer
+        uint32_t index;     // VegetationLayer::RemoveSwapLast arguments
+        uint32_t last;
+    };
+    // A unit's bone palette range, sent when its pose changed
+    struct PoseUpdate {
+        uint64_t tick;      // tick the pose last changed in
+        int base;           // first matrix in the palette
+        int count;
+        uint32_t first;     // index into `bones`
+    };
+    struct SelectionMarker {
+        glm::vec3 position;
+        float healthFill;   // < 0 = no health bar
+    };
+    struct PlacementPreview {
+        Model* model = nullptr;     // null = not placing
+        glm::mat4 transform{1.0f};
+        bool valid = false;
+    };
+
+    uint64_t tick = 0;
+
+    // Camera of this tick; the simulation picks with the same matrices
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec3 viewPos{0.0f};
+
+    // Units and buildings visible to the active player
+    std::vector<EntityProxy> entities;
+    // Bone palette size and the ranges the GL thread may not have yet;
+    // EntityProxy::boneBase indexes the palette
+    int paletteSize = 0;
+    std::vector<PoseUpdate> poseUpdates;
+    std::vector<glm::mat4> bones;
+    uint64_t staticShadowKey = 0;
+
+    std::vector<VegetationRemoval> vegetationRemovals;
+
+    // Active player's fog of war: one state per nav cell (0..2) and,
+    // per row, the tick that row last changed in
+    int fogCols = 0;
+    int fogRows = 0;
+    bool fogRevealed = false;
+    std::vector<uint8_t> fog;
+    std::vector<uint64_t> fogRowTicks;
+
+    std::vector<SelectionMarker> selection;
+    PlacementPreview preview;
+    uint8_t debugOverlays = 0;
+    DebugGeometry debug;
+    UIDrawList ui;
+};
@@ -0,0 +1,93 @@
+#include "ResourceNodeIndex.h"
+#include <algorithm>
+#include <cmath>
+
+void ResourceNodeIndex::Build(const std::vector<glm::vec3>& positions,
+                              const glm::vec2& origin, const glm::vec2& extent, float cellSize)
+{
+    origin_ = origin;
+    cellSize_ = std::max(cellSize, 1.0f);
+    cols_ = std::max(1, static_cast<int>(std::ceil(extent.x / cellSize_)));
+    rows_ = std::max(1, static_cast<int>(std::ceil(extent.y / cellSize_)));
+    cells_.assign(static_cast<size_t>(cols_) * rows_, {});
+
+    for (size_t i = 0; i < positions.size(); ++i)
+        cells_[cellIndex(positions[i])].push_back(static_cast<uint32_t>(i));
+}
+
+void ResourceNodeIndex::Clear()
+{
+    cells_.clear();
+    cols_ = rows_ = 0;
+}
+
+int ResourceNodeIndex::cellIndex(const glm::vec3& pos) const
+{
+    int col = static_cast<int>(std::floor((pos.x - origin_.x) / cellSize_));
+    int row = static_cast<int>(std::floor((pos.z - origin_.y) / cellSize_));
+    col = std::clamp(col, 0, cols_ - 1);
+    row = std::clamp(row, 0, rows_ - 1);
+    return row * cols_ + col;
+}
+
+bool ResourceNodeIndex::FindNearest(const glm::vec3& point, float radius,
+                                    const std::vector<glm::vec3>& positions, size_t& outIndex) const
+{
+    if (cells_.empty() || radius <= 0.0f)
+        return false;
+
+    int minCol = static_cast<int>(std::floor((point.x - radius - origin_.x) / cellSize_));
+    int maxCol = static_cast<int>(std::floor((point.x + radius - origin_.x) / cellSize_));
+    int minRow = static_cast<int>(std::floor((point.z - radius - origin_.y) / cellSize_));
+    int maxRow = static_cast<int>(std::floor((point.z + radius - origin_.y) / cellSize_));
+    minCol = std::clamp(minCol, 0, cols_ - 1);
+    maxCol = std::clamp(maxCol, 0, cols_ - 1);
+    minRow = std::clamp(minRow, 0, rows_ - 1);
+    maxRow = std::clamp(maxRow, 0, rows_ - 1);
+
+    float bestDistSq = radius * radius;
+    bool found = false;
+    for (int row = minRow; row <= maxRow; ++row)
+    {
+        for (int col = minCol; col <= maxCol; ++col)
+        {
+            for (uint32_t idx : cells_[static_cast<size_t>(row) * cols_ + col])
+            {
+                if (idx >= positions.size())
+                    continue;
+                glm::vec2 d(positions[idx].x - point.x, positions[idx].z - point.z);
+                float distSq = glm::dot(d, d);
+                if (distSq < bestDistSq || (found && distSq == bestDistSq && idx < outIndex))
+                {
+                    bestDistSq = distSq;
+                    outIndex = idx;
+                    found = true;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void ResourceNodeIndex::RemoveSwapLast(size_t index, const glm::vec3& indexPos,
+                                       size_t last, const glm::vec3& lastPos)
+{
+    if (cells_.empty())
+        return;
+
+    std::vector<uint32_t>& cell = cells_[cellIndex(indexPos)];
+    auto it = std::find(cell.begin(), cell.end(), static_cast<uint32_t>(index));
+    if (it != cell.end())
+    {
+        *it = cell.back();
+        cell.pop_back();
+    }
+
+    if (index == last)
+        return;
+
+    std::vector<uint32_t>& moved = cells_[cellIndex(lastPos)];
+    auto mv = std::find(moved.begin(), moved.end(), static_cast<uint32_t>(last));
+    if (mv != moved.end())
+        *mv = static_cast<uint32_t>(index);
+}
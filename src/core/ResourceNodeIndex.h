@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ============================================================
+// ResourceNodeIndex
+// Uniform XZ grid over resource node indices (trees, rocks) for
+// radius queries. Node storage stays in Scene; removal mirrors the
+// swap-with-last used there.
+// ============================================================
+class ResourceNodeIndex {
+public:
+    void Build(const std::vector<glm::vec3>& positions,
+               const glm::vec2& origin, const glm::vec2& extent, float cellSize);
+    void Clear();
+
+    // Nearest node within `radius` (XZ distance), or false.
+    bool FindNearest(const glm::vec3& point, float radius,
+                     const std::vector<glm::vec3>& positions, size_t& outIndex) const;
+
+    // Node `index` is removed and node `last` moves into its slot.
+    void RemoveSwapLast(size_t index, const glm::vec3& indexPos,
+                        size_t last, const glm::vec3& lastPos);
+
+private:
+    glm::vec2 origin_{0.0f};
+    float cellSize_ = 16.0f;
+    int cols_ = 0;
+    int rows_ = 0;
+    std::vector<std::vector<uint32_t>> cells_;
+
+    int cellIndex(const glm::vec3& pos) const;
+};
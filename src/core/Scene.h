@@ -23,9 +23,29 @@
 // Engine / Rendering
 // ============================================================
 #include "../rendering/terrain/Terrain.h"
+#include "../rendering/terrain/ShoreDistanceField.h"
+#include "WorldCache.h"
+#include "ResourceNodeIndex.h"
+#include "AnimationBudget.h"
+#include "LineOfSight.h"
+#include "../rendering/VegetationLayer.h"
+#include "../rendering/BillboardImpostor.h"
+#include "../rendering/EntityBatcher.h"
+#include "../rendering/BonePalette.h"
+#include "../rendering/SphereCuller.h"
+#include "../rendering/ShadowCascades.h"
+#include "../rendering/SkinningPrepass.h"
+#include "../rendering/SelectionRings.h"
+#include "../rendering/DebugDraw.h"
+#include "../rendering/RenderQueue.h"
+#include "../rendering/EntityProxy.h"
+#include "RenderSnapshot.h"
 #include "../../common/Model.h"
 #include "../../common/Texture.h"
 #include "../../common/Shader.h"
+#include "../../common/FrameUniforms.h"
+#include "../../common/GLState.h"
+#include "../../common/ParallelFor.h"
 #include "Camera.h"
 #include "Scene.h"
 
@@ -33,6 +53,7 @@
 // RTS Systems
 // ============================================================
 #include "../gui/UIManager.h"
+#include "../gui/UIRenderer.h"
 #include "../game/managers/BuildingManager.h"
 #include "../game/managers/UnitManager.h"
 #include "../network/NetworkSession.h"
@@ -72,20 +93,73 @@ public:
     Scene();
     ~Scene();
 
+    // Map size in world units; call before Init (defaults to 600x600).
+    void SetMapSize(int width, int depth);
+    // Water reflection/refraction targets at 1/resolutionDivisor of the
+    // framebuffer (2 or 4), re-rendered every updateInterval frames.
+    // GL thread; takes effect on the next DrawWaterTargets.
+    void SetWaterQuality(int resolutionDivisor, int updateInterval);
+    // On the GL thread, before the simulation thread starts.
     void Init(Camera* activeCamera);
+
+    // ---- Simulation thread ----
+    // Game state (entities, fog, HUD, camera) belongs to the thread
+    // running these once it starts; the GL thread sees it only through
+    // the RenderSnapshot written at the end of each tick.
+
+    // Sizes sampled by the main thread (GLFW is main-thread only).
+    void SetViewportSize(int fbW, int fbH, int windowW, int windowH);
     void Update(float dt, const Camera& cam);
+    // Copies everything the GL thread draws this tick into `out`.
+    // Events with tick <= consumedTick (already picked up by the GL
+    // thread) are dropped from the pending lists.
+    void WriteRenderSnapshot(RenderSnapshot& out, uint64_t consumedTick);
+
+    // ---- GL thread ----
+    // Makes `snapshot` the source of every call below until the next
+    // BeginFrame, and applies what it carries: vegetation removals,
+    // changed fog rows and the bone palette. `snapshot` must outlive
+    // Draw().
+    void BeginFrame(const RenderSnapshot& snapshot);
+    // Uploads the shared FrameBlock/LightBlock; once per frame, after
+    // the cascades are fitted and before DrawDepth.
+    void UpdateFrameUniforms(const glm::mat4& view,
+                             const glm::mat4& projection,
+                             const glm::vec3& viewPos,
+                             const ShadowCascades& cascades,
+                             const glm::vec3& lightPos);
+    // Skins every unit inside the camera or a shadow cascade once, for
+    // all passes (SkinningPrepass).
+    void UpdateSkinnedVertices(const glm::mat4& viewProjection,
+                               const ShadowCascades& cascades);
+
+    // Reflection and refraction of terrain and finished buildings for
+    // the water shaders; after the depth passes, before Draw. Skips
+    // frames per SetWaterQuality.
+    void DrawWaterTargets(Shader& terrainShader,
+                          Shader& objectShader,
+                          int fbW, int fbH,
+                          unsigned int shadowMap);
 
     void Draw(Shader& terrainShader,
               Shader& objectShader,
               glm::mat4 view,
               glm::mat4 projection,
-              glm::vec3 lightPos,
               glm::vec3 viewPos,
-              const glm::mat4& lightSpaceMatrix,
-              unsigned int shadowMap);
-
+              unsigned int shadowMap);   // depth texture array, one layer per cascade
+
+    // Shadow casters for one cascade, culled to its light frustum.
+    // Static casters go to the cascade's cached layer and are redrawn
+    // only when the snapshot's staticShadowKey changes (computed by
+    // ComputeStaticShadowKey() on the simulation thread); DrawDepth
+    // draws the dynamic ones every frame.
+    uint64_t ComputeStaticShadowKey() const;
+    void DrawStaticDepth(Shader& depthShader,
+                         const glm::mat4& lightSpaceMatrix,
+                         int cascade);
     void DrawDepth(Shader& depthShader,
-                   const glm::mat4& lightSpaceMatrix);
+                   const glm::mat4& lightSpaceMatrix,
+                   int cascade);
 
     // Input / UI
     void setupBuildingBar();
@@ -109,6 +183,18 @@ public:
     void onMouseButton(int button, int action, int mods);
     void cancelCurrentAction();
     void updateResourceTexts();
+    // HUD panels are rebuilt on change, not every frame: events mark
+    // them dirty and refreshDirtyUI() (end of Update) rebuilds only the
+    // marked ones. Calling a panel's update directly clears its flag.
+    enum UIDirtyFlags : uint8_t {
+        UIDirtyResources  = 1 << 0,
+        UIDirtyUnitList   = 1 << 1,
+        UIDirtyProduction = 1 << 2,
+        UIDirtyUnitInfo   = 1 << 3,
+        UIDirtyAll        = 0x0F
+    };
+    void markUIDirty(uint8_t flags) { uiDirty_ |= flags; }
+    void refreshDirtyUI();
     void switchActivePlayer();
     int GetActivePlayerIndex() const { return activePlayerIndex_; }
     Resources& activePlayer();
@@ -121,8 +207,12 @@ public:
     void checkVictoryState();
     void registerTownCenter(TownCenter* tc);
     void registerBarracks(Barracks* barracks);
-    void drawSelectionIndicators(const glm::mat4& view, const glm::mat4& projection);
-    void initSelectionCircle();
+    void drawSelectionIndicators();
+    // Profiling overlays (nav grid, paths, fog): built into the
+    // snapshot on the simulation thread, drawn through debugDraw_.
+    void buildDebugOverlays(DebugGeometry& out) const;
+    void drawDebugOverlays();
+    void reportRenderStats(size_t packetCount);
     void configureBuildingPreviewsForOwner(int ownerId);
     void updateBuildingBarLabels();
     Model* modelForBuildType(BuildType type, int ownerId) const;
@@ -137,7 +227,22 @@ public:
     void initFogOfWar();
     void resetFogOfWar();
     void updateFogOfWar();
-    bool updatePlayerFog(int playerId);
+    // Vision stamp of one viewer: its line-of-sight mask added to the
+    // owner's visibility counters (see updateFogStamp).
+    struct FogStamp {
+        int player = 0;
+        int col = -1;           // -1 = stamps nothing
+        int row = -1;
+        int radiusKey = 0;      // radius in 1/kFogRadiusSteps cells
+        std::shared_ptr<const LineOfSight::Mask> mask;
+    };
+    static constexpr float kFogRadiusSteps = 4.0f;
+    static uint64_t fogLosKey(int col, int row, int radiusKey, int cols);
+    void applyFogStamp(const FogStamp& stamp, int delta);
+    // False while the viewer's new mask is still queued.
+    bool updateFogStamp(const GameEntity* entity);
+    void releaseFogStamp(const GameEntity* entity);
+    void computeQueuedFogMasks();
     void spawnStartingTownCenters();
     void clearUnitSelection();
     void selectSingleUnit(const glm::vec2& screenPos, bool additive);
@@ -176,9 +281,22 @@ public:
     GameEntity* findEntityByNetworkId(int networkId) const;
     bool findClosestLandPoint(const glm::vec3& desired, glm::vec3& out) const;
     bool isPositionVisibleToPlayer(const glm::vec3& pos, int playerId) const;
+    // Own/neutral entities always; enemies only inside the active player's vision.
+    bool isEntityVisibleToActivePlayer(const GameEntity* entity) const;
+    void scheduleUnitAnimations(const Camera& cam);
+    // Main camera projection for the current framebuffer (SceneConst
+    // kView*); the snapshot, picking and the animation budget share it.
+    glm::mat4 cameraProjection() const;
+    // Indices of the frame's entity proxies whose bounding sphere
+    // touches `frustum` (camera for the main pass, light for shadows).
+    void cullEntities(const Frustum& frustum, std::vector<uint32_t>& out);
+    bool isStaticShadowCaster(const GameEntity* entity) const;
     bool isPositionExploredByPlayer(const glm::vec3& pos, int playerId) const;
-    void rebuildFogMeshForPlayer(int playerId);
-    void DrawFogOfWar(const glm::mat4& view, const glm::mat4& projection);
+    // Uploads the snapshot's fog rows changed since the last upload
+    // (all rows when the texture is new) into fogTexture_.
+    void uploadFogTexture(const RenderSnapshot& snapshot);
+    // Points `shader` at fogTexture_ (unit 8), or disables fog when revealed.
+    void bindFogOfWar(Shader& shader) const;
     float visibilityRadiusForEntity(const GameEntity* entity) const;
     bool segmentCrossesWater(const glm::vec3& start, const glm::vec3& end) const;
     enum class ResourceNodeType { Tree, Rock };
@@ -212,6 +330,8 @@ public:
     bool findPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& outPath) const;
     void toggleFogReveal();
     bool isFogRevealed() const { return fogRevealOverride_; }
+    // Steps the debug overlay: off, nav grid, paths, fog, all.
+    void cycleDebugOverlay();
 
 private:
     // ========================================================
@@ -222,6 +342,8 @@ private:
 
     int fbWidth  = 0;
     int fbHeight = 0;
+    int winWidth_  = 0;
+    int winHeight_ = 0;
 
     // ========================================================
     // Models
@@ -286,6 +408,88 @@ private:
 
     void generateTrees();
     void generateRocks();
+    float treeDensity(float x, float z) const;
+    float rockDensity(float x, float z) const;
+
+    // Spatial index over treePositions_ / rockPositions_
+    ResourceNodeIndex treeIndex_;
+    ResourceNodeIndex rockIndex_;
+    void rebuildResourceIndex();
+
+    // Chunked GPU instances for treeTransforms / rockTransforms
+    VegetationLayer treeLayer_;
+    VegetationLayer rockLayer_;
+    BillboardImpostor treeImpostor_;
+    Shader* impostorShader_ = nullptr;
+
+    FrameUniforms frameUniforms_;
+
+    // ========================================================
+    // GL thread only; fed by BeginFrame
+    // ========================================================
+    const RenderSnapshot* frame_ = nullptr;
+    uint64_t appliedVegetationTick_ = 0;
+    uint64_t appliedPoseTick_ = 0;
+
+    // Main-pass draw packets, sorted by pass/shader/material/depth
+    RenderQueue renderQueue_;
+    // Vegetation visible this frame; read by queued packets
+    VegetationLayer::VisibleSet visibleTrees_;
+    VegetationLayer::VisibleSet visibleRocks_;
+    double lastRenderStatsTime_ = 0.0;
+
+    // Per-frame instancing of entity proxies (main and depth pass);
+    // the index vectors address frame_->entities
+    EntityBatcher entityBatcher_;
+    std::vector<uint32_t> individualEntities_;
+    SphereCuller entityCuller_;
+    std::vector<uint32_t> culledEntities_;
+    // Skinning matrices of the CPU-posed units, updated from the
+    // snapshot's pose ranges; bound to unit 13 for entity draws
+    BonePalette bonePalette_;
+    // Frame-wide pre-skinned unit vertices; bound to unit 14. Per
+    // proxy vertex base, -1 if the unit skins in its own passes.
+    SkinningPrepass skinningPrepass_;
+    Shader* skinningShader_ = nullptr;
+    std::vector<uint32_t> preskinUnits_;
+    std::vector<int> proxySkinnedBase_;
+    // Bumped whenever trees/rocks change or a finished building is
+    // removed; part of the static shadow key
+    uint64_t staticShadowRevision_ = 0;
+    // Tree/rock removals not yet seen by the GL thread
+    std::vector<RenderSnapshot::VegetationRemoval> pendingVegetationRemovals_;
+    // Last snapshot written; events stamp snapshotTick_ + 1
+    uint64_t snapshotTick_ = 0;
+    // CPU pose update rate per unit (screen size / visibility LOD)
+    AnimationBudget animationBudget_;
+    // Bone palette range of each CPU-posed unit in the last snapshot,
+    // by network id; kept while the unit stays visible so an unchanged
+    // pose is neither copied nor uploaded again.
+    struct PoseSlot {
+        int base = 0;
+        int count = 0;
+        uint64_t revision = 0;      // Unit::GetPoseRevision() last sent
+        uint64_t tick = 0;          // tick the pose last changed in
+        uint64_t seenTick = 0;      // last snapshot the unit was in
+    };
+    std::unordered_map<int, PoseSlot> poseSlots_;
+    std::vector<std::pair<int, int>> freePoseRanges_;   // (base, count)
+    int paletteSize_ = 0;
+    // Palette base of the unit's pose, queued in `out` if the GL thread
+    // may not have it yet; -1 when the unit has no slot.
+    int writeUnitPose(const Unit& unit, RenderSnapshot& out, uint64_t consumedTick);
+    void buildVegetationLayers();
+    void bakeTreeImpostor();
+
+    // ========================================================
+    // WORLD CACHE (generated terrain/vegetation/water/nav data)
+    // ========================================================
+    WorldCache worldCache_;
+    uint64_t worldCacheKey() const;
+    std::string worldCachePath(uint64_t key) const;
+    Terrain* createTerrainFromCache();
+    bool loadWorldFromCache();
+    void saveWorldCache() const;
 
     // ========================================================
     // WATER SYSTEM
@@ -305,9 +509,7 @@ private:
     Shader* waterShader = nullptr;
 
     void GenerateWaterGeometry();
-void DrawWater(const glm::mat4& view,
-               const glm::mat4& proj,
-               const glm::vec3& viewPos);
+void DrawWater();
 
     // Lake
     std::vector<WaterVertex>  lakeWaterVerts;
@@ -317,9 +519,7 @@ void DrawWater(const glm::mat4& view,
     void generateLakeWater();
     void uploadLakeWaterMesh();
 
-void DrawLakeWater(const glm::mat4& view,
-                   const glm::mat4& proj,
-                   const glm::vec3& viewPos);
+void DrawLakeWater();
 
     // River
     std::vector<WaterVertex>  riverWaterVerts;
@@ -329,9 +529,7 @@ void DrawLakeWater(const glm::mat4& view,
     void generateRiverWater();
     void uploadRiverWaterMesh();
 
-    void DrawRiverWater(const glm::mat4& view,
-                    const glm::mat4& proj,
-                    const glm::vec3& viewPos);
+    void DrawRiverWater();
 
     bool nearRiver(float x, float z) const;
     void Resize(int fbW, int fbH);
@@ -351,6 +549,10 @@ void DrawLakeWater(const glm::mat4& view,
     // Foam noise texture (optional but recommended)
     Texture* foamTex = nullptr;
 
+    // Signed distance to the shoreline (foam + nearest-land queries)
+    ShoreDistanceField shoreField_;
+    void buildShoreField();
+
     // Water heights (pick values that match your meshes)
     float oceanY = -1.2f;
     float lakeY  = 4.5f;
@@ -363,8 +565,23 @@ void DrawLakeWater(const glm::mat4& view,
     void beginReflectionPass(int w, int h);
     void beginRefractionPass(int w, int h);
     void endWaterPass(int w, int h);
+    // Terrain and finished buildings under `viewProj`, clipped (GPU) and
+    // culled (CPU) by `clipPlane`.
+    void drawWaterPassGeometry(Shader& terrainShader, Shader& objectShader,
+                               const glm::mat4& viewProj, const glm::vec4& clipPlane);
+    void drawTerrain(Shader& terrainShader);
+    void setupEntityShader(Shader& objectShader);
+
+    int waterTargetDivisor_;       // SceneConst defaults, see SetWaterQuality
+    int waterUpdateInterval_;
+    int waterFramesUntilUpdate_ = 0;
+    // Camera the targets were last rendered with; the water shaders
+    // project into them with these, so a skipped update stays aligned
+    glm::mat4 reflectionViewProj_{1.0f};
+    glm::mat4 refractionViewProj_{1.0f};
     bool isWaterAt(float x, float z, float y) const;
     bool isWaterArea(float x, float z) const;
+    bool isStaticWater(float x, float z) const;
     
     //MousePlacement
     glm::vec3 GetMouseWorldPos(double mouseX, double mouseY,
@@ -377,6 +594,7 @@ void DrawLakeWater(const glm::mat4& view,
     // UI + BUILDING
     // ========================================================
     UIManager       uiManager_;
+    UIRenderer      uiRenderer_;   // GL thread; draws the snapshot's UIDrawList
     BuildingManager buildingManager_;
     UnitManager     unitManager_;
     NetworkSession  networkSession_;
@@ -432,8 +650,15 @@ void DrawLakeWater(const glm::mat4& view,
     glm::vec2 dragCurrent_{0.0f};
     glm::mat4 lastViewMatrix_{1.0f};
     glm::mat4 lastProjMatrix_{1.0f};
-    GLuint selectionCircleVAO = 0;
-    GLuint selectionCircleVBO = 0;
+    SelectionRings selectionRings_;
+    enum DebugOverlayFlags : uint8_t {
+        DebugOverlayNavGrid = 1 << 0,
+        DebugOverlayPaths   = 1 << 1,
+        DebugOverlayFog     = 1 << 2,
+    };
+    uint8_t debugOverlays_ = 0;
+    DebugDraw debugDraw_;   // GL thread; draws the snapshot's DebugGeometry
+    Shader* debugShader_ = nullptr;
     UITab currentTab_ = UITab::Buildings;
     glm::vec2 buildingBarPos_{0.0f};
     glm::vec2 buildingBarSize_{0.0f};
@@ -467,6 +692,14 @@ void DrawLakeWater(const glm::mat4& view,
     size_t unitDeleteButtonIndex_ = SIZE_MAX;
     size_t unitDeleteLabelIndex_ = SIZE_MAX;
     Unit* unitInfoTarget_ = nullptr;
+    uint8_t uiDirty_ = UIDirtyAll;
+    // What the panels last showed; refreshDirtyUI() compares these to
+    // catch changes with no event of their own (resource revisions,
+    // construction finishing, selection edits).
+    unsigned shownResourceRevision_ = 0;
+    int shownResourcePlayer_ = -1;
+    const Building* productionPanelBuilding_ = nullptr;
+    bool productionPanelConstructing_ = false;
     size_t buildingInfoPanelIndex_ = SIZE_MAX;
     size_t buildingInfoTitleLabelIndex_ = SIZE_MAX;
     size_t buildingInfoTextLabelIndex_ = SIZE_MAX;
@@ -489,6 +722,8 @@ void DrawLakeWater(const glm::mat4& view,
     int navGridRows_ = 0;
     glm::vec2 navOrigin_{0.0f};
     std::vector<uint8_t> navWalkable_;
+    std::vector<uint8_t> navStaticWater_;   // 1 = water, bridges excluded
+    void scanNavStaticWater();
 
     bool worldToNav(const glm::vec3& pos, int& col, int& row) const;
     glm::vec3 navToWorld(int col, int row) const;
@@ -506,14 +741,34 @@ void DrawLakeWater(const glm::mat4& view,
 
     // Fog of war
     std::vector<uint8_t> fogStates_[2];
-    std::vector<uint8_t> fogVisibility_[2];
-    bool fogDirty_ = true;
-    GLuint fogVAO_ = 0;
-    GLuint fogVBO_ = 0;
-    size_t fogVertexCount_ = 0;
-    std::vector<float> fogVertexBuffer_;
-    Shader* fogShader = nullptr;
-    float fogPlaneY_ = 12.0f;
+    // Number of vision stamps covering each cell, per player
+    std::vector<uint16_t> fogVisibility_[2];
+    std::unordered_map<const GameEntity*, FogStamp> fogStamps_;
+    // Line of sight over the nav grid's terrain heights; masks shared
+    // by every viewer on the same (cell, radius), see fogLosKey
+    LineOfSight fogLineOfSight_;
+    std::unordered_map<uint64_t, std::shared_ptr<const LineOfSight::Mask>> fogLosCache_;
+    struct FogLosJob {
+        uint64_t key;
+        int col, row, radiusKey;
+        std::shared_ptr<LineOfSight::Mask> mask;
+    };
+    std::vector<FogLosJob> fogLosQueue_;
+    std::vector<const GameEntity*> fogLosWaiting_;
+    // Computes the queued masks every tick; kept alive between ticks
+    Parallel::Pool fogLosWorkers_;
+    // Rows of fogStates_ changed since the last snapshot, per player
+    std::vector<uint8_t> fogDirtyRows_[2];
+    bool fogDirty_ = true;            // every row changed (player switch, reset)
+    // Tick each row of the active player's fog last changed in
+    std::vector<uint64_t> fogRowTicks_;
+    // GL thread: R8, one texel per nav cell, light factor for the
+    // snapshot's player; rows newer than fogUploadTick_ are re-sent
+    GLuint fogTexture_ = 0;
+    int fogTextureCols_ = 0;
+    int fogTextureRows_ = 0;
+    uint64_t fogUploadTick_ = 0;
+    std::vector<uint8_t> fogTexels_;
     bool fogRevealOverride_ = false;
     bool startingBasesSpawned_ = false;
 };
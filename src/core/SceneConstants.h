@@ -10,10 +10,84 @@
 // ============================================================
 namespace SceneConst {
 
-inline constexpr int   kTerrainWidth     = 600;
-inline constexpr int   kTerrainDepth     = 600;
-inline constexpr int   kTreeCount        = 360;
-inline constexpr int   kRockCount        = 110;
+// Default map size; the live size is Terrain::MapWidth()/MapDepth().
+inline constexpr int   kDefaultMapWidth  = 600;
+inline constexpr int   kDefaultMapDepth  = 600;
+
+// Vegetation: Poisson-disk spacing (world units) and base densities.
+// Counts follow from spacing, so they scale with map area.
+inline constexpr float kTreeSpacing      = 12.0f;
+inline constexpr float kRockSpacing      = 24.0f;
+inline constexpr float kRockDensity      = 0.5f;
+inline constexpr float kResourceCellSize = 16.0f;
+// Vegetation render chunks; trees further than the impostor
+// distance from the camera are drawn as billboards.
+inline constexpr float kVegetationChunkSize  = 96.0f;
+inline constexpr float kTreeImpostorDistance = 260.0f;
+inline constexpr int   kTreeImpostorResolution = 256;
+// Unit animation: pre-sample every clip at this rate into a texture
+// so crowds skip per-unit CPU pose evaluation.
+inline constexpr bool  kBakeUnitAnimations   = true;
+inline constexpr float kAnimationBakeRate    = 30.0f;
+// Skin units once per frame via transform feedback; the shadow
+// cascades and the main pass then read the result.
+inline constexpr bool  kPreskinSkinnedUnits  = true;
+// CPU pose update LOD by projected unit height (pixels): at or above
+// full -> every frame, above half -> every 2nd, else every 4th. Only
+// units of models without baked clips pose on the CPU, so with
+// kBakeUnitAnimations on (every shipped unit model bakes) the budget
+// has nothing to schedule; baked units cost a frame index each.
+inline constexpr float kAnimFullRatePixels   = 96.0f;
+inline constexpr float kAnimHalfRatePixels   = 32.0f;
+// Bind-pose bounds do not cover every animated pose (raised arms,
+// attacks); skinned units cull with an inflated sphere.
+inline constexpr float kSkinnedBoundsScale   = 1.5f;
+// Fog of war line of sight: terrain rising this far above a viewer's
+// cell blocks its vision (0 = flat discs). New vision masks are
+// computed on a small persistent worker pool (threads including the
+// simulation thread), at most this many per frame, and kept in a
+// (cell, radius) cache of bounded size.
+inline constexpr float kFogLosBlockHeight    = 6.0f;
+inline constexpr int   kFogLosMasksPerFrame  = 64;
+inline constexpr unsigned kFogLosWorkers     = 4;
+inline constexpr size_t kFogLosCacheLimit    = 8192;
+// Selection ring (radius, height above the unit's feet) and the
+// health bar floating above it.
+inline constexpr float kSelectionRingRadius  = 6.0f;
+inline constexpr float kSelectionRingLift    = 0.6f;
+inline constexpr float kHealthBarLift        = 14.0f;
+inline constexpr float kHealthBarHalfWidth  = 4.0f;
+inline constexpr float kHealthBarHalfHeight = 0.45f;
+// View distance mapped onto the render queue's 24-bit depth field
+// (the camera's far plane).
+inline constexpr float kRenderQueueMaxDepth  = 3000.0f;
+// Debug overlays sit this far above the terrain to avoid z-fighting.
+inline constexpr float kDebugOverlayLift     = 0.4f;
+// Main camera projection; the simulation thread builds it into each
+// render snapshot (and picks with it), the GL thread fits the shadow
+// cascades to it.
+inline constexpr float kViewFovDegrees       = 45.0f;
+inline constexpr float kViewNear             = 0.1f;
+inline constexpr float kViewFar              = 3000.0f;
+// Water reflection/refraction targets: framebuffer size divided by
+// kWaterTargetDivisor (2 or 4), re-rendered every
+// kWaterUpdateInterval frames. Defaults for Scene::SetWaterQuality.
+inline constexpr int   kWaterTargetDivisor   = 2;
+inline constexpr int   kWaterUpdateInterval  = 2;
+// The water passes keep geometry this far past their clip plane so
+// the shoreline has no gap under the wave distortion.
+inline constexpr float kWaterClipBias        = 0.5f;
+
+// World generation inputs (all part of the world cache key)
+inline constexpr unsigned kTreeSeed      = 1337;
+inline constexpr unsigned kRockSeed      = 42;
+inline constexpr float kShoreCellSize    = 2.0f;
+inline constexpr float kNavCellSize      = 3.0f;
+// Bump whenever generation code changes so stale caches are rebuilt.
+inline constexpr int   kWorldGenRevision = 2;
+
+// Everything below is in authored layout space (600x600, see
+// Terrain::ToLayout / FromLayout), not world units.
 
 inline constexpr float kMountainStart    = -90.0f;
 inline constexpr float kMountainAvoidZ   = -70.0f;
@@ -1,15 +1,48 @@
 #include "Scene.h"
 
-void Scene::DrawDepth(Shader& depthShader,
-                      const glm::mat4& lightSpaceMatrix)
+// ------------------------------------------------------------
+// Static shadow casters
+// Terrain, trees, rocks and finished buildings. Rendered into the
+// cascade's cached layer only when the key below changes (or the
+// cascade window jumps to the next grid cell), not every frame.
+// ------------------------------------------------------------
+bool Scene::isStaticShadowCaster(const GameEntity* entity) const
+{
+    const Building* building = dynamic_cast<const Building*>(entity);
+    return building && !building->isUnderConstruction;
+}
+
+uint64_t Scene::ComputeStaticShadowKey() const
+{
+    // FNV-1a over the static revision and the network ids of the
+    // finished, visible buildings (fog can reveal an enemy building).
+    // Ids are never reused, unlike addresses of destroyed buildings.
+    uint64_t key = 1469598103934665603ull;
+    auto mix = [&key](uint64_t value)
+    {
+        key ^= value;
+        key *= 1099511628211ull;
+    };
+    mix(staticShadowRevision_);
+    for (const GameEntity* e : entities_)
+    {
+        if (e && isStaticShadowCaster(e) && isEntityVisibleToActivePlayer(e))
+            mix(static_cast<uint64_t>(static_cast<uint32_t>(e->GetNetworkId())));
+    }
+    return key;
+}
+
+void Scene::DrawStaticDepth(Shader& depthShader,
+                            const glm::mat4& lightSpaceMatrix,
+                            int cascade)
 {
     if (!terrain) return;
 
     depthShader.Use();
-    depthShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
+    depthShader.SetInt("uCascade", cascade);
 
     // ============================================================
-    // 1) TERRAIN (static)
+    // 1) TERRAIN
     // ============================================================
     depthShader.SetBool("isInstanced", false);
     depthShader.SetBool("uUnderConstruction", false);
@@ -21,82 +54,84 @@ void Scene::DrawDepth(Shader& depthShader,
     terrain->Draw(depthShader.ID);
 
     // ============================================================
-    // 2) TREES (instanced)
+    // 2) TREES / ROCKS (instanced, culled to the light frustum)
     // ============================================================
-    if (treeModel && !treeTransforms.empty())
+    const Frustum lightFrustum = Frustum::FromMatrix(lightSpaceMatrix);
+    VegetationLayer::VisibleSet visible;
+
+    depthShader.SetBool("isInstanced", true);
+
+    if (treeModel && treeLayer_.GetChunkCount() > 0)
     {
-        depthShader.SetBool("isInstanced", true);
-        depthShader.SetBool("uUnderConstruction", false);
-        depthShader.SetFloat("uBuildProgress", 1.0f);
-        depthShader.SetBool("uUseSkinning", false);
-        depthShader.BindBoneTexture(0, 0);
+        treeLayer_.Flush();
+        treeLayer_.Cull(lightFrustum, glm::vec3(0.0f), 0.0f, visible);
+        treeModel->DrawInstancedSpans(depthShader, treeLayer_.GetInstanceBuffer(), visible.meshes);
+    }
 
-        treeModel->DrawInstanced(depthShader, treeTransforms);
+    if (rockModel && rockLayer_.GetChunkCount() > 0)
+    {
+        rockLayer_.Flush();
+        rockLayer_.Cull(lightFrustum, glm::vec3(0.0f), 0.0f, visible);
+        rockModel->DrawInstancedSpans(depthShader, rockLayer_.GetInstanceBuffer(), visible.meshes);
     }
 
     // ============================================================
-    // 3) ROCKS (instanced)
+    // 3) FINISHED BUILDINGS
     // ============================================================
-    if (rockModel && !rockTransforms.empty())
+    if (frame_ && !frame_->entities.empty())
     {
-        depthShader.SetBool("isInstanced", true);
-        depthShader.SetBool("uUnderConstruction", false);
-        depthShader.SetFloat("uBuildProgress", 1.0f);
-        depthShader.SetBool("uUseSkinning", false);
-        depthShader.BindBoneTexture(0, 0);
+        const std::vector<EntityProxy>& proxies = frame_->entities;
+        cullEntities(lightFrustum, culledEntities_);
 
-        rockModel->DrawInstanced(depthShader, rockTransforms);
+        entityBatcher_.Begin();
+        for (uint32_t i : culledEntities_)
+        {
+            if (proxies[i].IsStaticShadowCaster())
+                proxies[i].AppendInstances(entityBatcher_, true, -1);
+        }
+        entityBatcher_.Flush(depthShader, 0);
     }
+    depthShader.SetBool("isInstanced", false);
+}
 
-    // ============================================================
-    // 4) BUILDINGS (non-instanced)
-    // ============================================================
-    if (!entities_.empty())
-    {
+// ------------------------------------------------------------
+// Dynamic shadow casters
+// Units and buildings under construction, drawn every frame on top
+// of the cached static layer.
+// ------------------------------------------------------------
+void Scene::DrawDepth(Shader& depthShader,
+                      const glm::mat4& lightSpaceMatrix,
+                      int cascade)
+{
+    if (!frame_ || frame_->entities.empty()) return;
+    const std::vector<EntityProxy>& proxies = frame_->entities;
+
+    depthShader.Use();
+    depthShader.SetInt("uCascade", cascade);
     depthShader.SetBool("isInstanced", false);
+    depthShader.SetBool("uUnderConstruction", false);
+    depthShader.SetFloat("uBuildProgress", 1.0f);
+    depthShader.SetBool("uUseSkinning", false);
+    depthShader.BindBoneTexture(bonePalette_.GetTexture(), 0);
+    depthShader.BindSkinnedVertexTexture(skinningPrepass_.GetTexture());
+
+    cullEntities(Frustum::FromMatrix(lightSpaceMatrix), culledEntities_);
 
-    for (GameEntity* e : entities_)
+    entityBatcher_.Begin();
+    individualEntities_.clear();
+    for (uint32_t i : culledEntities_)
     {
-        if (!e) continue;
-        if (e->ownerID > 0 &&
-            e->ownerID != activePlayerIndex_ + 1 &&
-            !isPositionVisibleToPlayer(e->position, activePlayerIndex_ + 1))
+        if (proxies[i].IsStaticShadowCaster())
             continue;
-
-        depthShader.SetMat4("model", e->transform);
-
-        if (Unit* unit = dynamic_cast<Unit*>(e))
-        {
-            bool useSkin = unit->UsesSkinning();
-            depthShader.SetBool("uUseSkinning", useSkin);
-            if (useSkin)
-                depthShader.BindBoneTexture(unit->GetBoneTexture(), unit->GetBoneCount());
-            else
-                depthShader.BindBoneTexture(0, 0);
-            if (unit->model)
-                unit->model->Draw(depthShader);
-        }
-        else if (Building* b = dynamic_cast<Building*>(e))
-        {
-            depthShader.BindBoneTexture(0, 0);
-            if (b->isUnderConstruction && b->foundationModel)
-            {
-                depthShader.SetBool("uUseSkinning", false);
-                b->foundationModel->Draw(depthShader);
-            }
-            else if (b->finalModel)
-            {
-                depthShader.SetBool("uUseSkinning", false);
-                b->finalModel->Draw(depthShader);
-            }
-        }
-        else
-        {
-            depthShader.SetBool("uUseSkinning", false);
-            depthShader.BindBoneTexture(0, 0);
-            if (e->model) e->model->Draw(depthShader);
-        }
-    }
+        if (!proxies[i].AppendInstances(entityBatcher_, true, proxySkinnedBase_[i]))
+            individualEntities_.push_back(i);
     }
+    entityBatcher_.Flush(depthShader, bonePalette_.GetTexture());
 
+    depthShader.SetBool("isInstanced", false);
+    for (uint32_t i : individualEntities_)
+    {
+        if (proxies[i].kind == EntityProxy::Kind::Unit)
+            proxies[i].Draw(depthShader, proxySkinnedBase_[i], bonePalette_.GetTexture());
+    }
 }
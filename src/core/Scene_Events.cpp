@@ -1,16 +1,21 @@
 #include "Scene.h"
+#include "SceneConstants.h"
+#include "ParallelFor.h"
 #include <algorithm>
 #include <limits>
 #include <sstream>
 #include <glm/gtc/constants.hpp>
 
-void Scene::Update(float dt, const Camera& cam)
-{   
-    int fbW, fbH;
-    glfwGetFramebufferSize(glfwGetCurrentContext(), &fbW, &fbH);
+void Scene::SetViewportSize(int fbW, int fbH, int windowW, int windowH)
+{
     fbWidth = fbW;
     fbHeight = fbH;
+    winWidth_ = windowW;
+    winHeight_ = windowH;
+}
 
+void Scene::Update(float dt, const Camera& cam)
+{   
     if (!camera)
         camera = const_cast<Camera*>(&cam);
     
@@ -27,37 +32,65 @@ void Scene::Update(float dt, const Camera& cam)
     }
     
     // Pass the camera AND dimensions
-    buildingManager_.update(mouseX_, mouseY_, fbW, fbH, cam); 
-
-    updateResourceTexts();
+    buildingManager_.update(mouseX_, mouseY_, fbWidth, fbHeight, cam); 
 
+    scheduleUnitAnimations(cam);
     for (GameEntity* e : entities_)
     {
         if (e)
             e->Update(dt);
     }
 
-    refreshUnitListUI();
-    updateProductionPanel();
-    updateUnitInfoPanel();
     updateGatherTasks(dt);
     updateCombat(dt);
     updateFogOfWar();
     processNetworkMessages();
     updateUnitCameraView();
+    refreshDirtyUI();
 }
 
-
-void Scene::onMouseMove(double x, double y)
+// Picks this frame's pose-update rate per CPU-skinned unit; see AnimationBudget.
+// Baked units are skipped: their pose is a frame index, not a CPU pose.
+void Scene::scheduleUnitAnimations(const Camera& cam)
 {
-    int fbW, fbH;
-    glfwGetFramebufferSize(glfwGetCurrentContext(), &fbW, &fbH);
+    AnimationBudget::View budgetView;
+    const float fovY = glm::radians(SceneConst::kViewFovDegrees);
+    budgetView.viewProj = cameraProjection() * cam.GetViewMatrix();
+    budgetView.eye = cam.Position;
+    budgetView.pixelsPerUnit = static_cast<float>(fbHeight) / (2.0f * std::tan(fovY * 0.5f));
+    animationBudget_.BeginFrame(budgetView);
 
-    int winW, winH;
-    glfwGetWindowSize(glfwGetCurrentContext(), &winW, &winH);
+    for (GameEntity* e : entities_)
+    {
+        Unit* unit = dynamic_cast<Unit*>(e);
+        if (!unit || !unit->model || unit->UsesBakedAnimation())
+            continue;
+
+        const glm::vec3 localMin = unit->model->GetBoundsMin();
+        const glm::vec3 localMax = unit->model->GetBoundsMax();
+        const glm::vec3 center = glm::vec3(unit->transform * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+        const float scale = glm::length(glm::vec3(unit->transform[1]));
+        const float radius = 0.5f * glm::length(localMax - localMin) * scale;
+
+        AnimationBudget::Rate rate =
+            animationBudget_.ChooseRate(center, radius, isEntityVisibleToActivePlayer(unit));
+        unit->SetAnimationDue(animationBudget_.Schedule(rate));
+    }
+}
+
+glm::mat4 Scene::cameraProjection() const
+{
+    const float aspect = fbHeight > 0 ? static_cast<float>(fbWidth) / static_cast<float>(fbHeight) : 1.0f;
+    return glm::perspective(glm::radians(SceneConst::kViewFovDegrees), aspect,
+                            SceneConst::kViewNear, SceneConst::kViewFar);
+}
 
-    float scaleX = (float)fbW / (float)winW;
-    float scaleY = (float)fbH / (float)winH;
+void Scene::onMouseMove(double x, double y)
+{
+    if (winWidth_ <= 0 || winHeight_ <= 0)
+        return;
+    float scaleX = (float)fbWidth / (float)winWidth_;
+    float scaleY = (float)fbHeight / (float)winHeight_;
 
     // Convert to framebuffer pixels
     double px = x * scaleX;
@@ -65,7 +98,7 @@ void Scene::onMouseMove(double x, double y)
 
     // IMPORTANT: store bottom-left origin
     mouseX_ = px;
-    mouseY_ = (double)fbH - py;
+    mouseY_ = (double)fbHeight - py;
 
     if (draggingSelection_)
     {
@@ -403,6 +436,8 @@ int Scene::registerEntity(GameEntity* entity, int requestedId)
     networkEntities_.erase(id);
     entity->SetNetworkId(id);
     networkEntities_[id] = entity;
+    if (dynamic_cast<Unit*>(entity))
+        markUIDirty(UIDirtyUnitList);
     return id;
 }
 
@@ -410,6 +445,11 @@ void Scene::unregisterEntity(GameEntity* entity)
 {
     if (!entity)
         return;
+    releaseFogStamp(entity);
+    if (dynamic_cast<Unit*>(entity))
+        markUIDirty(UIDirtyUnitList);
+    if (isStaticShadowCaster(entity))
+        ++staticShadowRevision_;
     const int id = entity->GetNetworkId();
     if (id > 0)
         networkEntities_.erase(id);
@@ -481,9 +521,7 @@ void Scene::issueMoveCommand()
     if (!hitFound)
     {
         glm::mat4 view = camera->GetViewMatrix();
-        float aspect = fbHeight > 0 ? static_cast<float>(fbWidth) / static_cast<float>(fbHeight) : 1.0f;
-        glm::mat4 projection = glm::perspective(glm::radians(camera->Zoom), aspect, 0.1f, 3000.0f);
-        glm::vec3 fallback = GetMouseWorldPos(mouseX_, mouseY_, fbWidth, fbHeight, view, projection, 0.0f);
+        glm::vec3 fallback = GetMouseWorldPos(mouseX_, mouseY_, fbWidth, fbHeight, view, cameraProjection(), 0.0f);
         fallback.y = Terrain::getHeight(fallback.x, fallback.z);
         if (std::isfinite(fallback.x) && std::isfinite(fallback.y) && std::isfinite(fallback.z))
         {
@@ -610,8 +648,9 @@ void Scene::spawnStartingTownCenters()
         if (!res)
             continue;
 
-        glm::vec3 pos = info.pos;
-        pos.y = Terrain::getHeight(pos.x, pos.z);
+        // Start positions are authored in layout space.
+        glm::vec2 world = Terrain::FromLayout(info.pos.x, info.pos.z);
+        glm::vec3 pos(world.x, Terrain::getHeight(world.x, world.y), world.y);
 
         const bool previous = suppressNetworkSend_;
         suppressNetworkSend_ = true;
@@ -637,6 +676,18 @@ bool Scene::findClosestLandPoint(const glm::vec3& desired, glm::vec3& out) const
     }
 
     const float maxRadius = 60.0f;
+
+    // Fast path: one step down the shore distance gradient.
+    glm::vec3 shore;
+    if (shoreField_.NearestLand(desired, maxRadius, shore) &&
+        !isWaterArea(shore.x, shore.z))
+    {
+        shore.y = Terrain::getHeight(shore.x, shore.z);
+        out = shore;
+        return true;
+    }
+
+    // Fallback: ring probe (field unavailable or gradient ambiguous)
     const float step = 3.0f;
     const int samples = 18;
 
@@ -674,40 +725,18 @@ bool Scene::segmentCrossesWater(const glm::vec3& start, const glm::vec3& end) co
 
 bool Scene::findNearestTree(const glm::vec3& point, float radius, size_t& outIndex, glm::vec3& outPos) const
 {
-    float bestDist = radius;
-    bool found = false;
-    for (size_t i = 0; i < treePositions_.size(); ++i)
-    {
-        float dist = glm::distance(glm::vec2(point.x, point.z),
-                                   glm::vec2(treePositions_[i].x, treePositions_[i].z));
-        if (dist < bestDist)
-        {
-            bestDist = dist;
-            outIndex = i;
-            outPos = treePositions_[i];
-            found = true;
-        }
-    }
-    return found;
+    if (!treeIndex_.FindNearest(point, radius, treePositions_, outIndex))
+        return false;
+    outPos = treePositions_[outIndex];
+    return true;
 }
 
 bool Scene::findNearestRock(const glm::vec3& point, float radius, size_t& outIndex, glm::vec3& outPos) const
 {
-    float bestDist = radius;
-    bool found = false;
-    for (size_t i = 0; i < rockPositions_.size(); ++i)
-    {
-        float dist = glm::distance(glm::vec2(point.x, point.z),
-                                   glm::vec2(rockPositions_[i].x, rockPositions_[i].z));
-        if (dist < bestDist)
-        {
-            bestDist = dist;
-            outIndex = i;
-            outPos = rockPositions_[i];
-            found = true;
-        }
-    }
-    return found;
+    if (!rockIndex_.FindNearest(point, radius, rockPositions_, outIndex))
+        return false;
+    outPos = rockPositions_[outIndex];
+    return true;
 }
 
 void Scene::removeTree(size_t index)
@@ -718,6 +747,8 @@ void Scene::removeTree(size_t index)
     clearGatherTasksFor(ResourceNodeType::Tree, index);
 
     size_t last = treeTransforms.size() - 1;
+    treeIndex_.RemoveSwapLast(index, treePositions_[index], last, treePositions_[last]);
+    pendingVegetationRemovals_.push_back({ snapshotTick_ + 1, false, static_cast<uint32_t>(index), static_cast<uint32_t>(last) });
     if (index != last)
     {
         treeTransforms[index] = treeTransforms[last];
@@ -731,6 +762,7 @@ void Scene::removeTree(size_t index)
 
     treeTransforms.pop_back();
     treePositions_.pop_back();
+    ++staticShadowRevision_;
 }
 
 void Scene::removeRock(size_t index)
@@ -741,6 +773,8 @@ void Scene::removeRock(size_t index)
     clearGatherTasksFor(ResourceNodeType::Rock, index);
 
     size_t last = rockTransforms.size() - 1;
+    rockIndex_.RemoveSwapLast(index, rockPositions_[index], last, rockPositions_[last]);
+    pendingVegetationRemovals_.push_back({ snapshotTick_ + 1, true, static_cast<uint32_t>(index), static_cast<uint32_t>(last) });
     if (index != last)
     {
         rockTransforms[index] = rockTransforms[last];
@@ -754,6 +788,7 @@ void Scene::removeRock(size_t index)
 
     rockTransforms.pop_back();
     rockPositions_.pop_back();
+    ++staticShadowRevision_;
 }
 
 bool Scene::handleResourceGather(const glm::vec3& point)
@@ -1041,6 +1076,8 @@ void Scene::updateCombat(float dt)
             if (knight->ReadyToStrike())
             {
                 unitTarget->SetHealth(unitTarget->GetHealth() - knight->AttackDamage());
+                if (unitTarget == unitInfoTarget_)
+                    markUIDirty(UIDirtyUnitInfo);
                 knight->ResetAttackTimer();
                 if (unitTarget->GetHealth() <= 0.0f)
                     deleteUnit(unitTarget);
@@ -1393,21 +1430,24 @@ void Scene::initFogOfWar()
         fog.assign(cellCount, 0);
     for (auto& vis : fogVisibility_)
         vis.assign(cellCount, 0);
+    fogStamps_.clear();
+    for (auto& rows : fogDirtyRows_)
+        rows.assign(static_cast<size_t>(navGridRows_), 0);
     fogDirty_ = true;
 
-    if (fogVAO_ == 0)
-    {
-        glGenVertexArrays(1, &fogVAO_);
-        glGenBuffers(1, &fogVBO_);
-        glBindVertexArray(fogVAO_);
-        glBindBuffer(GL_ARRAY_BUFFER, fogVBO_);
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
-        glBindVertexArray(0);
-    }
+    // Terrain height per nav cell for line of sight
+    std::vector<float> heights(cellCount, 0.0f);
+    Parallel::ForTiles(navGridRows_, 8, [&](int begin, int end)
+    {
+        for (int row = begin; row < end; ++row)
+        {
+            for (int col = 0; col < navGridCols_; ++col)
+                heights[static_cast<size_t>(row) * static_cast<size_t>(navGridCols_) + static_cast<size_t>(col)] = navToWorld(col, row).y;
+        }
+    });
+    fogLineOfSight_.SetHeightfield(navGridCols_, navGridRows_, std::move(heights));
+    fogLosCache_.clear();
+    // The GL thread recreates fogTexture_ when the snapshot's grid size changes
 }
 
 void Scene::resetFogOfWar()
@@ -1417,6 +1457,7 @@ void Scene::resetFogOfWar()
         std::fill(fogStates_[i].begin(), fogStates_[i].end(), 0);
         fogVisibility_[i].assign(fogStates_[i].size(), 0);
     }
+    fogStamps_.clear();
     fogDirty_ = true;
 }
 
@@ -1431,86 +1472,175 @@ void Scene::updateFogOfWar()
     if (fogStates_[0].empty())
         return;
 
-    bool changed = false;
-    changed |= updatePlayerFog(1);
-    changed |= updatePlayerFog(2);
-    if (changed)
-        fogDirty_ = true;
+    // Live stamps keep their own masks, so the cache can simply be
+    // dropped when it grows too large.
+    if (fogLosCache_.size() > SceneConst::kFogLosCacheLimit)
+        fogLosCache_.clear();
+
+    // Changed cells are recorded per row; WriteRenderSnapshot() stamps
+    // them with the tick and uploadFogTexture() sends them.
+    fogLosWaiting_.clear();
+    for (GameEntity* entity : entities_)
+    {
+        if (entity && !updateFogStamp(entity))
+            fogLosWaiting_.push_back(entity);
+    }
+    if (fogLosQueue_.empty())
+        return;
+
+    computeQueuedFogMasks();
+    for (const GameEntity* entity : fogLosWaiting_)
+        updateFogStamp(entity);
+    // Anything re-queued above is over budget; drop its placeholder.
+    for (const FogLosJob& job : fogLosQueue_)
+        fogLosCache_.erase(job.key);
+    fogLosQueue_.clear();
 }
 
-bool Scene::updatePlayerFog(int playerId)
+// ------------------------------------------------------------
+// Vision stamps
+// Each viewer adds 1 to a per-cell counter over its line-of-sight
+// mask. A stamp is only moved when the viewer changes cell, radius
+// or owner, so stationary entities cost a lookup per frame; a cell
+// flips state only when its counter crosses zero (a move adds the
+// new stamp first, so overlap with the old one never does).
+//
+// Masks depend only on (cell, radius) over static terrain, so they
+// are cached and shared. Missing ones are queued and computed on
+// worker threads, kFogLosMasksPerFrame per frame; until then the
+// viewer keeps its previous stamp.
+// ------------------------------------------------------------
+uint64_t Scene::fogLosKey(int col, int row, int radiusKey, int cols)
 {
-    if (playerId < 1 || playerId > 2)
-        return false;
-    auto& fog = fogStates_[playerId - 1];
-    if (fog.empty())
-        return false;
-
-    auto& visibility = fogVisibility_[playerId - 1];
-    if (visibility.size() != fog.size())
-        visibility.assign(fog.size(), 0);
-    std::fill(visibility.begin(), visibility.end(), 0);
+    const uint64_t cell = static_cast<uint64_t>(row) * static_cast<uint64_t>(cols) + static_cast<uint64_t>(col);
+    return (cell << 16) | static_cast<uint64_t>(radiusKey & 0xFFFF);
+}
 
-    bool changed = false;
+void Scene::applyFogStamp(const FogStamp& stamp, int delta)
+{
+    if (!stamp.mask || stamp.col < 0 || stamp.player < 1 || stamp.player > 2)
+        return;
+    auto& fog = fogStates_[stamp.player - 1];
+    auto& visibility = fogVisibility_[stamp.player - 1];
+    auto& dirtyRows = fogDirtyRows_[stamp.player - 1];
+    if (fog.empty() || visibility.size() != fog.size())
+        return;
 
-    auto revealAround = [&](const glm::vec3& center, float radius)
+    for (const glm::ivec2& offset : *stamp.mask)
     {
-        if (radius <= 0.0f)
-            return;
-        int minCol = static_cast<int>((center.x - radius - navOrigin_.x) / navCellSize_);
-        int maxCol = static_cast<int>((center.x + radius - navOrigin_.x) / navCellSize_);
-        int minRow = static_cast<int>((center.z - radius - navOrigin_.y) / navCellSize_);
-        int maxRow = static_cast<int>((center.z + radius - navOrigin_.y) / navCellSize_);
-        minCol = std::max(0, minCol);
-        minRow = std::max(0, minRow);
-        maxCol = std::min(navGridCols_ - 1, maxCol);
-        maxRow = std::min(navGridRows_ - 1, maxRow);
-
-        const float radiusSq = radius * radius;
-        for (int row = minRow; row <= maxRow; ++row)
+        const int col = stamp.col + offset.x;
+        const int row = stamp.row + offset.y;
+        if (col < 0 || row < 0 || col >= navGridCols_ || row >= navGridRows_)
+            continue;
+        const size_t idx = static_cast<size_t>(row) * static_cast<size_t>(navGridCols_) + static_cast<size_t>(col);
+
+        uint8_t desired = fog[idx];
+        if (delta > 0)
         {
-            for (int col = minCol; col <= maxCol; ++col)
-            {
-                glm::vec3 world = navToWorld(col, row);
-                glm::vec2 delta(world.x - center.x, world.z - center.z);
-                if (glm::dot(delta, delta) > radiusSq)
-                    continue;
-                size_t idx = static_cast<size_t>(row) * static_cast<size_t>(navGridCols_) + static_cast<size_t>(col);
-                if (idx < fog.size())
-                {
-                    visibility[idx] = 1;
-                }
-            }
+            if (visibility[idx]++ == 0)
+                desired = 2;
+        }
+        else if (visibility[idx] > 0 && --visibility[idx] == 0)
+        {
+            desired = 1;   // seen before: stays explored
         }
-    };
 
-    for (GameEntity* entity : entities_)
+        if (desired != fog[idx])
+        {
+            fog[idx] = desired;
+            dirtyRows[static_cast<size_t>(row)] = 1;
+        }
+    }
+}
+
+bool Scene::updateFogStamp(const GameEntity* entity)
+{
+    FogStamp stamp;
+    stamp.player = entity->ownerID;
+    const float radius = visibilityRadiusForEntity(entity);
+    stamp.radiusKey = static_cast<int>(std::lround(radius / navCellSize_ * kFogRadiusSteps));
+    if (stamp.player < 1 || stamp.player > 2 || stamp.radiusKey <= 0 ||
+        !worldToNav(entity->position, stamp.col, stamp.row))
     {
-        if (!entity || entity->ownerID != playerId)
-            continue;
-        float radius = visibilityRadiusForEntity(entity);
-        revealAround(entity->position, radius);
+        stamp.col = stamp.row = -1;
     }
 
-    for (size_t i = 0; i < fog.size(); ++i)
+    auto it = fogStamps_.find(entity);
+    if (it != fogStamps_.end())
     {
-        uint8_t prev = fog[i];
-        uint8_t desired = prev;
-        if (visibility[i])
-            desired = 2;
-        else if (prev > 0)
-            desired = 1;
-        else
-            desired = 0;
+        const FogStamp& old = it->second;
+        if (old.player == stamp.player && old.col == stamp.col &&
+            old.row == stamp.row && old.radiusKey == stamp.radiusKey)
+            return true;
+    }
 
-        if (desired != prev)
+    if (stamp.col >= 0)
+    {
+        const uint64_t key = fogLosKey(stamp.col, stamp.row, stamp.radiusKey, navGridCols_);
+        auto cached = fogLosCache_.find(key);
+        if (cached == fogLosCache_.end())
         {
-            fog[i] = desired;
-            changed = true;
+            // Placeholder marks the key as queued for this frame.
+            fogLosCache_.emplace(key, nullptr);
+            fogLosQueue_.push_back({ key, stamp.col, stamp.row, stamp.radiusKey, nullptr });
+            return false;
         }
+        if (!cached->second)
+            return false;
+        stamp.mask = cached->second;
     }
 
-    return changed;
+    // Add the new stamp before removing the old one, so cells both
+    // cover never touch zero and only real changes dirty a row.
+    applyFogStamp(stamp, +1);
+    if (it != fogStamps_.end())
+    {
+        applyFogStamp(it->second, -1);
+        it->second = std::move(stamp);
+    }
+    else
+    {
+        fogStamps_.emplace(entity, std::move(stamp));
+    }
+    return true;
+}
+
+void Scene::releaseFogStamp(const GameEntity* entity)
+{
+    auto it = fogStamps_.find(entity);
+    if (it == fogStamps_.end())
+        return;
+    applyFogStamp(it->second, -1);
+    fogStamps_.erase(it);
+}
+
+void Scene::computeQueuedFogMasks()
+{
+    const size_t count = std::min(fogLosQueue_.size(),
+                                  static_cast<size_t>(SceneConst::kFogLosMasksPerFrame));
+    for (size_t i = 0; i < count; ++i)
+        fogLosQueue_[i].mask = std::make_shared<LineOfSight::Mask>();
+
+    // Compute() only reads the heightfield; each job owns its mask.
+    fogLosWorkers_.ForTiles(static_cast<int>(count), 4, [&](int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            FogLosJob& job = fogLosQueue_[static_cast<size_t>(i)];
+            fogLineOfSight_.Compute(job.col, job.row,
+                                    static_cast<float>(job.radiusKey) / kFogRadiusSteps,
+                                    SceneConst::kFogLosBlockHeight, *job.mask);
+        }
+    });
+
+    for (size_t i = 0; i < fogLosQueue_.size(); ++i)
+    {
+        if (i < count)
+            fogLosCache_[fogLosQueue_[i].key] = std::move(fogLosQueue_[i].mask);
+        else
+            fogLosCache_.erase(fogLosQueue_[i].key);   // over budget: retried next frame
+    }
+    fogLosQueue_.clear();
 }
 
 float Scene::visibilityRadiusForEntity(const GameEntity* entity) const
@@ -1569,3 +1699,26 @@ void Scene::toggleFogReveal()
     fogRevealOverride_ = !fogRevealOverride_;
     fogDirty_ = true;
 }
+
+void Scene::cycleDebugOverlay()
+{
+    static const uint8_t kSteps[] = {
+        0,
+        DebugOverlayNavGrid,
+        DebugOverlayPaths,
+        DebugOverlayFog,
+        DebugOverlayNavGrid | DebugOverlayPaths | DebugOverlayFog,
+    };
+    static const char* kNames[] = { "off", "nav grid", "paths", "fog", "all" };
+    constexpr size_t kCount = sizeof(kSteps) / sizeof(kSteps[0]);
+
+    size_t current = 0;
+    for (size_t i = 0; i < kCount; ++i)
+    {
+        if (kSteps[i] == debugOverlays_)
+            current = i;
+    }
+    const size_t next = (current + 1) % kCount;
+    debugOverlays_ = kSteps[next];
+    std::cout << "[Debug] Overlay: " << kNames[next] << std::endl;
+}
@@ -23,7 +23,10 @@ Scene::Scene()
       refractionDepthTex(0),
       reflectionDepthRBO(0),
       waterRTWidth(0),
-      waterRTHeight(0)
+      waterRTHeight(0),
+      waterTargetDivisor_(SceneConst::kWaterTargetDivisor),
+      waterUpdateInterval_(SceneConst::kWaterUpdateInterval),
+      fogLosWorkers_(std::min(Parallel::WorkerCount(), SceneConst::kFogLosWorkers))
 {
     activeResources_ = &player1;
 }
@@ -42,34 +45,6 @@ void Scene::registerBarracks(Barracks* barracks)
     unitManager_.registerBarracks(barracks);
 }
 
-void Scene::initSelectionCircle()
-{
-    if (selectionCircleVAO != 0)
-        return;
-
-    const float verts[] = {
-        // positions          // uv
-        -1.0f, 0.0f, -1.0f,   0.0f, 1.0f,
-         1.0f, 0.0f, -1.0f,   1.0f, 1.0f,
-         1.0f, 0.0f,  1.0f,   1.0f, 0.0f,
-
-        -1.0f, 0.0f, -1.0f,   0.0f, 1.0f,
-         1.0f, 0.0f,  1.0f,   1.0f, 0.0f,
-        -1.0f, 0.0f,  1.0f,   0.0f, 0.0f
-    };
-
-    glGenVertexArrays(1, &selectionCircleVAO);
-    glGenBuffers(1, &selectionCircleVBO);
-    glBindVertexArray(selectionCircleVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, selectionCircleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glBindVertexArray(0);
-}
-
 Scene::~Scene()
 {
     soundManager_.Shutdown();
@@ -105,20 +80,29 @@ Scene::~Scene()
     for (GameEntity* e : entities_)
         delete e;
 
-    if (selectionCircleVAO) glDeleteVertexArrays(1, &selectionCircleVAO);
-    if (selectionCircleVBO) glDeleteBuffers(1, &selectionCircleVBO);
-
     delete waterShader;
     delete previewShader;
     delete selectionShader;
-    delete fogShader;
-
-    if (waterVAO) glDeleteVertexArrays(1, &waterVAO);
-    if (lakeVAO) glDeleteVertexArrays(1, &lakeVAO);
-    if (riverVAO) glDeleteVertexArrays(1, &riverVAO);
-    if (fogVAO_) glDeleteVertexArrays(1, &fogVAO_);
-    if (fogVBO_) glDeleteBuffers(1, &fogVBO_);
+    delete debugShader_;
+    delete impostorShader_;
+    delete skinningShader_;
+
+    if (waterVAO) GLState::DeleteVertexArrays(1, &waterVAO);
+    if (lakeVAO) GLState::DeleteVertexArrays(1, &lakeVAO);
+    if (riverVAO) GLState::DeleteVertexArrays(1, &riverVAO);
+    if (fogTexture_) GLState::DeleteTextures(1, &fogTexture_);
+}
+void Scene::SetMapSize(int width, int depth)
+{
+    if (terrain)
+    {
+        std::cerr << "Scene::SetMapSize must be called before Init." << std::endl;
+        return;
+    }
+    Terrain::SetMapSize(width, depth);
+    std::cout << "Map size: " << Terrain::MapWidth() << " x " << Terrain::MapDepth() << std::endl;
 }
+
 void Scene::Init(Camera* activeCamera) {
     camera = activeCamera;
     if (!camera)
@@ -128,15 +112,19 @@ void Scene::Init(Camera* activeCamera) {
     }
     int w, h; // 1. Temporary integers
     glfwGetFramebufferSize(glfwGetCurrentContext(), &w, &h);
-    initWaterRenderTargets(w, h);
+    Resize(w, h);   // water render targets
 
     // 2. Assign to your float variables
     fbWidth = (w);
     fbHeight = (h);
+    glfwGetWindowSize(glfwGetCurrentContext(), &winWidth_, &winHeight_);
 
     std::cout << "Framebuffer: " << fbWidth << " x " << fbHeight << std::endl;
-    // 1. Generate Terrain Mesh
-    terrain = new Terrain(SceneConst::kTerrainWidth, SceneConst::kTerrainDepth);
+    // 1. Generate Terrain Mesh (or map it from the world cache)
+    terrain = createTerrainFromCache();
+    const bool terrainCached = (terrain != nullptr);
+    if (!terrain)
+        terrain = new Terrain(Terrain::MapWidth(), Terrain::MapDepth());
 
     const std::string base = ASSET_PATH;
 
@@ -209,6 +197,22 @@ void Scene::Init(Camera* activeCamera) {
     {
         smithyModel->SetOverrideTexture(base + "evilbuildings/proto_orc_RTS_color.tga.png");
     }
+    if (SceneConst::kBakeUnitAnimations)
+    {
+        for (Model* unitModel : { farmerModel, archerUnitModel, knightUnitModel,
+                                  evilFarmerModel, wizardUnitModel, skeletonUnitModel })
+        {
+            if (unitModel)
+                unitModel->BakeAnimations(SceneConst::kAnimationBakeRate);
+        }
+    }
+    if (SceneConst::kPreskinSkinnedUnits)
+    {
+        skinningShader_ = new Shader(std::string(ASSET_PATH) + "shaders/skin_prepass.vert",
+                                     std::vector<std::string>{ "tfPosition", "tfNormal" });
+    }
+
+    frameUniforms_.Init();
 
     // 4. Load Water Shader
     waterShader = new Shader(
@@ -226,8 +230,9 @@ void Scene::Init(Camera* activeCamera) {
     uiManager_.setFontTexture(fontTex->ID, 16, 16, 8.0f, 8.0f);
     uiManager_.setTextScale(1.35f);
 
-    // 2. Init UIManager with shader + window size
-    uiManager_.init(uiShader, fbWidth, fbHeight);
+    // 2. Init UIManager (HUD layout) and its renderer with the window size
+    uiManager_.init(fbWidth, fbHeight);
+    uiRenderer_.init(uiShader, fbWidth, fbHeight);
     buildingManager_.init(terrain, camera, fbWidth, fbHeight);
     buildingManager_.setPlacementValidator([this](BuildType, const glm::vec3& pos)
     {
@@ -246,11 +251,22 @@ void Scene::Init(Camera* activeCamera) {
     
     // 5. Generate Procedural Content
     GenerateWaterGeometry(); // big ocean plane
-    generateTrees();
-    generateRocks();
-    generateLakeWater();     // local lake mesh
-    generateRiverWater();    // local river mesh
+    const bool worldCached = terrainCached && loadWorldFromCache();
+    if (!worldCached)
+    {
+        generateTrees();
+        generateRocks();
+        generateLakeWater();     // local lake mesh
+        generateRiverWater();    // local river mesh
+        buildShoreField();
+    }
+    rebuildResourceIndex();
+    bakeTreeImpostor();
+    buildVegetationLayers();
     initPathfindingGrid();
+    if (!worldCached)
+        saveWorldCache();
+    worldCache_.Close();
     initFogOfWar();
     setupBuildingBar();
     setupBuildingInfoPanel();
@@ -274,9 +290,9 @@ void Scene::Init(Camera* activeCamera) {
     std::string(ASSET_PATH) + "shaders/selection.vert",
     std::string(ASSET_PATH) + "shaders/selection.frag"
     );
-    fogShader = new Shader(
-    std::string(ASSET_PATH) + "shaders/fog.vert",
-    std::string(ASSET_PATH) + "shaders/fog.frag"
+    debugShader_ = new Shader(
+    std::string(ASSET_PATH) + "shaders/debug.vert",
+    std::string(ASSET_PATH) + "shaders/debug.frag"
     );
     buildingManager_.onPlaceBuilding = [this](BuildType type, glm::vec3 pos, glm::vec3 rotation)
     {
@@ -303,8 +319,6 @@ void Scene::Init(Camera* activeCamera) {
         if (lanModeActive_ && !suppressNetworkSend_ && networkSession_.IsConnected())
             sendBuildCommand(type, ownerId, pos, buildingNetId, initialVillagerId, rotation);
     };
-
-    initSelectionCircle();
 }
 
 Building* Scene::placeBuildingForOwner(BuildType type,
@@ -1,5 +1,6 @@
 #include "Scene.h"
 #include "SceneConstants.h"
+#include "ParallelFor.h"
 #include <queue>
 #include <limits>
 #include <cmath>
@@ -7,15 +8,42 @@
 
 void Scene::initPathfindingGrid()
 {
-    navCellSize_ = 3.0f;
-    navGridCols_ = static_cast<int>(SceneConst::kTerrainWidth / navCellSize_);
-    navGridRows_ = static_cast<int>(SceneConst::kTerrainDepth / navCellSize_);
-    navOrigin_.x = -SceneConst::kTerrainWidth * 0.5f;
-    navOrigin_.y = -SceneConst::kTerrainDepth * 0.5f;
-    navWalkable_.assign(navGridCols_ * navGridRows_, 1);
+    navCellSize_ = SceneConst::kNavCellSize;
+    navGridCols_ = static_cast<int>(Terrain::MapWidth() / navCellSize_);
+    navGridRows_ = static_cast<int>(Terrain::MapDepth() / navCellSize_);
+    navOrigin_.x = -Terrain::MapWidth() * 0.5f;
+    navOrigin_.y = -Terrain::MapDepth() * 0.5f;
+
+    // Static water is either restored from the world cache or scanned once.
+    const size_t cellCount = static_cast<size_t>(navGridCols_) * static_cast<size_t>(navGridRows_);
+    if (navStaticWater_.size() != cellCount)
+        scanNavStaticWater();
+
+    navWalkable_.assign(cellCount, 1);
     refreshNavObstacles();
 }
 
+void Scene::scanNavStaticWater()
+{
+    navStaticWater_.assign(static_cast<size_t>(navGridCols_) * static_cast<size_t>(navGridRows_), 0);
+
+    // Water scan is the expensive part on large maps; rows are independent.
+    // Bridges are excluded here and re-applied in refreshNavObstacles().
+    Parallel::ForTiles(navGridRows_, 16, [this](int rowBegin, int rowEnd)
+    {
+        for (int row = rowBegin; row < rowEnd; ++row)
+        {
+            for (int col = 0; col < navGridCols_; ++col)
+            {
+                glm::vec3 world = navToWorld(col, row);
+                size_t idx = static_cast<size_t>(row) * navGridCols_ + col;
+                if (isStaticWater(world.x, world.z))
+                    navStaticWater_[idx] = 1;
+            }
+        }
+    });
+}
+
 void Scene::refreshNavObstacles()
 {
     if (navGridCols_ <= 0 || navGridRows_ <= 0)
@@ -23,15 +51,19 @@ void Scene::refreshNavObstacles()
 
     navWalkable_.assign(navGridCols_ * navGridRows_, 1);
 
-    for (int row = 0; row < navGridRows_; ++row)
+    for (size_t idx = 0; idx < navStaticWater_.size() && idx < navWalkable_.size(); ++idx)
     {
-        for (int col = 0; col < navGridCols_; ++col)
+        if (!navStaticWater_[idx])
+            continue;
+        if (!bridgeSpans_.empty())
         {
+            int col = static_cast<int>(idx % static_cast<size_t>(navGridCols_));
+            int row = static_cast<int>(idx / static_cast<size_t>(navGridCols_));
             glm::vec3 world = navToWorld(col, row);
-            int idx = row * navGridCols_ + col;
-            if (isWaterArea(world.x, world.z))
-                navWalkable_[idx] = 0;
+            if (pointOnBridge(world.x, world.z))
+                continue;
         }
+        navWalkable_[idx] = 0;
     }
 
     for (GameEntity* entity : entities_)
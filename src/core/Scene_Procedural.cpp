@@ -1,5 +1,91 @@
 #include "Scene.h"
 #include "SceneConstants.h"
+#include "PoissonDisk.h"
+#include "ParallelFor.h"
+
+// ------------------------------------------------------------
+// Procedural placement
+// Positions come from a tiled Poisson-disk sampler in world units;
+// the density masks below are evaluated in layout space so the
+// forest bands stretch with the map. Masks run on worker threads
+// and must only read immutable scene state.
+// ------------------------------------------------------------
+static PoissonDisk::Params mapSampleParams(float spacing, uint32_t seed, float marginFraction)
+{
+    const glm::vec2 half(Terrain::MapWidth() * 0.5f, Terrain::MapDepth() * 0.5f);
+    PoissonDisk::Params params;
+    params.min = -half * (1.0f - marginFraction);
+    params.max =  half * (1.0f - marginFraction);
+    params.minDistance = spacing;
+    params.tileSize = spacing * 8.0f;
+    params.seed = seed;
+    return params;
+}
+
+// Outside the lake (with margin), in layout space.
+static bool clearOfLake(const glm::vec2& layout, float margin)
+{
+    glm::vec2 d(layout.x, layout.y - SceneConst::kLakeCenterZ);
+    float r = SceneConst::kLakeRadius + margin;
+    return glm::dot(d, d) >= r * r;
+}
+
+float Scene::treeDensity(float x, float z) const
+{
+    const glm::vec2 layout = Terrain::ToLayout(x, z);
+    const float lx = layout.x;
+    const float lz = layout.y;
+
+    if (!clearOfLake(layout, 6.0f))
+        return 0.0f;
+    if (lz > SceneConst::kCornerPlainZ && std::abs(lx) > SceneConst::kCornerPlainX)
+        return 0.0f;
+
+    // Band masks (layout space)
+    const bool mountainBand = lz >= SceneConst::kMountainStart - 55.0f &&
+                              lz <= SceneConst::kMountainStart + 10.0f &&
+                              std::abs(lx) <= Terrain::kLayoutSize * 0.35f;
+    const bool southForest  = lz >= 70.0f && std::abs(lx) <= Terrain::kLayoutSize * 0.4f;
+    const bool plains       = lz >= SceneConst::kMountainAvoidZ && lz <= 80.0f &&
+                              std::abs(lx) <= Terrain::kLayoutSize * 0.45f;
+
+    float density = 0.0f;
+    if (southForest)
+        density = std::max(density, SceneConst::kSouthForestBias);
+    if (plains)
+        density = std::max(density, (1.0f - SceneConst::kSouthForestBias) * 0.5f);
+    if (mountainBand)
+        density = std::max(density, SceneConst::kMountainTreeBias);
+    if (density <= 0.0f)
+        return 0.0f;
+
+    // River buffer
+    if (nearRiver(x, z))
+        return 0.0f;
+
+    float height = Terrain::getHeight(x, z);
+    if (height < 1.0f)
+        return 0.0f;
+    if (mountainBand && !southForest && !plains && height < 8.0f)
+        return 0.0f;
+    return density;
+}
+
+float Scene::rockDensity(float x, float z) const
+{
+    const glm::vec2 layout = Terrain::ToLayout(x, z);
+    if (!clearOfLake(layout, 8.0f) || layout.y > 130.0f)
+        return 0.0f;
+    if (nearRiver(x, z))
+        return 0.0f;
+    if (Terrain::getHeight(x, z) < 1.0f)
+        return 0.0f;
+
+    glm::vec3 normal = Terrain::getNormal(x, z);
+    if (glm::dot(normal, glm::vec3(0, 1, 0)) < 0.25f)
+        return 0.0f;
+    return SceneConst::kRockDensity;
+}
 
 // ------------------------------------------------------------
 // Procedural Generation: Trees
@@ -9,63 +95,34 @@ void Scene::generateTrees() {
     treePositions_.clear();
     if (!terrain) return;
 
-    std::mt19937 rng(1337);
-    std::bernoulli_distribution preferSouth(SceneConst::kSouthForestBias);
-    std::bernoulli_distribution mountainChance(SceneConst::kMountainTreeBias);
-    std::uniform_real_distribution<float> forestX(SceneConst::kTerrainWidth * -0.4f,  SceneConst::kTerrainWidth * 0.4f);
-    std::uniform_real_distribution<float> generalX(SceneConst::kTerrainWidth * -0.45f, SceneConst::kTerrainWidth * 0.45f);
-    std::uniform_real_distribution<float> forestZ(60.0f + 10.0f,  SceneConst::kTerrainDepth * 0.5f);
-    std::uniform_real_distribution<float> generalZ(SceneConst::kTerrainDepth * -0.35f,  60.0f + 20.0f);
-    std::uniform_real_distribution<float> mountainX(SceneConst::kTerrainWidth * -0.35f, SceneConst::kTerrainWidth * 0.35f);
-    std::uniform_real_distribution<float> mountainZ(SceneConst::kMountainStart - 55.0f, SceneConst::kMountainStart + 10.0f);
-    std::uniform_real_distribution<float> scaleDist(0.65f, 1.45f);
-    std::uniform_real_distribution<float> rotDist(0.0f, glm::two_pi<float>());
-
-    treeTransforms.reserve(SceneConst::kTreeCount);
-
-    int attempts = 0;
-    const int maxAttempts = SceneConst::kTreeCount * 15;
-    while (treeTransforms.size() < SceneConst::kTreeCount && attempts < maxAttempts) {
-        attempts++;
-        bool mountainBand = mountainChance(rng);
-        bool southBand = !mountainBand && preferSouth(rng);
-        
-        float x = 0.0f, z = 0.0f;
-        if (mountainBand) {
-            x = mountainX(rng);
-            z = mountainZ(rng);
-        } else if (southBand) {
-            x = forestX(rng);
-            z = forestZ(rng);
-        } else {
-            x = generalX(rng);
-            z = generalZ(rng);
-        }
-
-        if (!mountainBand && z < SceneConst::kMountainAvoidZ) continue;
+    const std::vector<PoissonDisk::Sample> samples = PoissonDisk::Generate(
+        mapSampleParams(SceneConst::kTreeSpacing, SceneConst::kTreeSeed, 0.0f),
+        [this](float x, float z) { return treeDensity(x, z); });
 
-        // Avoid lake (use real lake pos)
-        float distToLake = std::sqrt(x * x + std::pow(z - SceneConst::kLakeCenterZ, 2));
-        if (distToLake < SceneConst::kLakeRadius + 6.0f) continue;
-
-        // Avoid rivers (approx)
-        if (Scene::nearRiver(x, z)) continue;
-
-        if (z > SceneConst::kCornerPlainZ && std::abs(x) > SceneConst::kCornerPlainX) continue;
-
-        float height = Terrain::getHeight(x, z);
-        if (height < 1.0f) continue;
-        if (mountainBand && height < 8.0f) continue;
-
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(x, height, z));
-        model = glm::rotate(model, rotDist(rng), glm::vec3(0.0f, 1.0f, 0.0f));
-        float scale = scaleDist(rng) * 1.25f;
-        model = glm::scale(model, glm::vec3(scale));
-
-        treeTransforms.push_back(model);
-        treePositions_.push_back(glm::vec3(x, height, z));
-    }
+    // Written straight into the instance arrays, one slot per sample.
+    treeTransforms.resize(samples.size());
+    treePositions_.resize(samples.size());
+    Parallel::ForTiles(static_cast<int>(samples.size()), 1024, [&](int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            const PoissonDisk::Sample& s = samples[i];
+            float x = s.position.x;
+            float z = s.position.y;
+            float height = Terrain::getHeight(x, z);
+
+            float rotation = PoissonDisk::RandomUnit(s.random, 1) * glm::two_pi<float>();
+            float scale = glm::mix(0.65f, 1.45f, PoissonDisk::RandomUnit(s.random, 2)) * 1.25f;
+
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(x, height, z));
+            model = glm::rotate(model, rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(scale));
+
+            treeTransforms[i] = model;
+            treePositions_[i] = glm::vec3(x, height, z);
+        }
+    });
     std::cout << "Generated " << treeTransforms.size() << " trees." << std::endl;
 }
 
@@ -77,50 +134,33 @@ void Scene::generateRocks() {
     rockPositions_.clear();
     if (!terrain) return;
 
-    std::mt19937 rng(42);
-
-    std::uniform_real_distribution<float> rockX(SceneConst::kTerrainWidth * -0.45f, SceneConst::kTerrainWidth * 0.45f);
-    std::uniform_real_distribution<float> rockZ(SceneConst::kTerrainDepth * -0.45f, SceneConst::kTerrainDepth * 0.45f);
-
-    std::uniform_real_distribution<float> scaleDist(1.0f, 3.5f);
-    std::uniform_real_distribution<float> rotDist(0.0f, glm::two_pi<float>());
-
-    rockTransforms.reserve(SceneConst::kRockCount);
+    const std::vector<PoissonDisk::Sample> samples = PoissonDisk::Generate(
+        mapSampleParams(SceneConst::kRockSpacing, SceneConst::kRockSeed, 0.1f),
+        [this](float x, float z) { return rockDensity(x, z); });
 
-    int attempts = 0;
-    const int maxAttempts = SceneConst::kRockCount * 80;
-
-    while (rockTransforms.size() < SceneConst::kRockCount && attempts < maxAttempts) {
-        attempts++;
-
-        float x = rockX(rng);
-        float z = rockZ(rng);
-
-        float height = Terrain::getHeight(x, z);
-
-        float distToLake = std::sqrt(x*x + std::pow(z - SceneConst::kLakeCenterZ, 2));
-        if (distToLake < SceneConst::kLakeRadius + 8.0f) continue;
-
-        if (Scene::nearRiver(x, z)) continue;
-        if (height < 1.0f) continue;
-
-        glm::vec3 normal = terrain->getNormal(x, z);
-        float slope = glm::dot(normal, glm::vec3(0, 1, 0));
-        if (slope < 0.25f) continue;
-
-        if (z > 130.0f) continue;
-
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, glm::vec3(x, height + 5.0f, z));
-        model = glm::rotate(model, rotDist(rng), glm::vec3(0.0f, 1.0f, 0.0f));
-
-        float scale = scaleDist(rng);
-        glm::vec3 nonUniform(scale, scale * 1.25f, scale);
-        model = glm::scale(model, nonUniform);
-
-        rockTransforms.push_back(model);
-        rockPositions_.push_back(glm::vec3(x, height + 5.0f, z));
-    }
+    rockTransforms.resize(samples.size());
+    rockPositions_.resize(samples.size());
+    Parallel::ForTiles(static_cast<int>(samples.size()), 1024, [&](int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            const PoissonDisk::Sample& s = samples[i];
+            float x = s.position.x;
+            float z = s.position.y;
+            float height = Terrain::getHeight(x, z);
+
+            float rotation = PoissonDisk::RandomUnit(s.random, 1) * glm::two_pi<float>();
+            float scale = glm::mix(1.0f, 3.5f, PoissonDisk::RandomUnit(s.random, 2));
+
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(x, height + 5.0f, z));
+            model = glm::rotate(model, rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(scale, scale * 1.25f, scale));
+
+            rockTransforms[i] = model;
+            rockPositions_[i] = glm::vec3(x, height + 5.0f, z);
+        }
+    });
 
     // Debug rock in center
     {
@@ -135,3 +175,52 @@ void Scene::generateRocks() {
 
     std::cout << "Generated " << rockTransforms.size() << " rocks." << std::endl;
 }
+
+// ------------------------------------------------------------
+// Resource node index (nearest tree/rock queries)
+// ------------------------------------------------------------
+void Scene::rebuildResourceIndex()
+{
+    const glm::vec2 origin(-Terrain::MapWidth() * 0.5f, -Terrain::MapDepth() * 0.5f);
+    const glm::vec2 extent(static_cast<float>(Terrain::MapWidth()), static_cast<float>(Terrain::MapDepth()));
+    treeIndex_.Build(treePositions_, origin, extent, SceneConst::kResourceCellSize);
+    rockIndex_.Build(rockPositions_, origin, extent, SceneConst::kResourceCellSize);
+}
+
+// ------------------------------------------------------------
+// Vegetation render layers (chunked instances + tree impostor)
+// ------------------------------------------------------------
+void Scene::buildVegetationLayers()
+{
+    ++staticShadowRevision_;
+    const glm::vec2 origin(-Terrain::MapWidth() * 0.5f, -Terrain::MapDepth() * 0.5f);
+    const glm::vec2 extent(static_cast<float>(Terrain::MapWidth()), static_cast<float>(Terrain::MapDepth()));
+
+    if (treeModel)
+        treeLayer_.Build(treeTransforms, treeModel->GetBoundsMin(), treeModel->GetBoundsMax(),
+                         origin, extent, SceneConst::kVegetationChunkSize, treeImpostor_.IsValid());
+    if (rockModel)
+        rockLayer_.Build(rockTransforms, rockModel->GetBoundsMin(), rockModel->GetBoundsMax(),
+                         origin, extent, SceneConst::kVegetationChunkSize, false);
+}
+
+void Scene::bakeTreeImpostor()
+{
+    if (!treeModel)
+        return;
+
+    Shader bakeShader(
+        std::string(ASSET_PATH) + "shaders/impostor_bake.vert",
+        std::string(ASSET_PATH) + "shaders/impostor_bake.frag"
+    );
+    if (treeTex)
+        treeTex->Bind(0);
+    if (!treeImpostor_.Bake(*treeModel, bakeShader, SceneConst::kTreeImpostorResolution))
+        std::cerr << "Tree impostor bake failed; distant trees use full meshes." << std::endl;
+    GLState::DeleteProgram(bakeShader.ID);
+
+    impostorShader_ = new Shader(
+        std::string(ASSET_PATH) + "shaders/impostor.vert",
+        std::string(ASSET_PATH) + "shaders/impostor.frag"
+    );
+}
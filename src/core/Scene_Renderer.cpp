@@ -1,12 +1,180 @@
 #include "Scene.h"
 #include "SceneConstants.h"
 #include <cmath>
-#include <limits>
-#include <glm/gtx/euler_angles.hpp>
 
-static inline glm::vec4 NoClip()
+// ------------------------------------------------------------
+// Shared per-frame uniforms (FrameBlock / LightBlock)
+// Call once per frame before the depth pass; every scene shader
+// reads camera and light state from these blocks.
+// ------------------------------------------------------------
+void Scene::UpdateFrameUniforms(const glm::mat4& view,
+                                const glm::mat4& projection,
+                                const glm::vec3& viewPos,
+                                const ShadowCascades& cascades,
+                                const glm::vec3& lightPos)
 {
-    return glm::vec4(0, 1, 0, 100000.0f);
+    static const glm::vec3 kLightColor(1.0f, 0.97f, 0.92f);
+
+    FrameBlock frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.viewPos = glm::vec4(viewPos, 1.0f);
+
+    LightBlock light;
+    light.cascadeCount = cascades.GetCount();
+    for (int i = 0; i < cascades.GetCount(); ++i)
+    {
+        light.lightSpaceMatrices[i] = cascades.GetMatrix(i);
+        light.cascadeSplits[i] = cascades.GetSplit(i);
+    }
+    light.lightPos = lightPos;
+    light.lightColor = glm::vec4(kLightColor, 1.0f);
+
+    frameUniforms_.Update(frame, light);
+}
+
+// ------------------------------------------------------------
+// Frame setup
+// Everything the snapshot carries that lives in GL objects: tree and
+// rock removals, fog rows and the ranges of the shared bone palette
+// whose CPU pose changed (proxies keep only their offset). Drawing
+// the same snapshot again repeats none of the uploads.
+// ------------------------------------------------------------
+void Scene::BeginFrame(const RenderSnapshot& snapshot)
+{
+    frame_ = &snapshot;
+
+    for (const RenderSnapshot::VegetationRemoval& removal : snapshot.vegetationRemovals)
+    {
+        if (removal.tick <= appliedVegetationTick_)
+            continue;
+        VegetationLayer& layer = removal.rock ? rockLayer_ : treeLayer_;
+        layer.RemoveSwapLast(removal.index, removal.last);
+    }
+    appliedVegetationTick_ = std::max(appliedVegetationTick_, snapshot.tick);
+
+    uploadFogTexture(snapshot);
+
+    bonePalette_.Reserve(static_cast<size_t>(snapshot.paletteSize));
+    for (const RenderSnapshot::PoseUpdate& update : snapshot.poseUpdates)
+    {
+        if (update.tick > appliedPoseTick_)
+            bonePalette_.Write(update.base, snapshot.bones.data() + update.first, update.count);
+    }
+    appliedPoseTick_ = std::max(appliedPoseTick_, snapshot.tick);
+    bonePalette_.Upload();
+
+    proxySkinnedBase_.assign(snapshot.entities.size(), -1);
+}
+
+void Scene::UpdateSkinnedVertices(const glm::mat4& viewProjection,
+                                  const ShadowCascades& cascades)
+{
+    if (!skinningShader_ || !frame_)
+        return;
+    const std::vector<EntityProxy>& proxies = frame_->entities;
+
+    // Union of everything the passes of this frame will draw.
+    preskinUnits_.clear();
+    const int frustumCount = 1 + cascades.GetCount();
+    for (int f = 0; f < frustumCount; ++f)
+    {
+        const glm::mat4& matrix = f == 0 ? viewProjection : cascades.GetMatrix(f - 1);
+        cullEntities(Frustum::FromMatrix(matrix), culledEntities_);
+        for (uint32_t i : culledEntities_)
+        {
+            if (proxies[i].skinned)
+                preskinUnits_.push_back(i);
+        }
+    }
+    std::sort(preskinUnits_.begin(), preskinUnits_.end());
+    preskinUnits_.erase(std::unique(preskinUnits_.begin(), preskinUnits_.end()), preskinUnits_.end());
+
+    skinningPrepass_.Begin();
+    for (uint32_t i : preskinUnits_)
+    {
+        const EntityProxy& proxy = proxies[i];
+        const GLuint bones = proxy.baked ? proxy.model->GetBakedAnimationTexture()
+                                         : bonePalette_.GetTexture();
+        proxySkinnedBase_[i] = skinningPrepass_.Add(proxy.model, bones, proxy.boneBase);
+    }
+    skinningPrepass_.Run(*skinningShader_);
+}
+
+void Scene::cullEntities(const Frustum& frustum, std::vector<uint32_t>& out)
+{
+    out.clear();
+    if (!frame_)
+        return;
+    const std::vector<EntityProxy>& proxies = frame_->entities;
+
+    entityCuller_.Clear();
+    entityCuller_.Reserve(proxies.size());
+    for (const EntityProxy& proxy : proxies)
+    {
+        float radius = proxy.model->GetBoundsRadius();
+        if (proxy.skinned)
+            radius *= SceneConst::kSkinnedBoundsScale;
+        entityCuller_.Add(proxy.transform, proxy.model->GetBoundsCenter(), radius);
+    }
+
+    entityCuller_.Cull(frustum);
+    out.reserve(entityCuller_.GetVisibleCount());
+    for (size_t i = 0; i < proxies.size(); ++i)
+    {
+        if (entityCuller_.IsVisible(i))
+            out.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+// Terrain with its texture set; the shadow map is already on unit 7.
+void Scene::drawTerrain(Shader& terrainShader)
+{
+    terrainShader.Use();
+    terrainShader.SetMat4("model", glm::mat4(1.0f));
+    terrainShader.BindBoneTexture(0, 0);
+
+    grass1Tex->Bind(0);
+    grass2Tex->Bind(1);
+    grass3Tex->Bind(2);
+    noiseTex->Bind(3);
+    rockTex->Bind(4);
+    sandTex->Bind(5);
+    peakTex->Bind(6);
+
+    terrainShader.SetInt("grass1", 0);
+    terrainShader.SetInt("grass2", 1);
+    terrainShader.SetInt("grass3", 2);
+    terrainShader.SetInt("noiseDetail", 3);
+    terrainShader.SetInt("textureRock", 4);
+    terrainShader.SetInt("sandTex", 5);
+    terrainShader.SetInt("texturePeak", 6);
+    terrainShader.SetInt("shadowMap", 7);
+    bindFogOfWar(terrainShader);
+
+    terrain->Draw(terrainShader.ID);
+}
+
+// Shared state of every entity draw (batched and individual).
+void Scene::setupEntityShader(Shader& objectShader)
+{
+    objectShader.Use();
+    objectShader.SetFloat("uAlpha", 1.0f);
+    objectShader.SetBool("isInstanced", false);
+    objectShader.SetBool("useTexture", false); // buildings use uMaterialColor
+    objectShader.SetBool("uUseSkinning", false);
+    objectShader.SetInt("texture_diffuse1", 0);
+    objectShader.SetInt("shadowMap", 7);
+    objectShader.BindBoneTexture(bonePalette_.GetTexture(), 0);
+    objectShader.BindSkinnedVertexTexture(skinningPrepass_.GetTexture());
+    bindFogOfWar(objectShader);
+}
+
+bool Scene::isEntityVisibleToActivePlayer(const GameEntity* entity) const
+{
+    return entity->ownerID <= 0 ||
+           entity->ownerID == activePlayerIndex_ + 1 ||
+           isPositionVisibleToPlayer(entity->position, activePlayerIndex_ + 1);
 }
 
 void Scene::Draw(
@@ -14,353 +182,343 @@ void Scene::Draw(
     Shader& objectShader,
     glm::mat4 view,
     glm::mat4 projection,
-    glm::vec3 lightPos,
     glm::vec3 viewPos,
-    const glm::mat4& lightSpaceMatrix,
     unsigned int shadowMap)
 {
-    lastViewMatrix_ = view;
-    lastProjMatrix_ = projection;
+    if (!frame_)
+        return;
+    const RenderSnapshot& frame = *frame_;
 
     // ------------------------------------------------------------
     // GLOBAL STATE RESET
+    // Blend and cull are per packet (RenderQueue::State) from here on.
     // ------------------------------------------------------------
-    glEnable(GL_DEPTH_TEST);
+    GLState::Enable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
-    glDisable(GL_BLEND);
-
-    glEnable(GL_CULL_FACE);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glCullFace(GL_BACK);
-    glFrontFace(GL_CCW); // keep default, water will disable culling anyway
+    glFrontFace(GL_CCW);
+
+    using Pass = RenderQueue::Pass;
+    const float maxDepth = SceneConst::kRenderQueueMaxDepth;
+    const RenderQueue::State opaque{ false, true };
+    const RenderQueue::State opaqueTwoSided{ false, false };
+    const RenderQueue::State blended{ true, true };
+    const RenderQueue::State blendedTwoSided{ true, false };
 
-    const glm::vec3 lightColor(1.0f, 0.97f, 0.92f);
+    // The shadow map stays on unit 7 for the whole frame.
+    renderQueue_.SetPassSetup(Pass::Opaque, [shadowMap]()
+    {
+        GLState::ActiveTexture(GL_TEXTURE7);
+        GLState::BindTexture(GL_TEXTURE_2D_ARRAY, shadowMap);
+    });
 
     // ============================================================
     // 1) TERRAIN
     // ============================================================
     if (terrain)
     {
-        terrainShader.Use();
-        terrainShader.SetMat4("view", view);
-        terrainShader.SetMat4("projection", projection);
-        terrainShader.SetMat4("model", glm::mat4(1.0f));
-        terrainShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-        terrainShader.SetVec4("uClipPlane", NoClip());
-        terrainShader.BindBoneTexture(0, 0);
-
-        grass1Tex->Bind(0);
-        grass2Tex->Bind(1);
-        grass3Tex->Bind(2);
-        noiseTex->Bind(3);
-        rockTex->Bind(4);
-        sandTex->Bind(5);
-        peakTex->Bind(6);
-
-        glActiveTexture(GL_TEXTURE7);
-        glBindTexture(GL_TEXTURE_2D, shadowMap);
-
-        terrainShader.SetInt("grass1", 0);
-        terrainShader.SetInt("grass2", 1);
-        terrainShader.SetInt("grass3", 2);
-        terrainShader.SetInt("noiseDetail", 3);
-        terrainShader.SetInt("textureRock", 4);
-        terrainShader.SetInt("sandTex", 5);
-        terrainShader.SetInt("texturePeak", 6);
-        terrainShader.SetInt("shadowMap", 7);
-
-        terrainShader.SetVec3("lightPos", lightPos);
-        terrainShader.SetVec3("viewPos", viewPos);
-        terrainShader.SetVec3("lightColor", lightColor);
-
-        terrain->Draw(terrainShader.ID);
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Opaque, terrainShader.ID, 0, 0.0f, maxDepth),
+                            terrainShader.ID, opaque, [this, &terrainShader]()
+        {
+            drawTerrain(terrainShader);
+        });
     }
 
     // ============================================================
     // 2) TREES / ROCKS (INSTANCED)
     // ============================================================
-    bool hasTrees = (treeModel && treeTex && !treeTransforms.empty());
-    bool hasRocks = (rockModel && boulderTex && !rockTransforms.empty());
-    if (hasTrees || hasRocks)
-    {
-        objectShader.Use();
-        objectShader.SetMat4("view", view);
-        objectShader.SetMat4("projection", projection);
-        objectShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-        objectShader.SetVec3("lightPos", lightPos);
-        objectShader.SetVec3("viewPos", viewPos);
-        objectShader.SetVec3("lightColor", lightColor);
-        objectShader.SetVec4("uClipPlane", NoClip());
-        objectShader.SetFloat("uAlpha", 1.0f);
-
-        glActiveTexture(GL_TEXTURE7);
-        glBindTexture(GL_TEXTURE_2D, shadowMap);
-        objectShader.SetInt("shadowMap", 7);
-        objectShader.SetInt("texture_diffuse1", 0);
-
-        // IMPORTANT: set these AFTER Use()
-        objectShader.SetBool("isInstanced", true);
-        objectShader.SetBool("useTexture", true);
-        objectShader.SetVec3("uMaterialColor", glm::vec3(0,1,0));
-        objectShader.SetBool("uUseSkinning", false);
-        objectShader.BindBoneTexture(0, 0);
-    }
-
+    bool hasTrees = (treeModel && treeTex && treeLayer_.GetChunkCount() > 0);
+    bool hasRocks = (rockModel && boulderTex && rockLayer_.GetChunkCount() > 0);
+    treeLayer_.Flush();
+    rockLayer_.Flush();
+
+    const Frustum viewFrustum = Frustum::FromMatrix(projection * view);
+    visibleTrees_.meshes.clear();
+    visibleTrees_.impostors.clear();
+    visibleRocks_.meshes.clear();
+    visibleRocks_.impostors.clear();
     if (hasTrees)
-    {
-        treeTex->Bind(0);
-        treeModel->DrawInstanced(objectShader, treeTransforms);
-    }
+        treeLayer_.Cull(viewFrustum, viewPos, SceneConst::kTreeImpostorDistance, visibleTrees_);
+    if (hasRocks)
+        rockLayer_.Cull(viewFrustum, viewPos, 0.0f, visibleRocks_);
 
+    auto submitVegetation = [&](Model* model, Texture* texture, const VegetationLayer& layer,
+                                const VegetationLayer::VisibleSet& visible)
+    {
+        if (visible.meshes.empty())
+            return;
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Opaque, objectShader.ID, texture->ID, 0.0f, maxDepth),
+                            objectShader.ID, opaque, [this, &objectShader, model, texture, &layer, &visible]()
+        {
+            objectShader.SetFloat("uAlpha", 1.0f);
+            objectShader.SetInt("shadowMap", 7);
+            objectShader.SetInt("texture_diffuse1", 0);
+            bindFogOfWar(objectShader);
+            objectShader.SetBool("isInstanced", true);
+            objectShader.SetBool("useTexture", true);
+            objectShader.SetVec3("uMaterialColor", glm::vec3(0,1,0));
+            objectShader.SetBool("uUseSkinning", false);
+            objectShader.BindBoneTexture(0, 0);
+
+            texture->Bind(0);
+            model->DrawInstancedSpans(objectShader, layer.GetInstanceBuffer(), visible.meshes);
+        });
+    };
+    if (hasTrees)
+        submitVegetation(treeModel, treeTex, treeLayer_, visibleTrees_);
     if (hasRocks)
+        submitVegetation(rockModel, boulderTex, rockLayer_, visibleRocks_);
+
+    // Distant tree chunks as billboards
+    if (!visibleTrees_.impostors.empty() && impostorShader_)
     {
-        boulderTex->Bind(0);
-        rockModel->DrawInstanced(objectShader, rockTransforms);
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Opaque, impostorShader_->ID, 0, 0.0f, maxDepth),
+                            impostorShader_->ID, opaqueTwoSided, [this]()
+        {
+            bindFogOfWar(*impostorShader_);
+            treeImpostor_.Draw(*impostorShader_, treeLayer_.GetImpostorBuffer(), visibleTrees_.impostors);
+        });
     }
 
     // ============================================================
-    // 3) BUILDINGS (NON-INSTANCED)
+    // 3) UNITS / BUILDINGS (batched by model and skinning)
     // ============================================================
-    if (!entities_.empty())
+    const std::vector<EntityProxy>& proxies = frame.entities;
+    if (!proxies.empty())
     {
-        objectShader.Use();
-        objectShader.SetMat4("view", view);
-        objectShader.SetMat4("projection", projection);
-        objectShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-        objectShader.SetVec3("lightPos", lightPos);
-        objectShader.SetVec3("viewPos", viewPos);
-        objectShader.SetVec3("lightColor", lightColor);
-        objectShader.SetVec4("uClipPlane", NoClip());
-        objectShader.SetFloat("uAlpha", 1.0f);
-
-        objectShader.SetBool("isInstanced", false);
-        objectShader.SetBool("useTexture", false); // buildings use uMaterialColor
-        objectShader.SetBool("uUseSkinning", false);
-        objectShader.SetInt("texture_diffuse1", 0);
-        objectShader.BindBoneTexture(0, 0);
-
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-        for (GameEntity* e : entities_)
+        renderQueue_.SetPassSetup(Pass::Entities, [this, &objectShader]()
         {
-            if (!e) continue;
-            if (e->ownerID > 0 &&
-                e->ownerID != activePlayerIndex_ + 1 &&
-                !isPositionVisibleToPlayer(e->position, activePlayerIndex_ + 1))
-                continue;
-            e->Draw(objectShader);   // Building::Draw sets uAlpha
+            setupEntityShader(objectShader);
+        });
+
+        cullEntities(viewFrustum, culledEntities_);
+
+        entityBatcher_.Begin();
+        individualEntities_.clear();
+        for (uint32_t i : culledEntities_)
+        {
+            if (!proxies[i].AppendInstances(entityBatcher_, false, proxySkinnedBase_[i]))
+                individualEntities_.push_back(i);
         }
 
-        glDisable(GL_BLEND);
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Entities, objectShader.ID, 0, 0.0f, maxDepth),
+                            objectShader.ID, blended, [this, &objectShader]()
+        {
+            entityBatcher_.Flush(objectShader, bonePalette_.GetTexture());
+        });
+
+        // Blended one by one: grouped by model, far to near.
+        const GLuint paletteTexture = bonePalette_.GetTexture();
+        for (uint32_t i : individualEntities_)
+        {
+            const EntityProxy& proxy = proxies[i];
+            const int skinnedBase = proxySkinnedBase_[i];
+            const uint32_t material = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(proxy.model) >> 4) | 1u;
+            const float depth = glm::distance(viewPos, proxy.position);
+            renderQueue_.Submit(RenderQueue::MakeKey(Pass::Entities, objectShader.ID, material, depth, maxDepth, true),
+                                objectShader.ID, blended, [&proxy, skinnedBase, paletteTexture, &objectShader]()
+            {
+                proxy.Draw(objectShader, skinnedBase, paletteTexture);
+            });
+        }
     }
 
-    drawSelectionIndicators(view, projection);
+    if (selectionShader && !frame.selection.empty())
+    {
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Overlay, selectionShader->ID, 0, 0.0f, maxDepth),
+                            selectionShader->ID, blendedTwoSided, [this]()
+        {
+            drawSelectionIndicators();
+        });
+    }
+    if (debugShader_ && !frame.debug.Empty())
+    {
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Overlay, debugShader_->ID, 0, 0.0f, maxDepth),
+                            debugShader_->ID, blendedTwoSided, [this]()
+        {
+            drawDebugOverlays();
+        });
+    }
 
     // ============================================================
     // 4) WATER (DISABLE CULLING OR IT VANISHES)
     // ============================================================
-    glDisable(GL_CULL_FACE);
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-
-    DrawWater(view, projection, viewPos);
-    DrawLakeWater(view, projection, viewPos);
-    DrawRiverWater(view, projection, viewPos);
-
-    glEnable(GL_CULL_FACE);
+    if (waterShader)
+    {
+        const uint64_t waterKey = RenderQueue::MakeKey(Pass::Water, waterShader->ID, 0, 0.0f, maxDepth);
+        renderQueue_.Submit(waterKey, waterShader->ID, blendedTwoSided, [this]()
+        {
+            DrawWater();
+        });
+        renderQueue_.Submit(waterKey, waterShader->ID, blendedTwoSided, [this]()
+        {
+            DrawLakeWater();
+        });
+        renderQueue_.Submit(waterKey, waterShader->ID, blendedTwoSided, [this]()
+        {
+            DrawRiverWater();
+        });
+    }
 
     // ============================================================
     // 5) PREVIEW (TRANSPARENT)
     // ============================================================
-    if (buildingManager_.isPlacing() &&
-        buildingManager_.hasPreview() &&
-        buildingManager_.getPreviewModel())
+    if (previewShader && frame.preview.model)
     {
-        glDisable(GL_CULL_FACE);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-        previewShader->Use();
-        previewShader->SetMat4("view", view);
-        previewShader->SetMat4("projection", projection);
-        previewShader->BindBoneTexture(0, 0);
-
-        glm::vec3 previewPos = buildingManager_.getPreviewPos() + buildingManager_.getPreviewOffset();
-        glm::vec3 previewRotation = buildingManager_.getPreviewRotation();
-        float previewScale = buildingManager_.getPreviewScale();
-        glm::mat4 m = glm::translate(glm::mat4(1.0f), previewPos);
-        if (glm::length(previewRotation) > std::numeric_limits<float>::epsilon())
+        renderQueue_.Submit(RenderQueue::MakeKey(Pass::Transparent, previewShader->ID, 0, 0.0f, maxDepth),
+                            previewShader->ID, blendedTwoSided, [this, &frame]()
         {
-            glm::mat4 rot = glm::yawPitchRoll(previewRotation.y, previewRotation.x, previewRotation.z);
-            m *= rot;
-        }
-        m = glm::scale(m, glm::vec3(previewScale));
-        previewShader->SetMat4("model", m);
+            previewShader->BindBoneTexture(0, 0);
+            previewShader->SetMat4("model", frame.preview.transform);
 
-        // Pulse alpha for fade in/out effect
-        float time = (float)glfwGetTime();
-        float alpha = 0.4f + 0.2f * sin(time * 2.0f); // slower pulse for longer fade
+            // Pulse alpha for fade in/out effect
+            float time = (float)glfwGetTime();
+            float alpha = 0.4f + 0.2f * sin(time * 2.0f); // slower pulse for longer fade
 
-        glm::vec4 tint = buildingManager_.isValidPlacement()
-            ? glm::vec4(0.1f, 1.0f, 0.1f, alpha)
-            : glm::vec4(1.0f, 0.1f, 0.1f, alpha);
+            glm::vec4 tint = frame.preview.valid
+                ? glm::vec4(0.1f, 1.0f, 0.1f, alpha)
+                : glm::vec4(1.0f, 0.1f, 0.1f, alpha);
 
-        // Your preview.frag uses "uTint" or "tint"? Make it match.
-        previewShader->SetVec4("uTint", tint);
+            // Your preview.frag uses "uTint" or "tint"? Make it match.
+            previewShader->SetVec4("uTint", tint);
 
-        buildingManager_.getPreviewModel()->Draw(*previewShader);
-
-        glDisable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+            frame.preview.model->Draw(*previewShader);
+        });
     }
 
-    if (!isFogRevealed())
-        DrawFogOfWar(view, projection);
+    const size_t packetCount = renderQueue_.GetPacketCount();
+    renderQueue_.Execute();
+    GLState::Disable(GL_BLEND);
+    GLState::Enable(GL_CULL_FACE);
 
     // ============================================================
     // 6) UI LAST
     // ============================================================
-    glDisable(GL_DEPTH_TEST);
-    uiManager_.render();
-    glEnable(GL_DEPTH_TEST);
+    GLState::Disable(GL_DEPTH_TEST);
+    uiRenderer_.draw(frame.ui);
+    GLState::Enable(GL_DEPTH_TEST);
+
+    reportRenderStats(packetCount);
 }
 
-void Scene::drawSelectionIndicators(const glm::mat4& view, const glm::mat4& projection)
+// Once a second while a debug overlay is on: GL state calls this
+// frame that GLState forwarded vs dropped as redundant.
+void Scene::reportRenderStats(size_t packetCount)
 {
-    if (!selectionShader || !selectionRingTex || selectionCircleVAO == 0 || selectedUnits_.empty())
+    if (!frame_ || frame_->debugOverlays == 0)
         return;
+    const double now = glfwGetTime();
+    if (now - lastRenderStatsTime_ < 1.0)
+        return;
+    lastRenderStatsTime_ = now;
 
-    glDisable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    selectionShader->Use();
-    selectionShader->SetMat4("view", view);
-    selectionShader->SetMat4("projection", projection);
-    selectionRingTex->Bind(0);
-    selectionShader->SetInt("uTexture", 0);
-    selectionShader->SetVec4("uTint", glm::vec4(1.0f));
+    const GLState::Stats& stats = GLState::GetStats();
+    std::cout << "[Render] " << packetCount << " packets, state calls issued "
+              << stats.issued << ", skipped " << stats.skipped << std::endl;
+}
 
-    glBindVertexArray(selectionCircleVAO);
+void Scene::drawSelectionIndicators()
+{
+    if (!selectionShader || !selectionRingTex || !frame_ || frame_->selection.empty())
+        return;
 
-    for (Unit* unit : selectedUnits_)
+    selectionRings_.Begin();
+    for (const RenderSnapshot::SelectionMarker& marker : frame_->selection)
     {
-        if (!unit) continue;
-
-        glm::mat4 model = glm::mat4(1.0f);
-        glm::vec3 pos = unit->position;
-        pos.y += 0.6f;
-        model = glm::translate(model, pos);
-        model = glm::scale(model, glm::vec3(6.0f, 1.0f, 6.0f));
-
-        selectionShader->SetMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glm::vec3 pos = marker.position;
+        pos.y += SceneConst::kSelectionRingLift;
+        selectionRings_.Add(pos, SceneConst::kSelectionRingRadius, glm::vec4(1.0f), marker.healthFill);
     }
 
-    glBindVertexArray(0);
-    glDisable(GL_BLEND);
-    glEnable(GL_CULL_FACE);
+    selectionRings_.Draw(*selectionShader, selectionRingTex->ID,
+                         SceneConst::kHealthBarLift,
+                         glm::vec2(SceneConst::kHealthBarHalfWidth, SceneConst::kHealthBarHalfHeight));
 }
 
-void Scene::rebuildFogMeshForPlayer(int playerId)
+void Scene::drawDebugOverlays()
 {
-    fogVertexBuffer_.clear();
-    fogVertexCount_ = 0;
-
-    if (playerId < 1 || playerId > 2)
-        return;
-    if (navGridCols_ <= 0 || navGridRows_ <= 0)
+    if (!debugShader_ || !frame_)
         return;
+    debugDraw_.Draw(*debugShader_, frame_->debug);
+}
 
-    const auto& fog = fogStates_[playerId - 1];
-    if (fog.empty() || fogVAO_ == 0 || fogVBO_ == 0)
+// ------------------------------------------------------------
+// Fog of war texture
+// One R8 texel per nav cell holding the light factor of its state
+// (unexplored / explored / visible); lit shaders sample it with
+// bilinear filtering, so cell edges blend instead of stepping.
+// ------------------------------------------------------------
+void Scene::uploadFogTexture(const RenderSnapshot& snapshot)
+{
+    const size_t cols = static_cast<size_t>(std::max(snapshot.fogCols, 0));
+    const size_t rows = static_cast<size_t>(std::max(snapshot.fogRows, 0));
+    if (cols == 0 || rows == 0 || snapshot.fog.size() < cols * rows || snapshot.fogRowTicks.size() < rows)
         return;
 
-    const size_t cellCount = static_cast<size_t>(navGridCols_) * static_cast<size_t>(navGridRows_);
-    if (fog.size() < cellCount)
-        return;
+    bool allRows = false;
+    if (fogTexture_ == 0 || fogTextureCols_ != snapshot.fogCols || fogTextureRows_ != snapshot.fogRows)
+    {
+        if (fogTexture_)
+            GLState::DeleteTextures(1, &fogTexture_);
+        glGenTextures(1, &fogTexture_);
+        GLState::BindTexture(GL_TEXTURE_2D, fogTexture_);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, snapshot.fogCols, snapshot.fogRows, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        fogTextureCols_ = snapshot.fogCols;
+        fogTextureRows_ = snapshot.fogRows;
+        allRows = true;
+    }
 
-    fogVertexBuffer_.reserve(cellCount * 6 * 7);
-    const float half = navCellSize_ * 0.5f;
-    const float pad = navCellSize_ * 0.08f;
+    // 0 = black, 1 = the old 35% overlay, 2 = clear
+    static const uint8_t kLight[3] = { 0, 166, 255 };
 
-    auto pushVertex = [&](const glm::vec3& p, const glm::vec4& c)
-    {
-        fogVertexBuffer_.push_back(p.x);
-        fogVertexBuffer_.push_back(p.y);
-        fogVertexBuffer_.push_back(p.z);
-        fogVertexBuffer_.push_back(c.r);
-        fogVertexBuffer_.push_back(c.g);
-        fogVertexBuffer_.push_back(c.b);
-        fogVertexBuffer_.push_back(c.a);
-    };
+    const std::vector<uint64_t>& rowTicks = snapshot.fogRowTicks;
+    auto changed = [&](size_t row) { return allRows || rowTicks[row] > fogUploadTick_; };
 
-    for (int row = 0; row < navGridRows_; ++row)
+    GLState::BindTexture(GL_TEXTURE_2D, fogTexture_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    size_t row = 0;
+    while (row < rows)
     {
-        for (int col = 0; col < navGridCols_; ++col)
+        if (!changed(row))
         {
-            size_t idx = static_cast<size_t>(row) * static_cast<size_t>(navGridCols_) + static_cast<size_t>(col);
-            uint8_t state = fog[idx];
-            if (state == 2)
-                continue;
-
-            glm::vec3 center = navToWorld(col, row);
-            float y = fogPlaneY_;
-            glm::vec3 p0(center.x - half - pad, y, center.z - half - pad);
-            glm::vec3 p1(center.x + half + pad, y, center.z - half - pad);
-            glm::vec3 p2(center.x + half + pad, y, center.z + half + pad);
-            glm::vec3 p3(center.x - half - pad, y, center.z + half + pad);
-
-            glm::vec4 color = (state == 0)
-                ? glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)
-                : glm::vec4(0.0f, 0.0f, 0.0f, 0.35f);
-
-            pushVertex(p0, color);
-            pushVertex(p1, color);
-            pushVertex(p2, color);
-
-            pushVertex(p0, color);
-            pushVertex(p2, color);
-            pushVertex(p3, color);
+            ++row;
+            continue;
         }
+        // One glTexSubImage2D per run of consecutive changed rows
+        size_t end = row;
+        while (end < rows && changed(end))
+            ++end;
+
+        fogTexels_.resize((end - row) * cols);
+        for (size_t i = 0; i < fogTexels_.size(); ++i)
+            fogTexels_[i] = kLight[std::min<uint8_t>(snapshot.fog[row * cols + i], 2)];
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(row),
+                        snapshot.fogCols, static_cast<GLsizei>(end - row),
+                        GL_RED, GL_UNSIGNED_BYTE, fogTexels_.data());
+        row = end;
     }
-
-    fogVertexCount_ = fogVertexBuffer_.size() / 7;
-    glBindBuffer(GL_ARRAY_BUFFER, fogVBO_);
-    glBufferData(GL_ARRAY_BUFFER,
-                 fogVertexBuffer_.size() * sizeof(float),
-                 fogVertexBuffer_.data(),
-                 GL_DYNAMIC_DRAW);
-    fogDirty_ = false;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    GLState::BindTexture(GL_TEXTURE_2D, 0);
+    fogUploadTick_ = std::max(fogUploadTick_, snapshot.tick);
 }
 
-void Scene::DrawFogOfWar(const glm::mat4& view, const glm::mat4& projection)
+void Scene::bindFogOfWar(Shader& shader) const
 {
-    if (isFogRevealed())
-        return;
-    if (!fogShader || fogVAO_ == 0 || fogVBO_ == 0)
+    const bool enabled = fogTexture_ != 0 && frame_ && !frame_->fogRevealed;
+    shader.SetBool("uFogEnabled", enabled);
+    if (!enabled)
         return;
 
-    if (fogDirty_)
-        rebuildFogMeshForPlayer(activePlayerIndex_ + 1);
-
-    if (fogVertexCount_ == 0)
-        return;
-
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    fogShader->Use();
-    fogShader->SetMat4("view", view);
-    fogShader->SetMat4("projection", projection);
-
-    glBindVertexArray(fogVAO_);
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(fogVertexCount_));
-    glBindVertexArray(0);
-
-    glDisable(GL_BLEND);
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_DEPTH_TEST);
+    GLState::ActiveTexture(GL_TEXTURE8);
+    GLState::BindTexture(GL_TEXTURE_2D, fogTexture_);
+    shader.SetInt("uFogTexture", 8);
+    shader.SetVec2("uFogOrigin", navOrigin_);
+    shader.SetVec2("uFogInvSize", glm::vec2(1.0f / (navCellSize_ * static_cast<float>(fogTextureCols_)),
+                                            1.0f / (navCellSize_ * static_cast<float>(fogTextureRows_))));
+    GLState::ActiveTexture(GL_TEXTURE0);
 }
@@ -0,0 +1,251 @@
+#include "Scene.h"
+#include "SceneConstants.h"
+#include <limits>
+#include <glm/gtx/euler_angles.hpp>
+
+// ------------------------------------------------------------
+// Render snapshot
+// The hand-off from the simulation to the GL thread: a copy of the
+// tick's camera, visible entities, fog, selection, placement preview,
+// debug overlays and HUD. Runs at the end of every tick.
+// ------------------------------------------------------------
+void Scene::WriteRenderSnapshot(RenderSnapshot& out, uint64_t consumedTick)
+{
+    out.tick = ++snapshotTick_;
+
+    // ---- Camera ----
+    if (camera)
+    {
+        lastViewMatrix_ = camera->GetViewMatrix();
+        lastProjMatrix_ = cameraProjection();
+        out.viewPos = camera->Position;
+    }
+    out.view = lastViewMatrix_;
+    out.projection = lastProjMatrix_;
+
+    // ---- Entities and their skinning poses ----
+    out.entities.clear();
+    out.poseUpdates.clear();
+    out.bones.clear();
+    for (const GameEntity* e : entities_)
+    {
+        if (!e || !e->model || !isEntityVisibleToActivePlayer(e))
+            continue;
+        out.entities.emplace_back();
+        EntityProxy& proxy = out.entities.back();
+        e->WriteRenderProxy(proxy);
+
+        const Unit* unit = dynamic_cast<const Unit*>(e);
+        if (unit && unit->HasCpuPose())
+            proxy.boneBase = writeUnitPose(*unit, out, consumedTick);
+    }
+    // Units that died or went out of sight give their range back.
+    for (auto it = poseSlots_.begin(); it != poseSlots_.end();)
+    {
+        if (it->second.seenTick == out.tick)
+        {
+            ++it;
+            continue;
+        }
+        freePoseRanges_.emplace_back(it->second.base, it->second.count);
+        it = poseSlots_.erase(it);
+    }
+    out.paletteSize = paletteSize_;
+    out.staticShadowKey = ComputeStaticShadowKey();
+
+    // ---- Vegetation removals the GL thread has not seen yet ----
+    pendingVegetationRemovals_.erase(
+        std::remove_if(pendingVegetationRemovals_.begin(), pendingVegetationRemovals_.end(),
+                       [consumedTick](const RenderSnapshot::VegetationRemoval& removal)
+                       { return removal.tick <= consumedTick; }),
+        pendingVegetationRemovals_.end());
+    out.vegetationRemovals = pendingVegetationRemovals_;
+
+    // ---- Fog of war (active player) ----
+    const int player = activePlayerIndex_;
+    const size_t rows = static_cast<size_t>(std::max(navGridRows_, 0));
+    if (fogRowTicks_.size() != rows)
+    {
+        fogRowTicks_.assign(rows, out.tick);
+        fogDirty_ = false;
+    }
+    if (player >= 0 && player <= 1)
+    {
+        const std::vector<uint8_t>& dirtyRows = fogDirtyRows_[player];
+        for (size_t row = 0; row < rows; ++row)
+        {
+            if (fogDirty_ || (row < dirtyRows.size() && dirtyRows[row]))
+                fogRowTicks_[row] = out.tick;
+        }
+        out.fog = fogStates_[player];
+    }
+    else
+    {
+        out.fog.clear();
+    }
+    for (auto& dirtyRows : fogDirtyRows_)
+        std::fill(dirtyRows.begin(), dirtyRows.end(), 0);
+    fogDirty_ = false;
+    out.fogCols = navGridCols_;
+    out.fogRows = navGridRows_;
+    out.fogRowTicks = fogRowTicks_;
+    out.fogRevealed = fogRevealOverride_;
+
+    // ---- Selection rings ----
+    out.selection.clear();
+    for (const Unit* unit : selectedUnits_)
+    {
+        if (!unit)
+            continue;
+        const float maxHp = unit->GetMaxHealth();
+        out.selection.push_back({ unit->position, maxHp > 0.0f ? unit->GetHealth() / maxHp : -1.0f });
+    }
+
+    // ---- Building placement preview ----
+    out.preview = RenderSnapshot::PlacementPreview();
+    if (buildingManager_.isPlacing() &&
+        buildingManager_.hasPreview() &&
+        buildingManager_.getPreviewModel())
+    {
+        glm::vec3 previewPos = buildingManager_.getPreviewPos() + buildingManager_.getPreviewOffset();
+        glm::vec3 previewRotation = buildingManager_.getPreviewRotation();
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), previewPos);
+        if (glm::length(previewRotation) > std::numeric_limits<float>::epsilon())
+            m *= glm::yawPitchRoll(previewRotation.y, previewRotation.x, previewRotation.z);
+        m = glm::scale(m, glm::vec3(buildingManager_.getPreviewScale()));
+
+        out.preview.model = buildingManager_.getPreviewModel();
+        out.preview.transform = m;
+        out.preview.valid = buildingManager_.isValidPlacement();
+    }
+
+    // ---- Debug overlays and HUD ----
+    out.debugOverlays = debugOverlays_;
+    out.debug.Clear();
+    buildDebugOverlays(out.debug);
+
+    uiManager_.build(out.ui);
+}
+
+int Scene::writeUnitPose(const Unit& unit, RenderSnapshot& out, uint64_t consumedTick)
+{
+    // Ids are never reused, unlike the addresses of dead units.
+    const int id = unit.GetNetworkId();
+    if (id <= 0)
+        return -1;
+    const std::vector<glm::mat4>& pose = unit.GetBoneMatrices();
+    const int count = static_cast<int>(pose.size());
+
+    auto it = poseSlots_.find(id);
+    if (it != poseSlots_.end() && it->second.count != count)
+    {
+        freePoseRanges_.emplace_back(it->second.base, it->second.count);
+        poseSlots_.erase(it);
+        it = poseSlots_.end();
+    }
+    if (it == poseSlots_.end())
+    {
+        PoseSlot slot;
+        slot.count = count;
+        slot.revision = unit.GetPoseRevision() + 1;     // forces the first send
+        auto range = std::find_if(freePoseRanges_.begin(), freePoseRanges_.end(),
+                                  [count](const std::pair<int, int>& r) { return r.second == count; });
+        if (range != freePoseRanges_.end())
+        {
+            slot.base = range->first;
+            freePoseRanges_.erase(range);
+        }
+        else
+        {
+            slot.base = paletteSize_;
+            paletteSize_ += count;
+        }
+        it = poseSlots_.emplace(id, slot).first;
+    }
+
+    PoseSlot& slot = it->second;
+    slot.seenTick = out.tick;
+    if (slot.revision != unit.GetPoseRevision())
+    {
+        slot.revision = unit.GetPoseRevision();
+        slot.tick = out.tick;
+    }
+    if (slot.tick > consumedTick)
+    {
+        out.poseUpdates.push_back({ slot.tick, slot.base, count, static_cast<uint32_t>(out.bones.size()) });
+        out.bones.insert(out.bones.end(), pose.begin(), pose.end());
+    }
+    return slot.base;
+}
+
+void Scene::buildDebugOverlays(DebugGeometry& out) const
+{
+    if (debugOverlays_ == 0 || navGridCols_ <= 0 || navGridRows_ <= 0)
+        return;
+
+    const float half = navCellSize_ * 0.5f;
+    const glm::vec3 lift(0.0f, SceneConst::kDebugOverlayLift, 0.0f);
+
+    if (debugOverlays_ & DebugOverlayNavGrid)
+    {
+        const glm::vec4 blocked(0.9f, 0.15f, 0.1f, 0.35f);
+        const glm::vec4 water(0.1f, 0.35f, 0.9f, 0.25f);
+        for (int row = 0; row < navGridRows_; ++row)
+        {
+            for (int col = 0; col < navGridCols_; ++col)
+            {
+                const size_t idx = static_cast<size_t>(row) * static_cast<size_t>(navGridCols_) + static_cast<size_t>(col);
+                if (idx >= navWalkable_.size() || navWalkable_[idx])
+                    continue;
+                const bool isWater = idx < navStaticWater_.size() && navStaticWater_[idx];
+                out.Cell(navToWorld(col, row) + lift, half, isWater ? water : blocked);
+            }
+        }
+    }
+
+    if (debugOverlays_ & DebugOverlayPaths)
+    {
+        const glm::vec4 pathColor(1.0f, 0.85f, 0.2f, 0.9f);
+        for (const GameEntity* e : entities_)
+        {
+            const Unit* unit = dynamic_cast<const Unit*>(e);
+            if (!unit || !unit->IsFollowingPath())
+                continue;
+            const std::vector<glm::vec3>& path = unit->GetPath();
+            glm::vec3 prev = unit->position + lift;
+            for (size_t i = unit->GetPathCursor(); i < path.size(); ++i)
+            {
+                const glm::vec3 next = path[i] + lift;
+                out.Line(prev, next, pathColor);
+                prev = next;
+            }
+            out.Circle(prev, half, pathColor, 12);
+        }
+    }
+
+    if (debugOverlays_ & DebugOverlayFog)
+    {
+        const int player = activePlayerIndex_;
+        const auto& fog = fogStates_[player];
+        const glm::vec4 visible(0.2f, 0.9f, 0.3f, 0.2f);
+        const glm::vec4 explored(0.9f, 0.8f, 0.2f, 0.12f);
+        for (int row = 0; row < navGridRows_; ++row)
+        {
+            for (int col = 0; col < navGridCols_; ++col)
+            {
+                const size_t idx = static_cast<size_t>(row) * static_cast<size_t>(navGridCols_) + static_cast<size_t>(col);
+                if (idx >= fog.size() || fog[idx] == 0)
+                    continue;
+                out.Cell(navToWorld(col, row) + lift, half, fog[idx] == 2 ? visible : explored);
+            }
+        }
+
+        const glm::vec4 vision(0.3f, 1.0f, 0.4f, 0.8f);
+        for (const GameEntity* e : entities_)
+        {
+            if (!e || e->ownerID != player + 1)
+                continue;
+            out.Circle(e->position + lift, visibilityRadiusForEntity(e), vision, 32);
+        }
+    }
+}
@@ -195,6 +195,9 @@ void Scene::updateResourceTexts()
     };
 
     const Resources& res = activePlayer();
+    shownResourceRevision_ = res.revision;
+    shownResourcePlayer_ = activePlayerIndex_;
+    uiDirty_ &= ~UIDirtyResources;
 
     setVal(foodLabelIndex_, formatResource(res.food, res.foodCapacity));
     setVal(woodLabelIndex_, formatResource(res.wood, res.woodCapacity));
@@ -210,6 +213,30 @@ void Scene::updateResourceTexts()
     }
 }
 
+void Scene::refreshDirtyUI()
+{
+    if (activePlayer().revision != shownResourceRevision_ ||
+        activePlayerIndex_ != shownResourcePlayer_)
+        uiDirty_ |= UIDirtyResources;
+
+    Unit* infoUnit = selectedUnits_.empty() ? nullptr : selectedUnits_.front();
+    if (infoUnit != unitInfoTarget_)
+        uiDirty_ |= UIDirtyUnitInfo;
+
+    if (selectedBuilding_ != productionPanelBuilding_ ||
+        (selectedBuilding_ && selectedBuilding_->isUnderConstruction != productionPanelConstructing_))
+        uiDirty_ |= UIDirtyProduction;
+
+    if (uiDirty_ & UIDirtyResources)
+        updateResourceTexts();
+    if (uiDirty_ & UIDirtyUnitList)
+        refreshUnitListUI();
+    if (uiDirty_ & UIDirtyProduction)
+        updateProductionPanel();
+    if (uiDirty_ & UIDirtyUnitInfo)
+        updateUnitInfoPanel();
+}
+
 void Scene::setupTabButtons()
 {
     const glm::vec2 tabSize(150.0f, 40.0f);
@@ -508,6 +535,7 @@ void Scene::setActiveTab(UITab tab)
 
 void Scene::refreshUnitListUI()
 {
+    uiDirty_ &= ~UIDirtyUnitList;
     bool show = (currentTab_ == UITab::Units);
     if (!show)
     {
@@ -613,6 +641,10 @@ void Scene::selectUnitFromList(size_t entryIndex)
 
 void Scene::updateProductionPanel()
 {
+    uiDirty_ &= ~UIDirtyProduction;
+    productionPanelBuilding_ = selectedBuilding_;
+    productionPanelConstructing_ = selectedBuilding_ && selectedBuilding_->isUnderConstruction;
+
     bool hasBuilding = (selectedBuilding_ != nullptr);
     uiManager_.setButtonVisibility(productionPanelBackgroundIndex_, hasBuilding);
     if (!hasBuilding)
@@ -693,6 +725,7 @@ bool Scene::handleProductionRequest(EntityType unitType)
 
 void Scene::updateUnitInfoPanel()
 {
+    uiDirty_ &= ~UIDirtyUnitInfo;
     Unit* unit = selectedUnits_.empty() ? nullptr : selectedUnits_.front();
     unitInfoTarget_ = unit;
     bool show = (unit != nullptr);
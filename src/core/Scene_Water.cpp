@@ -7,7 +7,7 @@
 static void makeColorAttachment(GLuint& tex, int w, int h)
 {
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    GLState::BindTexture(GL_TEXTURE_2D, tex);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -18,7 +18,7 @@ static void makeColorAttachment(GLuint& tex, int w, int h)
 static void makeDepthTexture(GLuint& tex, int w, int h)
 {
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    GLState::BindTexture(GL_TEXTURE_2D, tex);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, w, h, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -26,8 +26,24 @@ static void makeDepthTexture(GLuint& tex, int w, int h)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
 
-bool Scene::nearRiver(float x, float z) const
+// Water meshes are authored in layout space; stretch them to the map.
+template <typename VertexT>
+static void layoutToWorld(std::vector<VertexT>& verts)
 {
+    for (VertexT& v : verts)
+    {
+        glm::vec2 world = Terrain::FromLayout(v.position.x, v.position.z);
+        v.position.x = world.x;
+        v.position.z = world.y;
+    }
+}
+
+bool Scene::nearRiver(float worldX, float worldZ) const
+{
+    const glm::vec2 layout = Terrain::ToLayout(worldX, worldZ);
+    const float x = layout.x;
+    const float z = layout.y;
+
     const float lakeZ       = SceneConst::kLakeCenterZ; 
     const float riverStartZ = lakeZ - 15.0f;
     const float riverEndZ   = 280.0f;
@@ -66,9 +82,10 @@ bool Scene::isWaterAt(float x, float z, float y) const
     if (y < oceanY + 0.05f)
         return true;
 
-    // Lake (circle check)
-    float dx = x;
-    float dz = z - SceneConst::kLakeCenterZ;
+    // Lake (circle check, layout space)
+    glm::vec2 layout = Terrain::ToLayout(x, z);
+    float dx = layout.x;
+    float dz = layout.y - SceneConst::kLakeCenterZ;
     float distSq = dx*dx + dz*dz;
 
     if (distSq < SceneConst::kLakeRadius * SceneConst::kLakeRadius &&
@@ -86,12 +103,19 @@ bool Scene::isWaterArea(float x, float z) const
 {
     if (pointOnBridge(x, z))
         return false;
+    return isStaticWater(x, z);
+}
+
+// Water from the generated world only (ignores bridges)
+bool Scene::isStaticWater(float x, float z) const
+{
     float terrainY = Terrain::getHeight(x, z);
     if (terrainY < oceanY + 0.05f)
         return true;
 
-    float dx = x;
-    float dz = z - SceneConst::kLakeCenterZ;
+    glm::vec2 layout = Terrain::ToLayout(x, z);
+    float dx = layout.x;
+    float dz = layout.y - SceneConst::kLakeCenterZ;
     float distSq = dx * dx + dz * dz;
     if (distSq < (SceneConst::kLakeRadius + 2.0f) * (SceneConst::kLakeRadius + 2.0f) &&
         terrainY < lakeY + 0.2f)
@@ -103,13 +127,29 @@ bool Scene::isWaterArea(float x, float z) const
     return false;
 }
 
+// ------------------------------------------------------------
+// Shoreline distance field
+// Baked from the static water mask; bridges are handled by
+// isWaterArea() at query time.
+// ------------------------------------------------------------
+void Scene::buildShoreField()
+{
+    const float cellSize = SceneConst::kShoreCellSize;
+    const int cols = static_cast<int>(Terrain::MapWidth() / cellSize);
+    const int rows = static_cast<int>(Terrain::MapDepth() / cellSize);
+    const glm::vec2 origin(-Terrain::MapWidth() * 0.5f, -Terrain::MapDepth() * 0.5f);
+
+    shoreField_.Build(cols, rows, cellSize, origin,
+                      [this](float x, float z) { return isStaticWater(x, z); });
+    shoreField_.Upload();
+}
+
 
 // ------------------------------------------------------------
 // Render targets init / destroy
 // ------------------------------------------------------------
 void Scene::initWaterRenderTargets(int w, int h)
 {
-    // scale down if you want performance (e.g. /2)
     waterRTWidth  = w;
     waterRTHeight = h;
 
@@ -147,22 +187,25 @@ void Scene::initWaterRenderTargets(int w, int h)
 void Scene::destroyWaterRenderTargets()
 {
     if (reflectionDepthRBO) glDeleteRenderbuffers(1, &reflectionDepthRBO);
-    if (reflectionColorTex) glDeleteTextures(1, &reflectionColorTex);
+    if (reflectionColorTex) GLState::DeleteTextures(1, &reflectionColorTex);
     if (reflectionFBO)      glDeleteFramebuffers(1, &reflectionFBO);
 
-    if (refractionDepthTex) glDeleteTextures(1, &refractionDepthTex);
-    if (refractionColorTex) glDeleteTextures(1, &refractionColorTex);
+    if (refractionDepthTex) GLState::DeleteTextures(1, &refractionDepthTex);
+    if (refractionColorTex) GLState::DeleteTextures(1, &refractionColorTex);
     if (refractionFBO)      glDeleteFramebuffers(1, &refractionFBO);
 
     reflectionDepthRBO = reflectionColorTex = reflectionFBO = 0;
     refractionDepthTex = refractionColorTex = refractionFBO = 0;
 }
 
+// Framebuffer size; the targets are allocated at 1/waterTargetDivisor_.
 void Scene::Resize(int fbW, int fbH)
 {
     if (fbW <= 0 || fbH <= 0) return;
     destroyWaterRenderTargets();
-    initWaterRenderTargets(fbW, fbH);
+    initWaterRenderTargets(std::max(fbW / waterTargetDivisor_, 1),
+                           std::max(fbH / waterTargetDivisor_, 1));
+    waterFramesUntilUpdate_ = 0;
 }
 
 // ------------------------------------------------------------
@@ -172,6 +215,7 @@ void Scene::beginReflectionPass(int w, int h)
 {
     glBindFramebuffer(GL_FRAMEBUFFER, reflectionFBO);
     glViewport(0, 0, w, h);
+    glClearColor(0.5f, 0.7f, 1.0f, 1.0f);      // sky, as in the main pass
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
@@ -179,6 +223,7 @@ void Scene::beginRefractionPass(int w, int h)
 {
     glBindFramebuffer(GL_FRAMEBUFFER, refractionFBO);
     glViewport(0, 0, w, h);
+    glClearColor(0.05f, 0.15f, 0.35f, 1.0f);   // deep water
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
@@ -188,13 +233,123 @@ void Scene::endWaterPass(int w, int h)
     glViewport(0, 0, w, h);
 }
 
+// ------------------------------------------------------------
+// Reflection / refraction passes
+// Only terrain and finished buildings (units, trees and rocks are
+// too small to read in a distorted, reduced-size target), at
+// 1/waterTargetDivisor_ resolution and every waterUpdateInterval_-th
+// frame. The water shaders project into each target with the camera
+// it was rendered with, so a target a frame or two old still lines
+// up with the world; it just lags camera motion slightly.
+//
+// One reflection plane for all water: the ocean, which covers most
+// of the screen. Lake and river reuse it; their offset is hidden
+// by the wave distortion. Refraction keeps everything below the
+// highest water level.
+// ------------------------------------------------------------
+void Scene::SetWaterQuality(int resolutionDivisor, int updateInterval)
+{
+    waterTargetDivisor_ = std::max(resolutionDivisor, 1);
+    waterUpdateInterval_ = std::max(updateInterval, 1);
+    waterFramesUntilUpdate_ = 0;
+}
+
+void Scene::DrawWaterTargets(Shader& terrainShader,
+                             Shader& objectShader,
+                             int fbW, int fbH,
+                             unsigned int shadowMap)
+{
+    if (!frame_ || !terrain || fbW <= 0 || fbH <= 0)
+        return;
+
+    if (waterRTWidth != std::max(fbW / waterTargetDivisor_, 1) ||
+        waterRTHeight != std::max(fbH / waterTargetDivisor_, 1))
+        Resize(fbW, fbH);
+    if (waterFramesUntilUpdate_-- > 0)
+        return;
+    waterFramesUntilUpdate_ = waterUpdateInterval_ - 1;
+
+    const FrameBlock mainFrame = frameUniforms_.GetFrame();
+    const float bias = SceneConst::kWaterClipBias;
+
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::DepthMask(GL_TRUE);
+    GLState::Disable(GL_BLEND);
+    GLState::Enable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    GLState::Enable(GL_CLIP_DISTANCE0);
+    GLState::ActiveTexture(GL_TEXTURE7);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, shadowMap);
+
+    // ---- Reflection: camera mirrored about the ocean plane ----
+    glm::mat4 mirror(1.0f);
+    mirror[1][1] = -1.0f;
+    mirror[3][1] = 2.0f * oceanY;
+
+    FrameBlock pass = mainFrame;
+    pass.view = frame_->view * mirror;
+    pass.viewPos.y = 2.0f * oceanY - pass.viewPos.y;
+    pass.clipPlane = glm::vec4(0.0f, 1.0f, 0.0f, -(oceanY - bias));
+    reflectionViewProj_ = frame_->projection * pass.view;
+    frameUniforms_.UpdateFrame(pass);
+
+    beginReflectionPass(waterRTWidth, waterRTHeight);
+    glFrontFace(GL_CW);     // the mirror flips winding
+    drawWaterPassGeometry(terrainShader, objectShader, reflectionViewProj_, pass.clipPlane);
+    glFrontFace(GL_CCW);
+
+    // ---- Refraction: main camera, below the water ----
+    const float surfaceY = std::max(oceanY, std::max(lakeY, riverY));
+    pass = mainFrame;
+    pass.clipPlane = glm::vec4(0.0f, -1.0f, 0.0f, surfaceY + bias);
+    refractionViewProj_ = frame_->projection * frame_->view;
+    frameUniforms_.UpdateFrame(pass);
+
+    beginRefractionPass(waterRTWidth, waterRTHeight);
+    drawWaterPassGeometry(terrainShader, objectShader, refractionViewProj_, pass.clipPlane);
+
+    endWaterPass(fbW, fbH);
+    GLState::Disable(GL_CLIP_DISTANCE0);
+    frameUniforms_.UpdateFrame(mainFrame);
+}
+
+void Scene::drawWaterPassGeometry(Shader& terrainShader, Shader& objectShader,
+                                  const glm::mat4& viewProj, const glm::vec4& clipPlane)
+{
+    drawTerrain(terrainShader);
+
+    // The side planes already reject everything behind the eye, so the
+    // near plane is traded for the clip plane: buildings entirely on
+    // the clipped side are never submitted.
+    Frustum frustum = Frustum::FromMatrix(viewProj);
+    frustum.planes[4] = clipPlane;
+    cullEntities(frustum, culledEntities_);
+
+    const std::vector<EntityProxy>& proxies = frame_->entities;
+    entityBatcher_.Begin();
+    individualEntities_.clear();
+    for (uint32_t i : culledEntities_)
+    {
+        if (!proxies[i].IsStaticShadowCaster())
+            continue;
+        if (!proxies[i].AppendInstances(entityBatcher_, false, -1))
+            individualEntities_.push_back(i);
+    }
+
+    setupEntityShader(objectShader);
+    entityBatcher_.Flush(objectShader, bonePalette_.GetTexture());
+    objectShader.SetBool("isInstanced", false);
+    for (uint32_t i : individualEntities_)
+        proxies[i].Draw(objectShader, -1, bonePalette_.GetTexture());
+}
+
 // ------------------------------------------------------------
 // BIG OCEAN WATER PLANE
 // ------------------------------------------------------------
 void Scene::GenerateWaterGeometry()
 {
     const int   resolution = 128;
-    const float size       = 600.0f;
+    const float size       = static_cast<float>(std::max(Terrain::MapWidth(), Terrain::MapDepth()));
     const float y          = oceanY;
     const float uvScale    = 20.0f;
 
@@ -251,7 +406,7 @@ void Scene::GenerateWaterGeometry()
     // ----------------------------
     // OpenGL buffers
     // ----------------------------
-    if (waterVAO) glDeleteVertexArrays(1, &waterVAO);
+    if (waterVAO) GLState::DeleteVertexArrays(1, &waterVAO);
     if (waterVBO) glDeleteBuffers(1, &waterVBO);
     if (waterEBO) glDeleteBuffers(1, &waterEBO);
 
@@ -259,7 +414,7 @@ void Scene::GenerateWaterGeometry()
     glGenBuffers(1, &waterVBO);
     glGenBuffers(1, &waterEBO);
 
-    glBindVertexArray(waterVAO);
+    GLState::BindVertexArray(waterVAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, waterVBO);
     glBufferData(GL_ARRAY_BUFFER,
@@ -297,26 +452,20 @@ void Scene::GenerateWaterGeometry()
         (void*)offsetof(WaterVertex, fade)
     );
 
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-void Scene::DrawWater(const glm::mat4& view,
-                      const glm::mat4& proj,
-                      const glm::vec3& viewPos)
+void Scene::DrawWater()
 {
     if (!waterShader || !waterVAO) return;
     if (!reflectionColorTex || !refractionColorTex || !refractionDepthTex) return;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
+    // Blend/cull state comes from the render queue's Water pass.
     waterShader->Use();
+    bindFogOfWar(*waterShader);
 
     waterShader->SetMat4("model", glm::mat4(1.0f));
-    waterShader->SetMat4("view", view);
-    waterShader->SetMat4("projection", proj);
     waterShader->SetFloat("time", (float)glfwGetTime());
-    waterShader->SetVec3("uViewPos", viewPos);
 
     // world-space noise
     waterShader->SetFloat("uNoiseWorldScale", 0.015f);
@@ -336,39 +485,38 @@ void Scene::DrawWater(const glm::mat4& view,
     waterShader->SetInt("noiseSampler",   1);
     waterShader->SetInt("overlaySampler", 2);
 
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, reflectionColorTex);
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_2D, refractionColorTex);
-    glActiveTexture(GL_TEXTURE5);
-    glBindTexture(GL_TEXTURE_2D, refractionDepthTex);
+    GLState::ActiveTexture(GL_TEXTURE3);
+    GLState::BindTexture(GL_TEXTURE_2D, reflectionColorTex);
+    GLState::ActiveTexture(GL_TEXTURE4);
+    GLState::BindTexture(GL_TEXTURE_2D, refractionColorTex);
+    GLState::ActiveTexture(GL_TEXTURE5);
+    GLState::BindTexture(GL_TEXTURE_2D, shoreField_.GetTexture());
 
     waterShader->SetInt("uReflection",      3);
     waterShader->SetInt("uRefraction",      4);
-    waterShader->SetInt("uRefractionDepth", 5);
+    waterShader->SetMat4("uReflectionViewProj", reflectionViewProj_);
+    waterShader->SetMat4("uRefractionViewProj", refractionViewProj_);
+    waterShader->SetInt("uShoreSDF",        5);
+    waterShader->SetVec4("uShoreRegion", shoreField_.GetRegion());
 
     if (foamTex) foamTex->Bind(6);
     else {
-        glActiveTexture(GL_TEXTURE6);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLState::ActiveTexture(GL_TEXTURE6);
+        GLState::BindTexture(GL_TEXTURE_2D, 0);
     }
     waterShader->SetInt("uFoamNoise", 6);
 
-    waterShader->SetFloat("uNear", 0.1f);
-    waterShader->SetFloat("uFar", 3000.0f);
     waterShader->SetFloat("uWaterY", oceanY);
     waterShader->SetFloat("uWaveStrength", 0.06f);
     waterShader->SetFloat("uFoamStrength", 1.0f);
     waterShader->SetFloat("uBaseAlpha", 0.85f);
 
-    glBindVertexArray(waterVAO);
+    GLState::BindVertexArray(waterVAO);
     glDrawElements(GL_TRIANGLES,
                    (GLsizei)waterIndexCount,
                    GL_UNSIGNED_INT,
                    0);
-    glBindVertexArray(0);
-
-    glDisable(GL_BLEND);
+    GLState::BindVertexArray(0);
 }
 
 
@@ -423,12 +571,13 @@ void Scene::generateLakeWater()
         lakeWaterIndices.push_back(i + 1);
     }
 
+    layoutToWorld(lakeWaterVerts);
     uploadLakeWaterMesh();
 }
 
 void Scene::uploadLakeWaterMesh()
 {
-    if (lakeVAO) glDeleteVertexArrays(1, &lakeVAO);
+    if (lakeVAO) GLState::DeleteVertexArrays(1, &lakeVAO);
     if (lakeVBO) glDeleteBuffers(1, &lakeVBO);
     if (lakeEBO) glDeleteBuffers(1, &lakeEBO);
 
@@ -436,7 +585,7 @@ void Scene::uploadLakeWaterMesh()
     glGenBuffers(1, &lakeVBO);
     glGenBuffers(1, &lakeEBO);
 
-    glBindVertexArray(lakeVAO);
+    GLState::BindVertexArray(lakeVAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, lakeVBO);
     glBufferData(GL_ARRAY_BUFFER, lakeWaterVerts.size() * sizeof(WaterVertex), lakeWaterVerts.data(), GL_STATIC_DRAW);
@@ -452,22 +601,18 @@ void Scene::uploadLakeWaterMesh()
 
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2,1,GL_FLOAT,GL_FALSE,sizeof(WaterVertex),(void*)offsetof(WaterVertex, fade));
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-void Scene::DrawLakeWater(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& viewPos)
+void Scene::DrawLakeWater()
 {
     if (!waterShader || !lakeVAO) return;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
+    // Blend/cull state comes from the render queue's Water pass.
     waterShader->Use();
+    bindFogOfWar(*waterShader);
     waterShader->SetMat4("model", glm::mat4(1.0f));
-    waterShader->SetMat4("view", view);
-    waterShader->SetMat4("projection", proj);
     waterShader->SetFloat("time", (float)glfwGetTime());
-    waterShader->SetVec3("uViewPos", viewPos);
 
     waterShader->SetFloat("uNoiseWorldScale", 0.020f);
     waterShader->SetFloat("uNoiseSpeed",      0.015f);
@@ -487,37 +632,36 @@ void Scene::DrawLakeWater(const glm::mat4& view, const glm::mat4& proj, const gl
     waterShader->SetInt("overlaySampler", 2);
 
     // -------- FBO TEXTURES --------
-    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, reflectionColorTex);
-    glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, refractionColorTex);
-    glActiveTexture(GL_TEXTURE5); glBindTexture(GL_TEXTURE_2D, refractionDepthTex);
+    GLState::ActiveTexture(GL_TEXTURE3); GLState::BindTexture(GL_TEXTURE_2D, reflectionColorTex);
+    GLState::ActiveTexture(GL_TEXTURE4); GLState::BindTexture(GL_TEXTURE_2D, refractionColorTex);
+    GLState::ActiveTexture(GL_TEXTURE5); GLState::BindTexture(GL_TEXTURE_2D, shoreField_.GetTexture());
 
     waterShader->SetInt("uReflection",      3);
     waterShader->SetInt("uRefraction",      4);
-    waterShader->SetInt("uRefractionDepth", 5);
+    waterShader->SetMat4("uReflectionViewProj", reflectionViewProj_);
+    waterShader->SetMat4("uRefractionViewProj", refractionViewProj_);
+    waterShader->SetInt("uShoreSDF",        5);
+    waterShader->SetVec4("uShoreRegion", shoreField_.GetRegion());
 
     // -------- FOAM --------
     if (foamTex) foamTex->Bind(6);
     else {
-        glActiveTexture(GL_TEXTURE6);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLState::ActiveTexture(GL_TEXTURE6);
+        GLState::BindTexture(GL_TEXTURE_2D, 0);
     }
     waterShader->SetInt("uFoamNoise", 6);
 
-    waterShader->SetFloat("uNear", 0.1f);
-    waterShader->SetFloat("uFar", 3000.0f);
     waterShader->SetFloat("uWaterY", lakeY);
     waterShader->SetFloat("uWaveStrength", 0.03f);
     waterShader->SetFloat("uFoamStrength", 0.65f);
     waterShader->SetFloat("uBaseAlpha", 0.80f);
 
 
-    glBindVertexArray(lakeVAO);
+    GLState::BindVertexArray(lakeVAO);
     glDrawElements(GL_TRIANGLES,
                    (GLsizei)lakeWaterIndices.size(),
                    GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    glDisable(GL_BLEND);
+    GLState::BindVertexArray(0);
 }
 
 
@@ -599,12 +743,13 @@ void Scene::generateRiverWater()
         riverWaterIndices.push_back(i + 3); riverWaterIndices.push_back(i + 7); riverWaterIndices.push_back(i + 6);
     }
 
+    layoutToWorld(riverWaterVerts);
     uploadRiverWaterMesh();
 }
 
 void Scene::uploadRiverWaterMesh()
 {
-    if (riverVAO) glDeleteVertexArrays(1, &riverVAO);
+    if (riverVAO) GLState::DeleteVertexArrays(1, &riverVAO);
     if (riverVBO) glDeleteBuffers(1, &riverVBO);
     if (riverEBO) glDeleteBuffers(1, &riverEBO);
 
@@ -612,7 +757,7 @@ void Scene::uploadRiverWaterMesh()
     glGenBuffers(1, &riverVBO);
     glGenBuffers(1, &riverEBO);
 
-    glBindVertexArray(riverVAO);
+    GLState::BindVertexArray(riverVAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, riverVBO);
     glBufferData(GL_ARRAY_BUFFER, riverWaterVerts.size() * sizeof(WaterVertex), riverWaterVerts.data(), GL_STATIC_DRAW);
@@ -628,22 +773,18 @@ void Scene::uploadRiverWaterMesh()
     glEnableVertexAttribArray(2); // fade
     glVertexAttribPointer(2,1,GL_FLOAT,GL_FALSE,sizeof(WaterVertex),(void*)offsetof(WaterVertex, fade)
 );
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-void Scene::DrawRiverWater(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& viewPos)
+void Scene::DrawRiverWater()
 {
     if (!waterShader || !riverVAO) return;
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
+    // Blend/cull state comes from the render queue's Water pass.
     waterShader->Use();
+    bindFogOfWar(*waterShader);
     waterShader->SetMat4("model", glm::mat4(1.0f));
-    waterShader->SetMat4("view", view);
-    waterShader->SetMat4("projection", proj);
     waterShader->SetFloat("time", (float)glfwGetTime());
-    waterShader->SetVec3("uViewPos", viewPos); // camera world position
 
     // IMPORTANT: river needs higher world scale to avoid banding
     waterShader->SetFloat("uNoiseWorldScale", 0.030f);
@@ -664,35 +805,34 @@ void Scene::DrawRiverWater(const glm::mat4& view, const glm::mat4& proj, const g
     waterShader->SetInt("overlaySampler", 2);
 
     // -------- FBO TEXTURES --------
-    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, reflectionColorTex);
-    glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, refractionColorTex);
-    glActiveTexture(GL_TEXTURE5); glBindTexture(GL_TEXTURE_2D, refractionDepthTex);
+    GLState::ActiveTexture(GL_TEXTURE3); GLState::BindTexture(GL_TEXTURE_2D, reflectionColorTex);
+    GLState::ActiveTexture(GL_TEXTURE4); GLState::BindTexture(GL_TEXTURE_2D, refractionColorTex);
+    GLState::ActiveTexture(GL_TEXTURE5); GLState::BindTexture(GL_TEXTURE_2D, shoreField_.GetTexture());
 
     waterShader->SetInt("uReflection",      3);
     waterShader->SetInt("uRefraction",      4);
-    waterShader->SetInt("uRefractionDepth", 5);
+    waterShader->SetMat4("uReflectionViewProj", reflectionViewProj_);
+    waterShader->SetMat4("uRefractionViewProj", refractionViewProj_);
+    waterShader->SetInt("uShoreSDF",        5);
+    waterShader->SetVec4("uShoreRegion", shoreField_.GetRegion());
 
     // -------- FOAM --------
     if (foamTex) foamTex->Bind(6);
     else {
-        glActiveTexture(GL_TEXTURE6);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLState::ActiveTexture(GL_TEXTURE6);
+        GLState::BindTexture(GL_TEXTURE_2D, 0);
     }
     waterShader->SetInt("uFoamNoise", 6);
 
-    waterShader->SetFloat("uNear", 0.1f);
-    waterShader->SetFloat("uFar", 3000.0f);
     waterShader->SetFloat("uWaterY", riverY);
     waterShader->SetFloat("uWaveStrength", 0.02f);
     waterShader->SetFloat("uFoamStrength", 0.80f);
     waterShader->SetFloat("uBaseAlpha", 0.75f);
 
 
-    glBindVertexArray(riverVAO);
+    GLState::BindVertexArray(riverVAO);
     glDrawElements(GL_TRIANGLES,
                    (GLsizei)riverWaterIndices.size(),
                    GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    glDisable(GL_BLEND);
+    GLState::BindVertexArray(0);
 }
@@ -0,0 +1,147 @@
+#include "Scene.h"
+#include "SceneConstants.h"
+#include <cstdio>
+#include <filesystem>
+
+// ------------------------------------------------------------
+// World cache
+// Everything derived from the generation parameters below is
+// written once and memory-mapped on later launches.
+// ------------------------------------------------------------
+uint64_t Scene::worldCacheKey() const
+{
+    uint64_t h = WorldCache::HashValue(WorldCache::kVersion, 0xcbf29ce484222325ull);
+    h = WorldCache::HashValue(SceneConst::kWorldGenRevision, h);
+    h = WorldCache::HashValue(Terrain::MapWidth(), h);
+    h = WorldCache::HashValue(Terrain::MapDepth(), h);
+    h = WorldCache::HashValue(SceneConst::kTreeSeed, h);
+    h = WorldCache::HashValue(SceneConst::kRockSeed, h);
+    h = WorldCache::HashValue(SceneConst::kTreeSpacing, h);
+    h = WorldCache::HashValue(SceneConst::kRockSpacing, h);
+    h = WorldCache::HashValue(SceneConst::kRockDensity, h);
+    h = WorldCache::HashValue(SceneConst::kShoreCellSize, h);
+    h = WorldCache::HashValue(SceneConst::kNavCellSize, h);
+    h = WorldCache::HashValue(oceanY, h);
+    h = WorldCache::HashValue(lakeY, h);
+    h = WorldCache::HashValue(riverY, h);
+    return h;
+}
+
+std::string Scene::worldCachePath(uint64_t key) const
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "world_%016llx.bin", static_cast<unsigned long long>(key));
+    return std::string("cache/") + name;
+}
+
+Terrain* Scene::createTerrainFromCache()
+{
+    const uint64_t key = worldCacheKey();
+    if (!worldCache_.Open(worldCachePath(key), key))
+        return nullptr;
+
+    const Vertex* verts = nullptr;
+    size_t count = 0;
+    const size_t expected = static_cast<size_t>(Terrain::MapWidth() + 1) * static_cast<size_t>(Terrain::MapDepth() + 1);
+    if (!worldCache_.View(WorldCache::Section::TerrainVertices, verts, count) || count != expected)
+    {
+        worldCache_.Close();
+        return nullptr;
+    }
+
+    std::cout << "Terrain loaded from world cache " << worldCachePath(key) << std::endl;
+    return new Terrain(Terrain::MapWidth(), Terrain::MapDepth(), verts, count);
+}
+
+bool Scene::loadWorldFromCache()
+{
+    if (!worldCache_.IsOpen())
+        return false;
+
+    using Section = WorldCache::Section;
+    bool ok = worldCache_.Copy(Section::TreeTransforms, treeTransforms) &&
+              worldCache_.Copy(Section::TreePositions,  treePositions_) &&
+              worldCache_.Copy(Section::RockTransforms, rockTransforms) &&
+              worldCache_.Copy(Section::RockPositions,  rockPositions_) &&
+              worldCache_.Copy(Section::LakeVertices,   lakeWaterVerts) &&
+              worldCache_.Copy(Section::LakeIndices,    lakeWaterIndices) &&
+              worldCache_.Copy(Section::RiverVertices,  riverWaterVerts) &&
+              worldCache_.Copy(Section::RiverIndices,   riverWaterIndices) &&
+              worldCache_.Copy(Section::NavWater,       navStaticWater_);
+
+    const float* distances = nullptr;
+    const uint8_t* mask = nullptr;
+    size_t distCount = 0, maskCount = 0;
+    ok = ok &&
+         worldCache_.View(Section::ShoreDistance, distances, distCount) &&
+         worldCache_.View(Section::ShoreWaterMask, mask, maskCount) &&
+         distCount == maskCount;
+
+    if (ok)
+    {
+        const float cellSize = SceneConst::kShoreCellSize;
+        const int cols = static_cast<int>(Terrain::MapWidth() / cellSize);
+        const int rows = static_cast<int>(Terrain::MapDepth() / cellSize);
+        const glm::vec2 origin(-Terrain::MapWidth() * 0.5f, -Terrain::MapDepth() * 0.5f);
+        ok = shoreField_.Load(cols, rows, cellSize, origin, distances, mask, distCount);
+    }
+
+    if (!ok || treeTransforms.size() != treePositions_.size() || rockTransforms.size() != rockPositions_.size())
+    {
+        std::cerr << "World cache is missing sections, regenerating." << std::endl;
+        navStaticWater_.clear();
+        return false;
+    }
+
+    uploadLakeWaterMesh();
+    uploadRiverWaterMesh();
+    shoreField_.Upload();
+
+    std::cout << "Loaded " << treeTransforms.size() << " trees and "
+              << rockTransforms.size() << " rocks from world cache." << std::endl;
+    return true;
+}
+
+void Scene::saveWorldCache() const
+{
+    if (!terrain)
+        return;
+
+    using Section = WorldCache::Section;
+    WorldCache::Writer writer;
+    if (!terrain->GetVertices().empty())
+    {
+        writer.Add(Section::TerrainVertices, terrain->GetVertices());
+    }
+    else
+    {
+        // Repairing a cache whose terrain loaded but whose other
+        // sections did not: terrain built from the cached vertices
+        // keeps no CPU copy, so write them back from the mapping,
+        // which stays valid until Init closes it (Save renames a
+        // temp file over the path, never writes into the mapping).
+        const Vertex* cached = nullptr;
+        size_t count = 0;
+        if (!worldCache_.View(Section::TerrainVertices, cached, count))
+            return;
+        writer.Add(Section::TerrainVertices, cached, count * sizeof(Vertex));
+    }
+    writer.Add(Section::ShoreDistance,   shoreField_.GetData());
+    writer.Add(Section::ShoreWaterMask,  shoreField_.GetWaterMask());
+    writer.Add(Section::NavWater,        navStaticWater_);
+    writer.Add(Section::TreeTransforms,  treeTransforms);
+    writer.Add(Section::TreePositions,   treePositions_);
+    writer.Add(Section::RockTransforms,  rockTransforms);
+    writer.Add(Section::RockPositions,   rockPositions_);
+    writer.Add(Section::LakeVertices,    lakeWaterVerts);
+    writer.Add(Section::LakeIndices,     lakeWaterIndices);
+    writer.Add(Section::RiverVertices,   riverWaterVerts);
+    writer.Add(Section::RiverIndices,    riverWaterIndices);
+
+    const uint64_t key = worldCacheKey();
+    const std::string path = worldCachePath(key);
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    if (writer.Save(path, key))
+        std::cout << "World cache written to " << path << std::endl;
+}
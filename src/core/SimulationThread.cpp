@@ -0,0 +1,103 @@
+#include "SimulationThread.h"
+#include "Scene.h"
+#include "Camera.h"
+#include <GLFW/glfw3.h>
+#include <utility>
+
+SimulationThread::SimulationThread(Scene& scene, Camera& camera, InputHandler handler)
+    : scene_(scene), camera_(camera), handler_(std::move(handler))
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+void SimulationThread::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+        return;
+    running_ = true;
+    frameReady_ = false;
+    thread_ = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void SimulationThread::PushEvent(const InputEvent& event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.events.push_back(event);
+}
+
+void SimulationThread::SubmitFrame(uint32_t keysDown, int fbWidth, int fbHeight,
+                                   int windowWidth, int windowHeight)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Edges accumulate until the simulation takes them, so a tap
+        // shorter than a tick is not lost.
+        pending_.keysPressed |= keysDown & ~submittedKeys_;
+        pending_.keysDown = keysDown;
+        submittedKeys_ = keysDown;
+        pending_.fbWidth = fbWidth;
+        pending_.fbHeight = fbHeight;
+        pending_.windowWidth = windowWidth;
+        pending_.windowHeight = windowHeight;
+        frameReady_ = true;
+    }
+    wake_.notify_one();
+}
+
+const RenderSnapshot* SimulationThread::AcquireSnapshot()
+{
+    if (snapshots_.Acquire())
+    {
+        hasSnapshot_ = true;
+        consumedTick_.store(snapshots_.Front().tick, std::memory_order_release);
+    }
+    return hasSnapshot_ ? &snapshots_.Front() : nullptr;
+}
+
+void SimulationThread::run()
+{
+    Input input;
+    double lastTime = glfwGetTime();   // thread-safe, unlike the rest of GLFW
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return frameReady_ || !running_; });
+            if (!running_)
+                break;
+            std::swap(input, pending_);
+            pending_.events.clear();
+            pending_.keysPressed = 0;
+            frameReady_ = false;
+        }
+
+        const double now = glfwGetTime();
+        const float dt = static_cast<float>(now - lastTime);
+        lastTime = now;
+
+        scene_.SetViewportSize(input.fbWidth, input.fbHeight, input.windowWidth, input.windowHeight);
+        if (handler_)
+            handler_(input, dt);
+        scene_.Update(dt, camera_);
+
+        scene_.WriteRenderSnapshot(snapshots_.Back(), consumedTick_.load(std::memory_order_acquire));
+        snapshots_.Publish();
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RenderSnapshot.h"
+#include "../../common/TripleBuffer.h"
+
+class Scene;
+class Camera;
+
+// ============================================================
+// SimulationThread
+// Runs Scene::Update and Scene::WriteRenderSnapshot on a thread of
+// its own, so a slow tick (pathfinding, fog, animation) overlaps the
+// GL thread drawing the previous one instead of adding to it.
+//
+// One tick per rendered frame: the main thread hands over the input
+// it sampled (GLFW is main-thread only) with SubmitFrame(), the
+// simulation runs a tick with it and publishes a snapshot, and the
+// GL thread draws the newest published snapshot (AcquireSnapshot).
+// The camera belongs to the simulation once Start() is called.
+// ============================================================
+class SimulationThread {
+public:
+    struct InputEvent {
+        enum class Type : uint8_t { CursorPos, MouseButton, Scroll };
+        Type type = Type::CursorPos;
+        double x = 0.0;     // cursor position, or scroll offset
+        double y = 0.0;
+        int button = 0;
+        int action = 0;
+        int mods = 0;
+    };
+
+    // Everything the main thread sampled for one tick
+    struct Input {
+        std::vector<InputEvent> events;     // in arrival order
+        uint32_t keysDown = 0;              // bits chosen by the handler's owner
+        uint32_t keysPressed = 0;           // went down since the last tick
+        int fbWidth = 0;
+        int fbHeight = 0;
+        int windowWidth = 0;
+        int windowHeight = 0;
+    };
+
+    // Applies one tick's input to the scene and camera; runs on the
+    // simulation thread before Scene::Update.
+    using InputHandler = std::function<void(const Input& input, float dt)>;
+
+    SimulationThread(Scene& scene, Camera& camera, InputHandler handler);
+    ~SimulationThread();
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Call after Scene::Init; Stop() before the scene is destroyed.
+    void Start();
+    void Stop();
+
+    // --- Main thread ---
+    void PushEvent(const InputEvent& event);
+    // Ends the frame's input and lets the simulation run one tick.
+    void SubmitFrame(uint32_t keysDown, int fbWidth, int fbHeight,
+                     int windowWidth, int windowHeight);
+    // Newest published snapshot, valid until the next call; nullptr
+    // until the first tick has finished.
+    const RenderSnapshot* AcquireSnapshot();
+
+private:
+    void run();
+
+    Scene& scene_;
+    Camera& camera_;
+    InputHandler handler_;
+
+    TripleBuffer<RenderSnapshot> snapshots_;
+    bool hasSnapshot_ = false;
+    // Tick of the snapshot the GL thread holds (see WriteRenderSnapshot)
+    std::atomic<uint64_t> consumedTick_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    Input pending_;                 // guarded by mutex_
+    uint32_t submittedKeys_ = 0;    // guarded by mutex_
+    bool frameReady_ = false;       // guarded by mutex_
+    bool running_ = false;          // guarded by mutex_
+    std::thread thread_;
+};
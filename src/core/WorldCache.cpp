@@ -0,0 +1,206 @@
+#include "WorldCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr size_t kAlignment = 16;
+
+size_t alignUp(size_t value)
+{
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+}
+
+WorldCache::~WorldCache()
+{
+    Close();
+}
+
+bool WorldCache::Open(const std::string& path, uint64_t key)
+{
+    Close();
+
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (fallback_.empty())
+        return false;
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data_ = static_cast<const uint8_t*>(mapped);
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+
+    Header header {};
+    if (size_ < sizeof(Header))
+    {
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data_, sizeof(Header));
+
+    const size_t tableEnd = sizeof(Header) + static_cast<size_t>(header.sectionCount) * sizeof(SectionEntry);
+    if (header.magic != kMagic || header.version != kVersion || header.key != key ||
+        header.fileSize != size_ || tableEnd > size_)
+    {
+        std::cout << "World cache " << path << " is stale, regenerating." << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void WorldCache::Close()
+{
+#ifdef _WIN32
+    fallback_.clear();
+    fallback_.shrink_to_fit();
+#else
+    if (data_)
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool WorldCache::find(Section id, const void*& out, size_t& bytes) const
+{
+    if (!data_)
+        return false;
+
+    Header header {};
+    std::memcpy(&header, data_, sizeof(Header));
+    const uint8_t* table = data_ + sizeof(Header);
+
+    for (uint32_t i = 0; i < header.sectionCount; ++i)
+    {
+        SectionEntry entry {};
+        std::memcpy(&entry, table + i * sizeof(SectionEntry), sizeof(SectionEntry));
+        if (entry.id != static_cast<uint32_t>(id))
+            continue;
+        // Written so a corrupt header cannot wrap the sum around.
+        if (entry.offset > size_ || entry.size > size_ - entry.offset)
+            return false;
+        out = data_ + entry.offset;
+        bytes = static_cast<size_t>(entry.size);
+        return true;
+    }
+    return false;
+}
+
+void WorldCache::Writer::Add(Section id, const void* data, size_t bytes)
+{
+    sections_.push_back({ id, data, bytes });
+}
+
+bool WorldCache::Writer::Save(const std::string& path, uint64_t key) const
+{
+    std::vector<SectionEntry> entries(sections_.size());
+    size_t offset = alignUp(sizeof(Header) + entries.size() * sizeof(SectionEntry));
+    for (size_t i = 0; i < sections_.size(); ++i)
+    {
+        entries[i].id = static_cast<uint32_t>(sections_[i].id);
+        entries[i].reserved = 0;
+        entries[i].offset = offset;
+        entries[i].size = sections_[i].bytes;
+        offset = alignUp(offset + sections_[i].bytes);
+    }
+
+    Header header {};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.key = key;
+    header.sectionCount = static_cast<uint32_t>(entries.size());
+    header.fileSize = offset;
+
+    // Write to a temp file and rename so a crash never leaves a
+    // half-written cache behind that passes the header check.
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "World cache: cannot write " << tmpPath << std::endl;
+            return false;
+        }
+
+        static const char zeros[kAlignment] = {};
+        size_t written = 0;
+        auto put = [&](const void* data, size_t bytes)
+        {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        };
+        auto pad = [&]()
+        {
+            size_t target = alignUp(written);
+            put(zeros, target - written);
+        };
+
+        put(&header, sizeof(Header));
+        put(entries.data(), entries.size() * sizeof(SectionEntry));
+        pad();
+        for (const Pending& section : sections_)
+        {
+            put(section.data, section.bytes);
+            pad();
+        }
+
+        if (!out)
+        {
+            std::cerr << "World cache: write failed for " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::cerr << "World cache: cannot move " << tmpPath << " into place" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t WorldCache::Hash(const void* data, size_t bytes, uint64_t seed)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
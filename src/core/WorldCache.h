@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// WorldCache
+// Versioned binary snapshot of the generated world.
+//
+//   Header | SectionEntry[sectionCount] | payloads (16-byte aligned)
+//
+// The file is keyed by a hash of the generation parameters; a
+// mismatched key or version is treated as a miss. Readers map the
+// file and get pointers straight into it, so loading is an mmap plus
+// whatever GPU uploads the caller does. Data is stored in native
+// byte order (the cache is a local artefact, not an asset).
+// ============================================================
+class WorldCache {
+public:
+    static constexpr uint32_t kMagic   = 0x43414357; // "WCAC"
+    static constexpr uint32_t kVersion = 1;
+
+    enum class Section : uint32_t {
+        TerrainVertices = 1,
+        ShoreDistance,
+        ShoreWaterMask,
+        NavWater,
+        TreeTransforms,
+        TreePositions,
+        RockTransforms,
+        RockPositions,
+        LakeVertices,
+        LakeIndices,
+        RiverVertices,
+        RiverIndices,
+    };
+
+    WorldCache() = default;
+    ~WorldCache();
+    WorldCache(const WorldCache&) = delete;
+    WorldCache& operator=(const WorldCache&) = delete;
+
+    // Maps `path` and validates magic/version/key. False on any miss.
+    bool Open(const std::string& path, uint64_t key);
+    void Close();
+    bool IsOpen() const { return data_ != nullptr; }
+
+    // Pointer into the mapping; valid until Close().
+    template <typename T>
+    bool View(Section id, const T*& out, size_t& count) const
+    {
+        const void* ptr = nullptr;
+        size_t bytes = 0;
+        if (!find(id, ptr, bytes) || bytes % sizeof(T) != 0)
+            return false;
+        out = static_cast<const T*>(ptr);
+        count = bytes / sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool Copy(Section id, std::vector<T>& out) const
+    {
+        const T* ptr = nullptr;
+        size_t count = 0;
+        if (!View(id, ptr, count))
+            return false;
+        out.assign(ptr, ptr + count);
+        return true;
+    }
+
+    // --------------------------------------------------------
+    // Writer: collects section pointers, then writes the file.
+    // Referenced data must stay alive until Save() returns.
+    // --------------------------------------------------------
+    class Writer {
+    public:
+        void Add(Section id, const void* data, size_t bytes);
+
+        template <typename T>
+        void Add(Section id, const std::vector<T>& data)
+        {
+            Add(id, data.data(), data.size() * sizeof(T));
+        }
+
+        bool Save(const std::string& path, uint64_t key) const;
+
+    private:
+        struct Pending {
+            Section id;
+            const void* data;
+            size_t bytes;
+        };
+        std::vector<Pending> sections_;
+    };
+
+    // FNV-1a, chainable through `seed`.
+    static uint64_t Hash(const void* data, size_t bytes, uint64_t seed = 0xcbf29ce484222325ull);
+
+    template <typename T>
+    static uint64_t HashValue(const T& value, uint64_t seed)
+    {
+        return Hash(&value, sizeof(T), seed);
+    }
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t sectionCount;
+        uint32_t reserved;
+        uint64_t fileSize;
+    };
+
+    struct SectionEntry {
+        uint32_t id;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> fallback_;
+#endif
+
+    bool find(Section id, const void*& out, size_t& bytes) const;
+};
@@ -24,6 +24,10 @@ struct Resources {
     int populationCap  = 4;
     int villagers      = 0;
 
+    // Bumped by every mutator below so the HUD can tell when to
+    // re-format its counters without comparing each field.
+    unsigned revision = 0;
+
     bool Spend(const UnitCost& cost)
     {
         if (food < cost.food || wood < cost.wood || ore < cost.ore || gold < cost.gold)
@@ -33,26 +37,31 @@ struct Resources {
         wood -= cost.wood;
         ore  -= cost.ore;
         gold -= cost.gold;
+        ++revision;
         return true;
     }
     void AddFood(int amount)
     {
         food = std::clamp(food + amount, 0, foodCapacity);
+        ++revision;
     }
 
     void AddWood(int amount)
     {
         wood = std::clamp(wood + amount, 0, woodCapacity);
+        ++revision;
     }
 
     void AddOre(int amount)
     {
         ore = std::clamp(ore + amount, 0, oreCapacity);
+        ++revision;
     }
 
     void AddGold(int amount)
     {
         gold = std::clamp(gold + amount, 0, goldCapacity);
+        ++revision;
     }
 
     void IncreaseStorageCapacity(int foodDelta, int woodDelta, int oreDelta, int goldDelta)
@@ -66,6 +75,7 @@ struct Resources {
         wood = std::min(wood, woodCapacity);
         ore  = std::min(ore,  oreCapacity);
         gold = std::min(gold, goldCapacity);
+        ++revision;
     }
 
     bool HasPopulationRoom(int required) const
@@ -77,17 +87,20 @@ struct Resources {
     {
         population += amount;
         population = std::max(population, 0);
+        ++revision;
     }
 
     void AddVillager(int amount)
     {
         villagers += amount;
         villagers = std::max(villagers, 0);
+        ++revision;
     }
 
     void AddPopulationCap(int amount)
     {
         populationCap += amount;
         populationCap = std::max(populationCap, 0);
+        ++revision;
     }
 };
@@ -26,7 +26,7 @@ public:
         }
     }
 
-    void Draw(Shader& shader) override;           
+    void WriteRenderProxy(EntityProxy& out) const override;
     virtual void SpawnUnit(std::vector<GameEntity*>& entities) = 0;
 
     void SetMaxHealth(float value)
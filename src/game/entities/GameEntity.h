@@ -2,8 +2,8 @@
 #include <glm/glm.hpp>
 #include <glm/common.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include "../../common/Shader.h"
 #include "../../common/Model.h"
+#include "../../rendering/EntityProxy.h"
 #include "EntityType.h"
 #include <glm/gtx/euler_angles.hpp>
 
@@ -28,14 +28,14 @@ public:
 
     virtual void Update(float dt) = 0;
 
-    virtual void Draw(Shader& shader)
+    // Copies what the GL thread draws into `out`; called on the
+    // simulation thread while a RenderSnapshot is written.
+    virtual void WriteRenderProxy(EntityProxy& out) const
     {
-        if (!model) return;
-        shader.Use();
-        shader.SetMat4("model", transform);
-        shader.SetFloat("uAlpha", 1.0f);
-        shader.SetBool("uUseSkinning", false);
-        model->Draw(shader);
+        out = EntityProxy();
+        out.model = model;
+        out.transform = transform;
+        out.position = position;
     }
 
     void SetSelected(bool selected) { isSelected_ = selected; }
@@ -2,18 +2,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <GL/glew.h>
-#include <iostream>
 
 #include <algorithm>
 #include <cmath>
 
-Unit::~Unit()
-{
-    if (boneTexture_ != 0)
-        glDeleteTextures(1, &boneTexture_);
-    if (boneBuffer_ != 0)
-        glDeleteBuffers(1, &boneBuffer_);
-}
+Unit::~Unit() = default;
 
 void Unit::Update(float dt)
 {
@@ -160,14 +153,20 @@ void Unit::updateAnimation(float dt)
     if (!useSkinning_)
     {
         useSkinning_ = true;
-        ensureBoneCapacity();
+        if (!model->HasBakedAnimations())
+            ensureBoneCapacity();
     }
 
     if (!freezeAnimation_)
         animationTimeSeconds_ += static_cast<double>(dt);
-    double evalTime = freezeAnimation_ ? frozenAnimationTime_ : animationTimeSeconds_;
-    model->EvaluateAnimation(activeAnimationIndex_, evalTime, boneTransforms_);
-    uploadBonePalette();
+    // Baked models: the clock is all the per-unit state there is.
+    if (model->HasBakedAnimations())
+        return;
+    if (!animationDue_ && poseValid_)
+        return;
+    model->EvaluateAnimation(activeAnimationIndex_, animationSampleTime(), boneTransforms_);
+    poseValid_ = true;
+    ++poseRevision_;
 }
 
 void Unit::ensureBoneCapacity()
@@ -176,7 +175,6 @@ void Unit::ensureBoneCapacity()
     size_t count = model->GetBoneCount();
     if (boneTransforms_.size() != count)
         boneTransforms_.assign(count, glm::mat4(1.0f));
-    ensureBoneGPUCapacity(count);
 }
 
 void Unit::selectAnimationIndices()
@@ -218,6 +216,7 @@ void Unit::updateActiveAnimationForState()
     {
         activeAnimationIndex_ = static_cast<size_t>(desired);
         animationTimeSeconds_ = 0.0;
+        poseValid_ = false;   // show the new clip even if this frame was skipped
     }
 }
 
@@ -256,64 +255,20 @@ void Unit::FreezeAnimation(bool freeze, double timeSeconds)
     }
 }
 
-void Unit::Draw(Shader& shader)
+bool Unit::HasCpuPose() const
 {
-    shader.Use();
-    shader.SetMat4("model", transform);
-    bool canSkin = useSkinning_ && boneTexture_ != 0 && !boneTransforms_.empty();
-    shader.SetFloat("uAlpha", 1.0f);
-    shader.SetBool("uUseSkinning", canSkin);
-    if (canSkin)
-    {
-        shader.BindBoneTexture(boneTexture_, static_cast<int>(boneTransforms_.size()));
-    }
-    else
-    {
-        shader.BindBoneTexture(0, 0);
-        if (useSkinning_)
-        {
-            std::cout << "[Unit] Warning: skinning requested but bone texture missing for entity type "
-                      << static_cast<int>(type) << "\n";
-        }
-    }
-
-    model->Draw(shader);
+    return useSkinning_ && model && !UsesBakedAnimation() &&
+           !boneTransforms_.empty() && boneTransforms_.size() == model->GetBoneCount();
 }
 
-void Unit::ensureBoneGPUCapacity(size_t count)
+// The bone base of CPU-posed units is their offset in the snapshot's
+// palette, which Scene fills in while writing the snapshot.
+void Unit::WriteRenderProxy(EntityProxy& out) const
 {
-    if (count == 0)
-        return;
-    if (boneCapacity_ >= count)
-        return;
-
-    boneCapacity_ = count;
-    if (boneBuffer_ == 0)
-        glGenBuffers(1, &boneBuffer_);
-    glBindBuffer(GL_TEXTURE_BUFFER, boneBuffer_);
-    glBufferData(GL_TEXTURE_BUFFER, boneCapacity_ * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
-    if (boneTexture_ == 0)
-    {
-        glGenTextures(1, &boneTexture_);
-        std::cout << "[Unit] Created bone texture for entity type " << static_cast<int>(type)
-                  << " with capacity " << boneCapacity_ << " matrices.\n";
-    }
-    glBindTexture(GL_TEXTURE_BUFFER, boneTexture_);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, boneBuffer_);
-}
-
-void Unit::uploadBonePalette()
-{
-    if (!useSkinning_ || boneTransforms_.empty())
-        return;
-    ensureBoneGPUCapacity(boneTransforms_.size());
-    glBindBuffer(GL_TEXTURE_BUFFER, boneBuffer_);
-    glBufferSubData(GL_TEXTURE_BUFFER, 0,
-                    boneTransforms_.size() * sizeof(glm::mat4),
-                    boneTransforms_.data());
-    if (boneTexture_ == 0)
-    {
-        std::cout << "[Unit] ERROR: Failed to create bone texture buffer for entity type "
-                  << static_cast<int>(type) << "\n";
-    }
+    GameEntity::WriteRenderProxy(out);
+    out.kind = EntityProxy::Kind::Unit;
+    out.skinned = useSkinning_;
+    out.baked = UsesBakedAnimation();
+    if (out.baked)
+        out.boneBase = model->GetBakedBoneBase(activeAnimationIndex_, animationSampleTime());
 }
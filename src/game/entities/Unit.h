@@ -1,5 +1,6 @@
 #pragma once
 #include "GameEntity.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <glm/vec4.hpp>
@@ -18,12 +19,16 @@ public:
     }
 
     virtual void Update(float dt) override;
-    virtual void Draw(Shader& shader) override;
+    void WriteRenderProxy(EntityProxy& out) const override;
 
     virtual ~Unit();
 
     void SetMoveTarget(const glm::vec3& target);
     void SetPath(const std::vector<glm::vec3>& path);
+    bool IsFollowingPath() const { return followingPath_; }
+    // Waypoints still ahead are GetPath()[GetPathCursor()..].
+    const std::vector<glm::vec3>& GetPath() const { return pathPoints_; }
+    size_t GetPathCursor() const { return pathCursor_; }
     bool HasMoveTarget() const { return hasMoveTarget_; }
     void ClearMoveTarget();
     float GetHealth() const { return health_; }
@@ -39,14 +44,23 @@ public:
     void SetTaskState(TaskState state);
     TaskState GetTaskState() const { return taskState_; }
     bool UsesSkinning() const { return useSkinning_; }
+    // Pose comes from the model's baked texture, not from boneTransforms_.
+    bool UsesBakedAnimation() const { return useSkinning_ && model && model->HasBakedAnimations(); }
     const std::vector<glm::mat4>& GetBoneMatrices() const { return boneTransforms_; }
-    unsigned int GetBoneTexture() const { return boneTexture_; }
     int GetBoneCount() const { return static_cast<int>(boneTransforms_.size()); }
+    // True when GetBoneMatrices() holds a full pose for the model
+    // (CPU-skinned units only).
+    bool HasCpuPose() const;
+    // Changes whenever GetBoneMatrices() is re-evaluated.
+    uint64_t GetPoseRevision() const { return poseRevision_; }
     void SetAnimationNames(const std::string& idle, const std::string& walk);
     void SetActionAnimation(const std::string& name);
     void ClearActionAnimation();
     void SetBaseHeightOffset(float offset) { baseHeightOffset_ = offset; }
     void FreezeAnimation(bool freeze, double timeSeconds = 0.0);
+    // Set by Scene's AnimationBudget before Update(); when false the
+    // clock still advances but the last pose is kept.
+    void SetAnimationDue(bool due) { animationDue_ = due; }
 
 protected:
     glm::vec3 targetPosition;
@@ -62,12 +76,11 @@ protected:
     void advanceToNextPathPoint();
     void handleArrival();
     void updateAnimation(float dt);
+    double animationSampleTime() const { return freezeAnimation_ ? frozenAnimationTime_ : animationTimeSeconds_; }
     void ensureBoneCapacity();
     void selectAnimationIndices();
     void updateActiveAnimationForState();
     void setActionAnimationInternal(const std::string& name);
-    void ensureBoneGPUCapacity(size_t count);
-    void uploadBonePalette();
 
     glm::vec3 velocity_{0.0f};
     float maxAcceleration_ = 20.0f;
@@ -82,9 +95,9 @@ protected:
     std::string walkAnimName_ = "Walk";
     std::string actionAnimName_;
     int actionAnimIndex_ = -1;
-    unsigned int boneTexture_ = 0;
-    unsigned int boneBuffer_ = 0;
-    size_t boneCapacity_ = 0;
+    bool animationDue_ = true;
+    bool poseValid_ = false;          // boneTransforms_ matches the active clip
+    uint64_t poseRevision_ = 0;
     float baseHeightOffset_ = 0.0f;
     bool freezeAnimation_ = false;
     double frozenAnimationTime_ = 0.0;
@@ -1,33 +1,13 @@
 #include "UIManager.h"
-#include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <algorithm>
+#include <cstddef>
 
 
-void UIManager::init(Shader* shader, int screenW, int screenH)
+void UIManager::init(int screenW, int screenH)
 {
-    shader_   = shader;
     screenW_  = screenW;
     screenH_  = screenH;
-
-    proj_ = glm::ortho(0.0f, (float)screenW_,
-                       0.0f, (float)screenH_);
-
-    // Simple quad VBO (we overwrite positions per element)
-    glGenVertexArrays(1, &vao_);
-    glGenBuffers(1, &vbo_);
-
-    glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
-
-    glEnableVertexAttribArray(0); // aPos
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-
-    glEnableVertexAttribArray(1); // aUV
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-
-    glBindVertexArray(0);
 }
 
 void UIManager::setFontTexture(GLuint tex, int cols, int rows, float charW, float charH)
@@ -37,11 +17,19 @@ void UIManager::setFontTexture(GLuint tex, int cols, int rows, float charW, floa
     fontRows_   = rows;
     fontCharW_  = charW;
     fontCharH_  = charH;
+    invalidateGlyphs();
 }
 
 void UIManager::setTextScale(float scale)
 {
     textScale_ = std::max(0.1f, scale);
+    invalidateGlyphs();
+}
+
+void UIManager::invalidateGlyphs()
+{
+    for (LabelGlyphs& glyphs : labelGlyphs_)
+        glyphs.valid = false;
 }
 
 size_t UIManager::addButton(const UIButton& btn)
@@ -53,6 +41,7 @@ size_t UIManager::addButton(const UIButton& btn)
 size_t UIManager::addLabel(const std::string& text, const glm::vec2& pos, float scale)
 {
     labels_.push_back({ pos, text, scale });
+    labelGlyphs_.emplace_back();
     return labels_.size() - 1;
 }
 
@@ -60,7 +49,10 @@ void UIManager::setLabelText(size_t index, const std::string& text)
 {
     if (index >= labels_.size())
         return;
+    if (labels_[index].text == text)
+        return;
     labels_[index].text = text;
+    labelGlyphs_[index].valid = false;
 }
 
 void UIManager::setButtonVisibility(size_t index, bool visible)
@@ -134,101 +126,88 @@ bool UIManager::handleClick(float mx, float my)
 }
 
 
-void UIManager::render()
+void UIManager::pushQuad(UIDrawList& out, const glm::vec2& p0, const glm::vec2& p1,
+                         const glm::vec2& uv0, const glm::vec2& uv1,
+                         const glm::vec4& tint, GLuint texture)
 {
-    if (!shader_) return;
+    // Solid quads ignore the bound texture, so they never split a batch.
+    UIBatch* batch = out.batches.empty() ? nullptr : &out.batches.back();
+    if (!batch || (texture != 0 && batch->texture != 0 && batch->texture != texture))
+    {
+        out.batches.push_back({ texture, static_cast<GLint>(out.vertices.size()), 0 });
+        batch = &out.batches.back();
+    }
+    if (texture != 0)
+        batch->texture = texture;
+
+    const float textured = texture != 0 ? 1.0f : 0.0f;
+    const UIVertex quad[6] = {
+        { { p0.x, p0.y }, { uv0.x, uv0.y }, tint, textured },
+        { { p1.x, p0.y }, { uv1.x, uv0.y }, tint, textured },
+        { { p1.x, p1.y }, { uv1.x, uv1.y }, tint, textured },
+
+        { { p0.x, p0.y }, { uv0.x, uv0.y }, tint, textured },
+        { { p1.x, p1.y }, { uv1.x, uv1.y }, tint, textured },
+        { { p0.x, p1.y }, { uv0.x, uv1.y }, tint, textured },
+    };
+    out.vertices.insert(out.vertices.end(), quad, quad + 6);
+    batch->count += 6;
+}
 
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+void UIManager::pushSolidQuad(UIDrawList& out, const glm::vec2& p0, const glm::vec2& p1,
+                              const glm::vec4& tint)
+{
+    pushQuad(out, p0, p1, glm::vec2(0.0f), glm::vec2(1.0f), tint, 0);
+}
 
-    shader_->Use();
-    shader_->SetMat4("uProj", proj_);
-    shader_->SetInt("uTex", 0);
+void UIManager::pushVertices(UIDrawList& out, const std::vector<UIVertex>& vertices, GLuint texture)
+{
+    if (vertices.empty())
+        return;
 
-    glBindVertexArray(vao_);
+    UIBatch* batch = out.batches.empty() ? nullptr : &out.batches.back();
+    if (!batch || (batch->texture != 0 && batch->texture != texture))
+    {
+        out.batches.push_back({ texture, static_cast<GLint>(out.vertices.size()), 0 });
+        batch = &out.batches.back();
+    }
+    batch->texture = texture;
+
+    out.vertices.insert(out.vertices.end(), vertices.begin(), vertices.end());
+    batch->count += static_cast<GLsizei>(vertices.size());
+}
+
+void UIManager::build(UIDrawList& out)
+{
+    out.vertices.clear();
+    out.batches.clear();
 
-    // --- 1) Draw buttons (bar background + icons + hover frame) ---
+    // --- 1) Buttons (bar background + icons + hover frame) ---
     for (auto& b : buttons_)
     {
         if (!b.visible) continue;
-        float x = b.pos.x;
-        float y = b.pos.y;
-        float w = b.size.x;
-        float h = b.size.y;
+        const glm::vec2 p0 = b.pos;
+        const glm::vec2 p1 = b.pos + b.size;
 
         // If this is the special "bar" (texture == 0 and no click)
         if (b.texture == 0 && !b.onClick) {
             // Solid brown/beige bar
-            shader_->SetInt("uHasTexture", 0);
-            shader_->SetVec4("uTint", glm::vec4(0.62f, 0.52f, 0.38f, 0.95f));
-
-            float vertices[6 * 4] = {
-                x,     y,     0.0f, 0.0f,
-                x + w, y,     1.0f, 0.0f,
-                x + w, y + h, 1.0f, 1.0f,
-
-                x,     y,     0.0f, 0.0f,
-                x + w, y + h, 1.0f, 1.0f,
-                x,     y + h, 0.0f, 1.0f
-            };
-
-            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+            pushSolidQuad(out, p0, p1, glm::vec4(0.62f, 0.52f, 0.38f, 0.95f));
             continue;
         }
 
         // Otherwise: normal clickable icon button
 
         // Optional hover frame (slightly bigger solid rect)
-        if (b.hovered) {
-            float fx = x - 4.0f;
-            float fy = y - 4.0f;
-            float fw = w + 8.0f;
-            float fh = h + 8.0f;
-
-            shader_->SetInt("uHasTexture", 0);
-            shader_->SetVec4("uTint", glm::vec4(0.95f, 0.9f, 0.6f, 0.9f));
-
-            float frameVerts[6 * 4] = {
-                fx,     fy,     0.0f, 0.0f,
-                fx+fw,  fy,     1.0f, 0.0f,
-                fx+fw,  fy+fh,  1.0f, 1.0f,
-
-                fx,     fy,     0.0f, 0.0f,
-                fx+fw,  fy+fh,  1.0f, 1.0f,
-                fx,     fy+fh,  0.0f, 1.0f
-            };
-
-            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(frameVerts), frameVerts);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-        }
+        if (b.hovered)
+            pushSolidQuad(out, p0 - glm::vec2(4.0f), p1 + glm::vec2(4.0f), glm::vec4(0.95f, 0.9f, 0.6f, 0.9f));
 
         // Icon itself
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, b.texture);
-
-        shader_->SetInt("uHasTexture", 1);
         glm::vec4 tint = b.hovered
             ? glm::vec4(1.0f, 1.0f, 0.85f, 1.0f)
             : glm::vec4(1.0f);
-        shader_->SetVec4("uTint", tint);
-
-        float vertices[6 * 4] = {
-            x,     y,     0.0f, 0.0f,
-            x + w, y,     1.0f, 0.0f,
-            x + w, y + h, 1.0f, 1.0f,
-
-            x,     y,     0.0f, 0.0f,
-            x + w, y + h, 1.0f, 1.0f,
-            x,     y + h, 0.0f, 1.0f
-        };
-
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        if (b.texture != 0)
+            pushQuad(out, p0, p1, glm::vec2(0.0f), glm::vec2(1.0f), tint, b.texture);
     }
 
     if (selectionRectVisible_)
@@ -238,71 +217,38 @@ void UIManager::render()
         float minY = std::max(0.0f, std::min(selectionRectMin_.y, selectionRectMax_.y));
         float maxY = std::min(static_cast<float>(screenH_), std::max(selectionRectMin_.y, selectionRectMax_.y));
 
-        shader_->SetInt("uHasTexture", 0);
-        shader_->SetVec4("uTint", glm::vec4(0.2f, 0.8f, 0.3f, 0.18f));
-        float fillVerts[6 * 4] = {
-            minX, minY, 0.0f, 0.0f,
-            maxX, minY, 1.0f, 0.0f,
-            maxX, maxY, 1.0f, 1.0f,
-
-            minX, minY, 0.0f, 0.0f,
-            maxX, maxY, 1.0f, 1.0f,
-            minX, maxY, 0.0f, 1.0f
-        };
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(fillVerts), fillVerts);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        pushSolidQuad(out, { minX, minY }, { maxX, maxY }, glm::vec4(0.2f, 0.8f, 0.3f, 0.18f));
 
         const float border = 2.0f;
-        shader_->SetVec4("uTint", glm::vec4(0.3f, 1.0f, 0.45f, 0.85f));
-
-        auto drawBorderQuad = [&](float x0, float y0, float x1, float y1)
-        {
-            float quad[6 * 4] = {
-                x0, y0, 0.0f, 0.0f,
-                x1, y0, 1.0f, 0.0f,
-                x1, y1, 1.0f, 1.0f,
-
-                x0, y0, 0.0f, 0.0f,
-                x1, y1, 1.0f, 1.0f,
-                x0, y1, 0.0f, 1.0f
-            };
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(quad), quad);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-        };
-
-        drawBorderQuad(minX, maxY - border, maxX, maxY); // top
-        drawBorderQuad(minX, minY, maxX, minY + border); // bottom
-        drawBorderQuad(minX, minY, minX + border, maxY); // left
-        drawBorderQuad(maxX - border, minY, maxX, maxY); // right
+        const glm::vec4 borderTint(0.3f, 1.0f, 0.45f, 0.85f);
+        pushSolidQuad(out, { minX, maxY - border }, { maxX, maxY }, borderTint); // top
+        pushSolidQuad(out, { minX, minY }, { maxX, minY + border }, borderTint); // bottom
+        pushSolidQuad(out, { minX, minY }, { minX + border, maxY }, borderTint); // left
+        pushSolidQuad(out, { maxX - border, minY }, { maxX, maxY }, borderTint); // right
     }
 
-    // --- 2) Draw labels using bitmap font ---
-    for (const auto& lbl : labels_) {
-        if (!lbl.visible) continue;
-        drawText(lbl.text, lbl.pos.x, lbl.pos.y, lbl.scale);
+    // --- 2) Labels using bitmap font ---
+    if (fontTex_ != 0)
+    {
+        for (size_t i = 0; i < labels_.size(); ++i)
+        {
+            const UILabel& lbl = labels_[i];
+            if (!lbl.visible) continue;
+            LabelGlyphs& glyphs = labelGlyphs_[i];
+            if (!glyphs.valid)
+            {
+                buildText(lbl.text, lbl.pos.x, lbl.pos.y, lbl.scale, glyphs.vertices);
+                glyphs.valid = true;
+            }
+            pushVertices(out, glyphs.vertices, fontTex_);
+        }
     }
-
-    glBindVertexArray(0);
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
 }
 
-// Basic monospace bitmap font text
-void UIManager::drawText(const std::string& text, float x, float y, float scale)
+void UIManager::buildText(const std::string& text, float x, float y, float scale,
+                          std::vector<UIVertex>& out) const
 {
-    if (!shader_ || fontTex_ == 0) return;
-
-    shader_->Use();
-    shader_->SetMat4("uProj", proj_);
-    shader_->SetInt("uTex", 0);
-    shader_->SetInt("uHasTexture", 1);
-    shader_->SetVec4("uTint", glm::vec4(1.0f)); // white text
-
-    glBindVertexArray(vao_);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fontTex_);
-
+    out.clear();
     float cursorX = x;
     float cursorY = y;
     float finalScale = scale * textScale_;
@@ -321,7 +267,6 @@ void UIManager::drawText(const std::string& text, float x, float y, float scale)
         }
 
         int idx = static_cast<unsigned char>(c);
-        // assuming ASCII starts from row 2 in the atlas (often first rows are control/junk)
         int col = idx % fontCols_;
         int row = idx / fontCols_;
 
@@ -330,29 +275,24 @@ void UIManager::drawText(const std::string& text, float x, float y, float scale)
         float u1 = u0 + 1.0f / (float)fontCols_;
         float v1 = v0 + 1.0f / (float)fontRows_;
 
-        // V flips depending on how your atlas is stored. If upside-down, swap v0/v1.
-        // Here we assume (0,0) is top-left; adjust if needed:
+        // Atlas rows run top-down; flip V for GL.
         v0 = 1.0f - v0;
         v1 = 1.0f - v1;
 
-        float x0 = cursorX;
-        float y0 = cursorY;
-        float x1 = cursorX + cw;
-        float y1 = cursorY + ch;
-
-        float verts[6 * 4] = {
-            x0, y0, u0, v1,
-            x1, y0, u1, v1,
-            x1, y1, u1, v0,
-
-            x0, y0, u0, v1,
-            x1, y1, u1, v0,
-            x0, y1, u0, v0
+        // white text
+        const float x0 = cursorX, y0 = cursorY;
+        const float x1 = cursorX + cw, y1 = cursorY + ch;
+        const glm::vec4 tint(1.0f);
+        const UIVertex quad[6] = {
+            { { x0, y0 }, { u0, v1 }, tint, 1.0f },
+            { { x1, y0 }, { u1, v1 }, tint, 1.0f },
+            { { x1, y1 }, { u1, v0 }, tint, 1.0f },
+
+            { { x0, y0 }, { u0, v1 }, tint, 1.0f },
+            { { x1, y1 }, { u1, v0 }, tint, 1.0f },
+            { { x0, y1 }, { u0, v0 }, tint, 1.0f },
         };
-
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        out.insert(out.end(), quad, quad + 6);
 
         cursorX += cw;
     }
@@ -7,7 +7,6 @@
 #include <string>
 #include <cstddef>
 
-#include "Shader.h"
 #include "UIButton.h"   
 
 struct UILabel
@@ -18,12 +17,38 @@ struct UILabel
     bool visible = true;
 };
 
+// One frame of HUD geometry: every visible quad and glyph in one
+// vertex list plus the runs that share a texture. UIManager::build()
+// fills it on the simulation thread; UIRenderer draws it on the GL
+// thread.
+struct UIDrawList
+{
+    // Tint and the textured flag travel per vertex, so solid quads and
+    // glyphs need no uniform changes between them.
+    struct Vertex {
+        glm::vec2 pos;
+        glm::vec2 uv;
+        glm::vec4 tint;
+        float textured;   // 0 = solid tint, 1 = texture * tint
+    };
+    // Consecutive quads drawn with the same texture (solid quads join
+    // whatever batch is open).
+    struct Batch {
+        GLuint texture;
+        GLint first;
+        GLsizei count;
+    };
+
+    std::vector<Vertex> vertices;
+    std::vector<Batch> batches;
+};
+
 class UIManager
 {
 public:
     UIManager() = default;
 
-    void init(Shader* shader, int screenW, int screenH);
+    void init(int screenW, int screenH);
     void setFontTexture(GLuint tex, int cols = 16, int rows = 16,
                         float charW = 8.0f, float charH = 12.0f);
     void setTextScale(float scale);
@@ -31,6 +56,8 @@ public:
     size_t addButton(const UIButton& btn);
     size_t addLabel(const std::string& text, const glm::vec2& pos,
                     float scale = 1.0f);
+    // No-op when the text is unchanged; otherwise drops the label's
+    // cached glyphs so build() rebuilds them once.
     void setLabelText(size_t index, const std::string& text);
     void setButtonVisibility(size_t index, bool visible);
     void setLabelVisibility(size_t index, bool visible);
@@ -39,21 +66,37 @@ public:
 
     void update(float mouseX, float mouseY);
     bool handleClick(float mouseX, float mouseY);
-    void render();
-
-    void drawText(const std::string& text, float x, float y, float scale = 1.0f);
+    // Writes every visible quad and glyph into `out` (cleared first).
+    // Label glyphs come from the per-label cache. CPU only.
+    void build(UIDrawList& out);
 
 private:
-    Shader* shader_ = nullptr;
-    GLuint vao_ = 0;
-    GLuint vbo_ = 0;
+    using UIVertex = UIDrawList::Vertex;
+    using UIBatch = UIDrawList::Batch;
+    // Glyph quads for one label, built when its text changes and
+    // copied into the draw list every frame after that.
+    struct LabelGlyphs {
+        std::vector<UIVertex> vertices;
+        bool valid = false;
+    };
+
+    static void pushQuad(UIDrawList& out, const glm::vec2& p0, const glm::vec2& p1,
+                         const glm::vec2& uv0, const glm::vec2& uv1,
+                         const glm::vec4& tint, GLuint texture);
+    static void pushSolidQuad(UIDrawList& out, const glm::vec2& p0, const glm::vec2& p1,
+                              const glm::vec4& tint);
+    static void pushVertices(UIDrawList& out, const std::vector<UIVertex>& vertices, GLuint texture);
+    // Basic monospace bitmap font text
+    void buildText(const std::string& text, float x, float y, float scale,
+                   std::vector<UIVertex>& out) const;
+    void invalidateGlyphs();
 
     int screenW_ = 0;
     int screenH_ = 0;
-    glm::mat4 proj_{1.0f};
 
     std::vector<UIButton> buttons_;
     std::vector<UILabel>  labels_;
+    std::vector<LabelGlyphs> labelGlyphs_;   // parallel to labels_
 
     // Bitmap font
     GLuint fontTex_ = 0;
@@ -0,0 +1,84 @@
+#include "UIRenderer.h"
+#include "GLState.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstddef>
+
+UIRenderer::~UIRenderer()
+{
+    if (vbo_) glDeleteBuffers(1, &vbo_);
+    if (vao_) GLState::DeleteVertexArrays(1, &vao_);
+}
+
+void UIRenderer::init(Shader* shader, int screenW, int screenH)
+{
+    shader_ = shader;
+    if (shader_)
+    {
+        uProj_ = shader_->GetUniform<glm::mat4>("uProj");
+        uTex_  = shader_->GetUniform<int>("uTex");
+    }
+
+    proj_ = glm::ortho(0.0f, (float)screenW,
+                       0.0f, (float)screenH);
+
+    // One dynamic vertex buffer for the whole HUD, refilled per frame
+    using Vertex = UIDrawList::Vertex;
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+
+    GLState::BindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+
+    glEnableVertexAttribArray(0); // aPos
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+
+    glEnableVertexAttribArray(1); // aUV
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+
+    glEnableVertexAttribArray(2); // aTint
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tint));
+
+    glEnableVertexAttribArray(3); // aTextured
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, textured));
+
+    GLState::BindVertexArray(0);
+}
+
+void UIRenderer::draw(const UIDrawList& list)
+{
+    if (!shader_ || list.vertices.empty())
+        return;
+
+    using Vertex = UIDrawList::Vertex;
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    if (list.vertices.size() > vboCapacity_)
+        vboCapacity_ = list.vertices.size() + list.vertices.size() / 2;
+    // Orphan so last frame's draws never stall the upload.
+    glBufferData(GL_ARRAY_BUFFER, vboCapacity_ * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, list.vertices.size() * sizeof(Vertex), list.vertices.data());
+
+    GLState::Disable(GL_DEPTH_TEST);
+    GLState::Enable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    shader_->Use();
+    shader_->Set(uProj_, proj_);
+    shader_->Set(uTex_, 0);
+
+    GLState::BindVertexArray(vao_);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLuint bound = 0;
+    for (const UIDrawList::Batch& batch : list.batches)
+    {
+        if (batch.texture != 0 && batch.texture != bound)
+        {
+            GLState::BindTexture(GL_TEXTURE_2D, batch.texture);
+            bound = batch.texture;
+        }
+        glDrawArrays(GL_TRIANGLES, batch.first, batch.count);
+    }
+
+    GLState::BindVertexArray(0);
+    GLState::Disable(GL_BLEND);
+    GLState::Enable(GL_DEPTH_TEST);
+}
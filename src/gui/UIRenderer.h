@@ -0,0 +1,37 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include "Shader.h"
+#include "UIManager.h"
+
+// ============================================================
+// UIRenderer
+// GL side of the HUD: uploads a UIDrawList into one dynamic vertex
+// buffer and draws it with one call per batch, depth test off and
+// alpha blending on. The draw list comes from UIManager::build()
+// (on the simulation thread), so this class owns every GL object
+// the HUD uses and nothing else.
+// ============================================================
+class UIRenderer
+{
+public:
+    UIRenderer() = default;
+    ~UIRenderer();
+    UIRenderer(const UIRenderer&) = delete;
+    UIRenderer& operator=(const UIRenderer&) = delete;
+
+    void init(Shader* shader, int screenW, int screenH);
+    void draw(const UIDrawList& list);
+
+private:
+    Shader* shader_ = nullptr;
+    UniformHandle<glm::mat4> uProj_;
+    UniformHandle<int>       uTex_;
+    GLuint vao_ = 0;
+    GLuint vbo_ = 0;
+    size_t vboCapacity_ = 0;   // in vertices
+    glm::mat4 proj_{1.0f};
+};
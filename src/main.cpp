@@ -1,4 +1,7 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -6,8 +9,11 @@
 #include <glm/gtc/constants.hpp>
 
 #include "core/Scene.h"
+#include "core/SceneConstants.h"
+#include "core/SimulationThread.h"
 #include "core/Camera.h"
-#include "../common/Shader.h"   
+#include "../common/Shader.h"
+#include "../common/GLState.h"
 
 #ifndef ASSET_PATH
 #define ASSET_PATH "assets/"
@@ -15,7 +21,8 @@
 
 // --- Globals ---
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
+uint32_t sampleKeys(GLFWwindow* window);
+void processInput(const SimulationThread::Input& input, float deltaTime);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos);
@@ -26,43 +33,68 @@ Camera camera(glm::vec3(0.0f, 150.0f, 220.0f),
               -90.0f,
               -60.0f);
 
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
-
-// Shadow map globals
-const unsigned int SHADOW_WIDTH = 2048;
-const unsigned int SHADOW_HEIGHT = 2048;
-unsigned int depthMapFBO = 0;
-unsigned int depthMap    = 0;
+// Shadow cascades: a few small maps fitted to the view instead of
+// one large map over the whole island. Each cascade window is 1.5x
+// its slice (so the cached static layer survives panning); the size
+// keeps the texel density of a tight 1024 fit.
+const int   SHADOW_CASCADES     = 3;
+const int   SHADOW_CASCADE_SIZE = 1536;
+const float SHADOW_DISTANCE     = 500.0f;   // world units at 600x600, scaled with the map
 Scene* gScene = nullptr;
+SimulationThread* gSimulation = nullptr;
+
+// Keys the simulation reads; one bit each in Input::keysDown/keysPressed
+enum InputKeys : uint32_t {
+    KeyW         = 1u << 0,
+    KeyS         = 1u << 1,
+    KeyA         = 1u << 2,
+    KeyD         = 1u << 3,
+    KeyBackspace = 1u << 4,
+    KeyC         = 1u << 5,
+    KeyTab       = 1u << 6,
+    KeyT         = 1u << 7,
+    KeyF         = 1u << 8,
+    KeyQ         = 1u << 9,
+    KeyE         = 1u << 10,
+    KeyF3        = 1u << 11,
+};
+
+static const struct { int glfwKey; uint32_t bit; } kTrackedKeys[] = {
+    { GLFW_KEY_W, KeyW }, { GLFW_KEY_S, KeyS }, { GLFW_KEY_A, KeyA }, { GLFW_KEY_D, KeyD },
+    { GLFW_KEY_BACKSPACE, KeyBackspace }, { GLFW_KEY_C, KeyC }, { GLFW_KEY_TAB, KeyTab },
+    { GLFW_KEY_T, KeyT }, { GLFW_KEY_F, KeyF }, { GLFW_KEY_Q, KeyQ }, { GLFW_KEY_E, KeyE },
+    { GLFW_KEY_F3, KeyF3 },
+};
+
+// --map W H   (world units, default 600 600)
+static void parseMapSize(int argc, char** argv, int& width, int& depth)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--map") == 0 && i + 2 < argc)
+        {
+            width = std::atoi(argv[i + 1]);
+            depth = std::atoi(argv[i + 2]);
+            return;
+        }
+    }
+}
 
-void initShadowMap()
+// --water DIV N   (reflection/refraction at 1/DIV resolution, every Nth frame)
+static void parseWaterQuality(int argc, char** argv, int& divisor, int& interval)
 {
-    glGenFramebuffers(1, &depthMapFBO);
-
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
-                 SHADOW_WIDTH, SHADOW_HEIGHT, 0,
-                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                           GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--water") == 0 && i + 2 < argc)
+        {
+            divisor = std::atoi(argv[i + 1]);
+            interval = std::atoi(argv[i + 2]);
+            return;
+        }
+    }
 }
 
-int main()
+int main(int argc, char** argv)
 {
     // 1. Initialize Window & OpenGL
     if (!glfwInit()) return -1;
@@ -89,17 +121,27 @@ int main()
     glewExperimental = GL_TRUE;
     if (glewInit() != GLEW_OK) return -1;
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::Enable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    initShadowMap();
-
     // 2. Create Game Scene
+    int mapWidth = 600, mapDepth = 600;
+    parseMapSize(argc, argv, mapWidth, mapDepth);
+
+    int waterDivisor = SceneConst::kWaterTargetDivisor;
+    int waterInterval = SceneConst::kWaterUpdateInterval;
+    parseWaterQuality(argc, argv, waterDivisor, waterInterval);
+
     Scene gameScene;
-    gScene = &gameScene;   
+    gScene = &gameScene;
+    gameScene.SetMapSize(mapWidth, mapDepth);
+    gameScene.SetWaterQuality(waterDivisor, waterInterval);
     gameScene.Init(&camera);
 
+    // Light and shadow frustum scale with the map (authored for 600x600)
+    const float mapScale = std::max(Terrain::MapWidth(), Terrain::MapDepth()) / Terrain::kLayoutSize;
+
     // 3. Load Shaders
     Shader terrainShader(std::string(ASSET_PATH) + "shaders/terrain.vert",
                          std::string(ASSET_PATH) + "shaders/terrain.frag");
@@ -111,99 +153,152 @@ int main()
                        std::string(ASSET_PATH) + "shaders/shadow_depth.frag");
 
     // 🌞 FIX #2 — Better light for visible shadows
-    glm::vec3 lightPos(-200.0f, 300.0f, -200.0f);
+    glm::vec3 lightPos = glm::vec3(-200.0f, 300.0f, -200.0f) * mapScale;
+    const glm::vec3 lightDir = glm::normalize(-lightPos);   // sun aims at the map centre
+
+    ShadowCascades shadowCascades;
+    shadowCascades.Init(SHADOW_CASCADE_SIZE, SHADOW_CASCADES);
 
     // 4. Game Loop
+    // The simulation ticks on its own thread (input, Update, snapshot);
+    // this thread polls GLFW and draws the newest snapshot.
+    SimulationThread simulation(gameScene, camera, processInput);
+    gSimulation = &simulation;
+    simulation.Start();
+
     while (!glfwWindowShouldClose(window)) {
-        // Time Logic
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        // Input
-        processInput(window);
-        gameScene.Update(deltaTime, camera);
-
-        // --- Compute light-space matrix for directional light ---
-        float orthoSize = 350.0f;  //// FIX #3 — cover entire terrain
-        glm::mat4 lightProjection = glm::ortho(-orthoSize, orthoSize,
-                                               -orthoSize, orthoSize,
-                                               1.0f, 800.0f);
-        glm::mat4 lightView = glm::lookAt(lightPos,
-                                          glm::vec3(0.0f, 0.0f, 0.0f),
-                                          glm::vec3(0.0f, 1.0f, 0.0f));
-
-        glm::mat4 lightSpaceMatrix = lightProjection * lightView;
-
-        // ----------------- 1) Depth map pass -----------------
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
+        GLState::ResetStats();
 
+        // Input: callbacks queue events, keys are sampled once per frame
+        glfwPollEvents();
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, true);
+
+        int fbW, fbH;
+        glfwGetFramebufferSize(window, &fbW, &fbH);
+        glfwGetWindowSize(window, &winW, &winH);
+        simulation.SubmitFrame(sampleKeys(window), fbW, fbH, winW, winH);
+
+        const RenderSnapshot* snapshot = simulation.AcquireSnapshot();
+        if (!snapshot)
+        {
+            // First tick still running
+            glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glfwSwapBuffers(window);
+            continue;
+        }
+        gameScene.BeginFrame(*snapshot);
+
+        const glm::mat4& view = snapshot->view;
+        const glm::mat4& projection = snapshot->projection;
+        const float aspect = projection[1][1] / projection[0][0];
+
+        // --- Fit shadow cascades to the camera frustum ---
+        shadowCascades.Update(view, glm::radians(SceneConst::kViewFovDegrees), aspect, SceneConst::kViewNear,
+                              SHADOW_DISTANCE * mapScale, lightDir, 800.0f * mapScale);
+
+        // One upload of the shared camera/light blocks for all passes
+        gameScene.UpdateFrameUniforms(view, projection, snapshot->viewPos, shadowCascades, lightPos);
+        gameScene.UpdateSkinnedVertices(projection * view, shadowCascades);
+
+        // ----------------- 1) Depth map pass (per cascade) -----------------
+        // Static casters only when the cached layer is stale, then the
+        // dynamic ones on top of a copy of it.
         depthShader.Use();
-        depthShader.SetMat4("lightSpaceMatrix", lightSpaceMatrix);
-        gameScene.DrawDepth(depthShader, lightSpaceMatrix);
+        for (int cascade = 0; cascade < shadowCascades.GetCount(); ++cascade)
+        {
+            const glm::mat4& cascadeMatrix = shadowCascades.GetMatrix(cascade);
+            if (shadowCascades.BeginStaticCascade(cascade, snapshot->staticShadowKey))
+                gameScene.DrawStaticDepth(depthShader, cascadeMatrix, cascade);
+            shadowCascades.BeginCascade(cascade);
+            gameScene.DrawDepth(depthShader, cascadeMatrix, cascade);
+        }
+        shadowCascades.End();
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        // ----------------- 2) Water reflection / refraction -----------------
+        gameScene.DrawWaterTargets(terrainShader, objectShader, fbW, fbH, shadowCascades.GetTexture());
 
         //// FIX #1 — RESTORE SCREEN VIEWPORT correctly
-        int fbW, fbH;
-        glfwGetFramebufferSize(window, &fbW, &fbH);
         glViewport(0, 0, fbW, fbH);
 
-        // ----------------- 2) Normal render pass -----------------
+        // ----------------- 3) Normal render pass -----------------
         glClearColor(0.5f, 0.7f, 1.0f, 1.0f);  // Sky Blue
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::mat4 view = camera.GetViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f),
-                                                float(fbW) / float(fbH),
-                                                0.1f, 3000.0f);
-
         // Draw Scene with shadow map
         gameScene.Draw(terrainShader,
                        objectShader,
                        view,
                        projection,
-                       lightPos,
-                       camera.Position,
-                       lightSpaceMatrix,
-                       depthMap);
+                       snapshot->viewPos,
+                       shadowCascades.GetTexture());
 
         glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
+    simulation.Stop();
+    gSimulation = nullptr;
+    shadowCascades.Shutdown();
     glfwTerminate();
     return 0;
 }
 
 // ------------- Input & Callbacks -------------
 
-void processInput(GLFWwindow *window)
+uint32_t sampleKeys(GLFWwindow* window)
 {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
+    uint32_t keys = 0;
+    for (const auto& key : kTrackedKeys)
+    {
+        if (glfwGetKey(window, key.glfwKey) == GLFW_PRESS)
+            keys |= key.bit;
+    }
+    return keys;
+}
+
+// Runs on the simulation thread, once per tick before Scene::Update.
+void processInput(const SimulationThread::Input& input, float deltaTime)
+{
+    if (!gScene)
+        return;
 
-    bool unitCamActive = gScene && gScene->IsUnitCameraActive();
+    for (const SimulationThread::InputEvent& event : input.events)
+    {
+        switch (event.type)
+        {
+        case SimulationThread::InputEvent::Type::CursorPos:
+            gScene->onMouseMove(event.x, event.y);
+            break;
+        case SimulationThread::InputEvent::Type::MouseButton:
+            gScene->onMouseButton(event.button, event.action, event.mods);
+            break;
+        case SimulationThread::InputEvent::Type::Scroll:
+            camera.ProcessMouseScroll(static_cast<float>(event.y));
+            break;
+        }
+    }
+
+    const uint32_t down = input.keysDown;
+    bool unitCamActive = gScene->IsUnitCameraActive();
 
     if (!unitCamActive)
     {
         bool isMoving = false;
 
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+        if (down & KeyW) {
             camera.ProcessKeyboard(FORWARD, deltaTime);
             isMoving = true;
         }
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+        if (down & KeyS) {
             camera.ProcessKeyboard(BACKWARD, deltaTime);
             isMoving = true;
         }
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+        if (down & KeyA) {
             camera.ProcessKeyboard(LEFT, deltaTime);
             isMoving = true;
         }
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+        if (down & KeyD) {
             camera.ProcessKeyboard(RIGHT, deltaTime);
             isMoving = true;
         }
@@ -211,105 +306,77 @@ void processInput(GLFWwindow *window)
         if (!isMoving)
             camera.ResetSpeed();
     }
-    else if (gScene)
+    else
     {
         const float rotSpeed = 60.0f; // degrees per second
         float yawDelta = 0.0f;
         float pitchDelta = 0.0f;
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        if (down & KeyA)
             yawDelta -= rotSpeed * deltaTime;
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        if (down & KeyD)
             yawDelta += rotSpeed * deltaTime;
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        if (down & KeyW)
             pitchDelta += rotSpeed * deltaTime;
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        if (down & KeyS)
             pitchDelta -= rotSpeed * deltaTime;
         if (yawDelta != 0.0f || pitchDelta != 0.0f)
             gScene->RotateUnitCamera(yawDelta, pitchDelta);
     }
 
-    static bool backspaceDown = false;
-    int backspaceState = glfwGetKey(window, GLFW_KEY_BACKSPACE);
-    bool backspacePressed = (backspaceState == GLFW_PRESS);
-    if (backspacePressed && !backspaceDown && gScene)
-    {
+    // Edge-triggered actions
+    const uint32_t pressed = input.keysPressed;
+    if (pressed & KeyBackspace)
         gScene->cancelCurrentAction();
-    }
-    backspaceDown = backspacePressed;
-
-    static bool cDown = false;
-    int cState = glfwGetKey(window, GLFW_KEY_C);
-    bool cPressed = (cState == GLFW_PRESS);
-    if (cPressed && !cDown && gScene)
-    {
+    if (pressed & KeyC)
         gScene->toggleUnitCamera();
-    }
-    cDown = cPressed;
-
-    static bool tabDown = false;
-    int tabState = glfwGetKey(window, GLFW_KEY_TAB);
-    bool tabPressed = (tabState == GLFW_PRESS);
-    if (tabPressed && !tabDown && gScene)
-    {
+    if (pressed & KeyTab)
         gScene->switchActivePlayer();
-    }
-    tabDown = tabPressed;
-
-    static bool tDown = false;
-    int tState = glfwGetKey(window, GLFW_KEY_T);
-    bool tPressed = (tState == GLFW_PRESS);
-    if (tPressed && !tDown && gScene)
-    {
+    if (pressed & KeyT)
         gScene->focusCameraOnTownCenter();
-    }
-    tDown = tPressed;
-
-    static bool fDown = false;
-    int fState = glfwGetKey(window, GLFW_KEY_F);
-    bool fPressed = (fState == GLFW_PRESS);
-    if (fPressed && !fDown && gScene)
-    {
+    if (pressed & KeyF)
         gScene->toggleFogReveal();
-    }
-    fDown = fPressed;
-
-    static bool qDown = false;
-    int qState = glfwGetKey(window, GLFW_KEY_Q);
-    bool qPressed = (qState == GLFW_PRESS);
-    if (qPressed && !qDown && gScene)
-    {
+    if (pressed & KeyQ)
         gScene->rotatePlacementPreview(glm::radians(-15.0f));
-    }
-    qDown = qPressed;
-
-    static bool eDown = false;
-    int eState = glfwGetKey(window, GLFW_KEY_E);
-    bool ePressed = (eState == GLFW_PRESS);
-    if (ePressed && !eDown && gScene)
-    {
+    if (pressed & KeyE)
         gScene->rotatePlacementPreview(glm::radians(15.0f));
-    }
-    eDown = ePressed;
+    if (pressed & KeyF3)
+        gScene->cycleDebugOverlay();
 }
 
-void scroll_callback(GLFWwindow* /*window*/, double /*xoffset*/, double yoffset)
+// GLFW callbacks run on the main thread; they only queue events for
+// the simulation.
+void scroll_callback(GLFWwindow* /*window*/, double xoffset, double yoffset)
 {
-    camera.ProcessMouseScroll(static_cast<float>(yoffset));
+    if (!gSimulation) return;
+    SimulationThread::InputEvent event;
+    event.type = SimulationThread::InputEvent::Type::Scroll;
+    event.x = xoffset;
+    event.y = yoffset;
+    gSimulation->PushEvent(event);
 }
 
 void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height)
 {
     glViewport(0, 0, width, height);
 }
-void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
+void cursor_position_callback(GLFWwindow* /*window*/, double xpos, double ypos)
 {
-    if (gScene)
-        gScene->onMouseMove(xpos, ypos);
+    if (!gSimulation) return;
+    SimulationThread::InputEvent event;
+    event.type = SimulationThread::InputEvent::Type::CursorPos;
+    event.x = xpos;
+    event.y = ypos;
+    gSimulation->PushEvent(event);
 }
 
 // ⭐ NEW: Pass clicks to Scene (for UI clicks & Building Placement)
-void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+void mouse_button_callback(GLFWwindow* /*window*/, int button, int action, int mods)
 {
-    if (!gScene) return;
-    gScene->onMouseButton(button, action, mods);
+    if (!gSimulation) return;
+    SimulationThread::InputEvent event;
+    event.type = SimulationThread::InputEvent::Type::MouseButton;
+    event.button = button;
+    event.action = action;
+    event.mods = mods;
+    gSimulation->PushEvent(event);
 }
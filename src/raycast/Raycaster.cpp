@@ -4,6 +4,7 @@
 #include <iostream>
 #include "Camera.h"  // adjust include path
 #include "Terrain.h" // adjust include path
+#include "SceneConstants.h"
 
 Ray Raycaster::screenPointToRay(
     float screenX, float screenY,
@@ -15,10 +16,10 @@ Ray Raycaster::screenPointToRay(
     float y = (2.0f * screenY) / windowHeight - 1.0f;
     glm::vec4 rayNDC(x, y, -1.0f, 1.0f);
 
-    // FIX: Calculate Projection Matrix here using window dims and camera Zoom
+    // Same projection as the render snapshot (SceneConst kView*)
     float aspect = (float)windowWidth / (float)windowHeight;
-    // Ensure near/far planes match your main render loop (e.g., 0.1f, 1000.0f)
-    glm::mat4 proj = glm::perspective(glm::radians(camera.Zoom), aspect, 0.1f, 3000.0f);
+    glm::mat4 proj = glm::perspective(glm::radians(SceneConst::kViewFovDegrees), aspect,
+                                      SceneConst::kViewNear, SceneConst::kViewFar);
 
     glm::mat4 view = camera.GetViewMatrix();
     glm::mat4 invVP = glm::inverse(proj * view);
@@ -0,0 +1,155 @@
+#include "BillboardImpostor.h"
+#include "../../common/Shader.h"
+#include "../../common/GLState.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+BillboardImpostor::~BillboardImpostor()
+{
+    if (texture_) GLState::DeleteTextures(1, &texture_);
+    if (quadVBO_) glDeleteBuffers(1, &quadVBO_);
+    if (quadVAO_) GLState::DeleteVertexArrays(1, &quadVAO_);
+}
+
+bool BillboardImpostor::Bake(Model& model, Shader& bakeShader, int resolution)
+{
+    const glm::vec3 bmin = model.GetBoundsMin();
+    const glm::vec3 bmax = model.GetBoundsMax();
+    if (resolution <= 0 || bmax.y <= bmin.y)
+        return false;
+
+    // Instances rotate about the model's Y axis, so the quad has to
+    // cover the widest horizontal reach from that axis.
+    const float halfWidth = std::max(std::max(std::abs(bmin.x), std::abs(bmax.x)),
+                                     std::max(std::abs(bmin.z), std::abs(bmax.z)));
+    if (halfWidth <= 0.0f)
+        return false;
+    size_ = glm::vec2(halfWidth * 2.0f, bmax.y - bmin.y);
+    base_ = bmin.y;
+
+    if (!texture_)
+        glGenTextures(1, &texture_);
+    GLState::BindTexture(GL_TEXTURE_2D, texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, resolution, resolution, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    GLuint depth = 0;
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, resolution, resolution);
+
+    GLint prevFbo = 0;
+    GLint prevViewport[4] = {};
+    GLfloat prevClear[4] = {};
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFbo);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, prevClear);
+
+    GLuint fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (complete)
+    {
+        glViewport(0, 0, resolution, resolution);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        GLState::Enable(GL_DEPTH_TEST);
+        GLState::Disable(GL_BLEND);
+        GLState::Disable(GL_CULL_FACE);
+
+        // Side view along -Z; view-space Y equals object Y.
+        const float eyeDist = halfWidth + 1.0f;
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, eyeDist), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 proj = glm::ortho(-halfWidth, halfWidth, bmin.y, bmax.y, 0.01f, eyeDist + halfWidth + 1.0f);
+
+        bakeShader.Use();
+        bakeShader.SetMat4("mvp", proj * view);
+        bakeShader.SetVec3("uLightDir", glm::normalize(glm::vec3(0.4f, 0.8f, 0.6f)));
+        bakeShader.SetInt("texture_diffuse1", 0);
+        model.Draw(bakeShader);
+
+        GLState::Enable(GL_CULL_FACE);
+    }
+    else
+    {
+        std::cerr << "[Impostor] bake framebuffer incomplete" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevFbo));
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glClearColor(prevClear[0], prevClear[1], prevClear[2], prevClear[3]);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &depth);
+
+    if (!complete)
+    {
+        GLState::DeleteTextures(1, &texture_);
+        texture_ = 0;
+        return false;
+    }
+
+    GLState::BindTexture(GL_TEXTURE_2D, texture_);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    GLState::BindTexture(GL_TEXTURE_2D, 0);
+
+    createQuad();
+    return true;
+}
+
+void BillboardImpostor::createQuad()
+{
+    if (quadVAO_)
+        return;
+
+    // x in [-0.5, 0.5] across, y in [0, 1] up (triangle strip)
+    const float corners[] = {
+        -0.5f, 0.0f,
+         0.5f, 0.0f,
+        -0.5f, 1.0f,
+         0.5f, 1.0f,
+    };
+
+    glGenVertexArrays(1, &quadVAO_);
+    glGenBuffers(1, &quadVBO_);
+    GLState::BindVertexArray(quadVAO_);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    GLState::BindVertexArray(0);
+}
+
+void BillboardImpostor::Draw(Shader& shader, GLuint instanceBuffer, const std::vector<InstanceSpan>& spans) const
+{
+    if (!texture_ || !quadVAO_ || !instanceBuffer || spans.empty())
+        return;
+
+    shader.SetVec2("uImpostorSize", size_);
+    shader.SetFloat("uImpostorBase", base_);
+    shader.SetInt("uImpostor", 0);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, texture_);
+
+    GLState::BindVertexArray(quadVAO_);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    for (const InstanceSpan& span : spans)
+    {
+        if (span.count <= 0) continue;
+        // No base-instance draws in GL 4.1: offset the attribute instead.
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4),
+                              (void*)(static_cast<size_t>(span.first) * sizeof(glm::vec4)));
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, span.count);
+    }
+    GLState::BindVertexArray(0);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "../../common/Model.h"
+
+class Shader;
+
+// ============================================================
+// BillboardImpostor
+// Single-view impostor for a roughly axially symmetric model
+// (trees). Bake() renders the model once, orthographically from
+// the side, into an RGBA texture; Draw() expands vec4(pos, scale)
+// instances into Y-axis (cylindrical) billboards of the same size.
+// ============================================================
+class BillboardImpostor {
+public:
+    BillboardImpostor() = default;
+    ~BillboardImpostor();
+    BillboardImpostor(const BillboardImpostor&) = delete;
+    BillboardImpostor& operator=(const BillboardImpostor&) = delete;
+
+    // `bakeShader` is impostor_bake.vert/.frag. Restores the bound
+    // framebuffer and viewport.
+    bool Bake(Model& model, Shader& bakeShader, int resolution);
+
+    // `shader` is impostor.vert/.frag, already in use with view,
+    // projection and viewPos set. `instanceBuffer` holds vec4 per
+    // instance (see VegetationLayer).
+    void Draw(Shader& shader, GLuint instanceBuffer, const std::vector<InstanceSpan>& spans) const;
+
+    bool IsValid() const { return texture_ != 0; }
+
+private:
+    GLuint texture_ = 0;
+    GLuint quadVAO_ = 0;
+    GLuint quadVBO_ = 0;
+    glm::vec2 size_{1.0f};   // object-space width, height
+    float base_ = 0.0f;      // object-space bottom
+
+    void createQuad();
+};
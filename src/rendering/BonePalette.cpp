@@ -0,0 +1,78 @@
+#include "BonePalette.h"
+#include "../../common/GLState.h"
+#include <algorithm>
+
+BonePalette::~BonePalette()
+{
+    if (texture_) GLState::DeleteTextures(1, &texture_);
+    if (buffer_) glDeleteBuffers(1, &buffer_);
+}
+
+void BonePalette::Reserve(size_t matrices)
+{
+    if (matrices > matrices_.size())
+        matrices_.resize(matrices, glm::mat4(1.0f));
+}
+
+void BonePalette::Write(int base, const glm::mat4* bones, int count)
+{
+    if (base < 0 || count <= 0)
+        return;
+    const size_t begin = static_cast<size_t>(base);
+    const size_t end = begin + static_cast<size_t>(count);
+    if (end > matrices_.size())
+        return;
+    std::copy(bones, bones + count, matrices_.begin() + static_cast<std::ptrdiff_t>(begin));
+    dirty_.emplace_back(begin, end);
+}
+
+void BonePalette::Upload()
+{
+    if (buffer_ == 0)
+    {
+        glGenBuffers(1, &buffer_);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer_);   // creates the object for glTexBuffer
+        glGenTextures(1, &texture_);
+        GLState::BindTexture(GL_TEXTURE_BUFFER, texture_);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer_);
+        GLState::BindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    if (matrices_.empty())
+        return;
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_);
+    if (matrices_.size() > capacity_)
+    {
+        // Grow with headroom and send the whole copy once.
+        capacity_ = matrices_.size() + matrices_.size() / 2;
+        glBufferData(GL_TEXTURE_BUFFER, capacity_ * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, matrices_.size() * sizeof(glm::mat4), matrices_.data());
+    }
+    else if (!dirty_.empty())
+    {
+        // Neighbouring units' ranges are usually adjacent: merge them
+        // so a tier updated together goes up in a few calls.
+        std::sort(dirty_.begin(), dirty_.end());
+        size_t begin = dirty_.front().first;
+        size_t end = dirty_.front().second;
+        auto flush = [this](size_t from, size_t to)
+        {
+            glBufferSubData(GL_TEXTURE_BUFFER, from * sizeof(glm::mat4),
+                            (to - from) * sizeof(glm::mat4), matrices_.data() + from);
+        };
+        for (size_t i = 1; i < dirty_.size(); ++i)
+        {
+            if (dirty_[i].first <= end)
+            {
+                end = std::max(end, dirty_[i].second);
+                continue;
+            }
+            flush(begin, end);
+            begin = dirty_[i].first;
+            end = dirty_[i].second;
+        }
+        flush(begin, end);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    dirty_.clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// ============================================================
+// BonePalette
+// One texture buffer holding the skinning matrices of every visible
+// CPU-skinned unit. Each unit keeps its range between frames (the
+// simulation assigns the ranges, see Scene::writeUnitPose), so a
+// unit whose pose did not change costs nothing: Write() records the
+// changed ranges and Upload() sends only those.
+//
+// The range base reaches the vertex shader as uBoneBase (individual
+// draws) or iBoneBase (instanced, location 10). Bone i of a unit
+// lives at texels (base + i) * 4 .. +3.
+// ============================================================
+class BonePalette {
+public:
+    BonePalette() = default;
+    ~BonePalette();
+    BonePalette(const BonePalette&) = delete;
+    BonePalette& operator=(const BonePalette&) = delete;
+
+    // Grows the palette to at least `matrices`; contents are kept.
+    void Reserve(size_t matrices);
+    // Replaces `count` matrices from `base` (inside the reserved size).
+    void Write(int base, const glm::mat4* bones, int count);
+    // Sends the ranges written since the last upload (everything when
+    // the buffer had to grow).
+    void Upload();
+
+    GLuint GetTexture() const { return texture_; }
+    size_t GetMatrixCount() const { return matrices_.size(); }
+
+private:
+    std::vector<glm::mat4> matrices_;                   // CPU copy of the buffer
+    std::vector<std::pair<size_t, size_t>> dirty_;      // [begin, end) in matrices
+    GLuint buffer_ = 0;
+    GLuint texture_ = 0;
+    size_t capacity_ = 0;   // in matrices
+};
@@ -0,0 +1,111 @@
+#include "DebugDraw.h"
+#include "../../common/Shader.h"
+#include "../../common/GLState.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+DebugDraw::~DebugDraw()
+{
+    if (vbo_) glDeleteBuffers(1, &vbo_);
+    if (vao_) GLState::DeleteVertexArrays(1, &vao_);
+}
+
+void DebugDraw::ensureObjects()
+{
+    if (vao_ != 0)
+        return;
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    GLState::BindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glEnableVertexAttribArray(0); // aPos
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+    glEnableVertexAttribArray(1); // aColor
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    GLState::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void DebugGeometry::Line(const glm::vec3& a, const glm::vec3& b, const glm::vec4& color)
+{
+    lines_.push_back({ a, color });
+    lines_.push_back({ b, color });
+}
+
+void DebugGeometry::Circle(const glm::vec3& center, float radius, const glm::vec4& color, int segments)
+{
+    segments = std::max(segments, 3);
+    const float step = glm::two_pi<float>() / static_cast<float>(segments);
+    glm::vec3 prev = center + glm::vec3(radius, 0.0f, 0.0f);
+    for (int i = 1; i <= segments; ++i)
+    {
+        const float angle = step * static_cast<float>(i);
+        const glm::vec3 next = center + glm::vec3(std::cos(angle) * radius, 0.0f, std::sin(angle) * radius);
+        Line(prev, next, color);
+        prev = next;
+    }
+}
+
+void DebugGeometry::Quad(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d,
+                     const glm::vec4& color)
+{
+    const Vertex quad[6] = {
+        { a, color }, { b, color }, { c, color },
+        { a, color }, { c, color }, { d, color },
+    };
+    triangles_.insert(triangles_.end(), quad, quad + 6);
+}
+
+void DebugGeometry::Cell(const glm::vec3& center, float halfSize, const glm::vec4& color)
+{
+    Quad(center + glm::vec3(-halfSize, 0.0f, -halfSize),
+         center + glm::vec3( halfSize, 0.0f, -halfSize),
+         center + glm::vec3( halfSize, 0.0f,  halfSize),
+         center + glm::vec3(-halfSize, 0.0f,  halfSize),
+         color);
+}
+
+void DebugGeometry::Clear()
+{
+    triangles_.clear();
+    lines_.clear();
+}
+
+void DebugDraw::Draw(Shader& shader, const DebugGeometry& geometry)
+{
+    if (geometry.Empty())
+        return;
+    ensureObjects();
+
+    const std::vector<Vertex>& triangles = geometry.GetTriangles();
+    const std::vector<Vertex>& lines = geometry.GetLines();
+    const size_t total = triangles.size() + lines.size();
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    if (total > capacity_)
+        capacity_ = total + total / 2;
+    // Orphan so last frame's draws never stall the upload.
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, triangles.size() * sizeof(Vertex), triangles.data());
+    glBufferSubData(GL_ARRAY_BUFFER, triangles.size() * sizeof(Vertex),
+                    lines.size() * sizeof(Vertex), lines.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    shader.Use();
+    GLState::Enable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::DepthMask(GL_FALSE);
+    GLState::Disable(GL_CULL_FACE);
+
+    GLState::BindVertexArray(vao_);
+    if (!triangles.empty())
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(triangles.size()));
+    if (!lines.empty())
+        glDrawArrays(GL_LINES, static_cast<GLint>(triangles.size()), static_cast<GLsizei>(lines.size()));
+    GLState::BindVertexArray(0);
+
+    GLState::Enable(GL_CULL_FACE);
+    GLState::DepthMask(GL_TRUE);
+    GLState::Disable(GL_BLEND);
+}
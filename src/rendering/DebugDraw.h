@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class Shader;
+
+// ============================================================
+// DebugGeometry
+// World-space overlay primitives for profiling views (nav grid,
+// paths, fog), appended to CPU vertex lists. Scene builds them on
+// the simulation thread straight into the RenderSnapshot; DebugDraw
+// draws them on the GL thread.
+// ============================================================
+class DebugGeometry {
+public:
+    struct Vertex {
+        glm::vec3 pos;
+        glm::vec4 color;
+    };
+
+    void Line(const glm::vec3& a, const glm::vec3& b, const glm::vec4& color);
+    // Outline in the XZ plane at center.y.
+    void Circle(const glm::vec3& center, float radius, const glm::vec4& color, int segments = 24);
+    // Filled quad, corners in winding order.
+    void Quad(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d,
+              const glm::vec4& color);
+    // Filled axis-aligned square in the XZ plane at center.y.
+    void Cell(const glm::vec3& center, float halfSize, const glm::vec4& color);
+
+    bool Empty() const { return lines_.empty() && triangles_.empty(); }
+    void Clear();
+
+    const std::vector<Vertex>& GetTriangles() const { return triangles_; }
+    const std::vector<Vertex>& GetLines() const { return lines_; }
+
+private:
+    std::vector<Vertex> triangles_;
+    std::vector<Vertex> lines_;
+};
+
+// ============================================================
+// DebugDraw
+// Uploads a DebugGeometry into one buffer and draws every filled
+// quad in one call and every line in another.
+// ============================================================
+class DebugDraw {
+public:
+    DebugDraw() = default;
+    ~DebugDraw();
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    // `shader` is debug.vert/.frag; FrameBlock supplies the camera.
+    // Draws blended, depth-tested without depth writes.
+    void Draw(Shader& shader, const DebugGeometry& geometry);
+
+private:
+    using Vertex = DebugGeometry::Vertex;
+
+    GLuint vao_ = 0;
+    GLuint vbo_ = 0;
+    size_t capacity_ = 0;   // in vertices
+
+    void ensureObjects();
+};
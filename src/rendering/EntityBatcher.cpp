@@ -0,0 +1,123 @@
+#include "EntityBatcher.h"
+#include "../../common/Shader.h"
+#include <cstddef>
+
+EntityBatcher::~EntityBatcher()
+{
+    if (buffer_) glDeleteBuffers(1, &buffer_);
+}
+
+void EntityBatcher::Begin()
+{
+    for (Group& group : groups_)
+        group.instances.clear();
+    instanceCount_ = 0;
+}
+
+void EntityBatcher::Add(Model* model, const glm::mat4& transform, const glm::vec4& tint,
+                        int boneBase, GLuint boneTexture, bool preskinned)
+{
+    if (!model || tint.a <= 0.0f)
+        return;
+
+    const bool translucent = tint.a < 1.0f;
+    const bool skinned = boneBase >= 0 && !preskinned;
+    // A handful of distinct models per frame; a linear scan beats hashing.
+    Group* target = nullptr;
+    for (Group& group : groups_)
+    {
+        if (group.model == model && group.translucent == translucent
+            && group.skinned == skinned && group.preskinned == preskinned
+            && group.boneTexture == boneTexture)
+        {
+            target = &group;
+            break;
+        }
+    }
+    if (!target)
+    {
+        groups_.push_back(Group());
+        target = &groups_.back();
+        target->model = model;
+        target->translucent = translucent;
+        target->skinned = skinned;
+        target->preskinned = preskinned;
+        target->boneTexture = boneTexture;
+    }
+
+    target->instances.push_back({ transform, tint, boneBase, { 0, 0, 0 } });
+    ++instanceCount_;
+}
+
+void EntityBatcher::upload()
+{
+    staging_.clear();
+    staging_.reserve(instanceCount_);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (Group& group : groups_)
+        {
+            if (group.instances.empty() || group.translucent != (pass == 1))
+                continue;
+            group.first = static_cast<GLint>(staging_.size());
+            staging_.insert(staging_.end(), group.instances.begin(), group.instances.end());
+        }
+    }
+
+    if (buffer_ == 0)
+        glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+    const size_t bytes = staging_.size() * sizeof(Instance);
+    if (bytes > capacity_)
+        capacity_ = bytes + bytes / 2;
+    // Always orphan: the depth pass of this frame may still read the old data.
+    glBufferData(GL_ARRAY_BUFFER, capacity_, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, staging_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void EntityBatcher::Flush(Shader& shader, GLuint paletteTexture)
+{
+    if (instanceCount_ == 0)
+        return;
+
+    upload();
+
+    InstanceLayout layout;
+    layout.stride = sizeof(Instance);
+    layout.tintOffset = static_cast<GLint>(offsetof(Instance, tint));
+    layout.boneBaseOffset = static_cast<GLint>(offsetof(Instance, boneBase));
+
+    shader.SetBool("isInstanced", true);
+    shader.SetBool("uInstanceTint", true);
+    shader.SetFloat("uAlpha", 1.0f);
+
+    GLuint boundBones = paletteTexture;
+    std::vector<InstanceSpan> span(1);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (Group& group : groups_)
+        {
+            if (group.instances.empty() || group.translucent != (pass == 1))
+                continue;
+            const GLuint bones = group.boneTexture ? group.boneTexture : paletteTexture;
+            if (group.skinned && bones != boundBones)
+            {
+                shader.BindBoneTexture(bones, 0);
+                boundBones = bones;
+            }
+            shader.SetBool("uUseSkinning", group.skinned);
+            shader.SetBool("uPreskinned", group.preskinned);
+            shader.SetInt("uBoneCount", group.skinned ? static_cast<int>(group.model->GetBoneCount()) : 0);
+            span[0] = { group.first, static_cast<GLsizei>(group.instances.size()) };
+            group.model->DrawInstancedSpans(shader, buffer_, span, layout);
+        }
+    }
+
+    if (boundBones != paletteTexture)
+        shader.BindBoneTexture(paletteTexture, 0);
+    shader.SetBool("uUseSkinning", false);
+    shader.SetBool("uPreskinned", false);
+    shader.SetBool("uInstanceTint", false);
+    shader.SetBool("isInstanced", false);
+}
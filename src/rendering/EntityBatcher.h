@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "../../common/Model.h"
+
+class Shader;
+
+// ============================================================
+// EntityBatcher
+// Per-frame instancing for units and buildings. Entities append
+// (model, transform, tint) records between Begin() and Flush();
+// records are grouped by Model and by opaque/translucent state
+// (construction fades) and skinning, written to one instance buffer
+// in a single upload, and drawn with one instanced call per mesh
+// range per group.
+//
+// Tint is rgb multiply + alpha and reaches simple.frag through the
+// iTint attribute (location 9). Skinned records carry a bone base as
+// iBoneBase (location 10): an offset into the frame's BonePalette, or,
+// for models with baked animations, into the model's own baked
+// texture. Records are grouped by the bone texture they read.
+// Preskinned records (SkinningPrepass) carry their vertex base in the
+// same slot and are drawn with uPreskinned instead of uUseSkinning.
+// ============================================================
+class EntityBatcher {
+public:
+    struct Instance {
+        glm::mat4 model;
+        glm::vec4 tint;
+        int32_t boneBase;
+        int32_t pad[3];
+    };
+
+    EntityBatcher() = default;
+    ~EntityBatcher();
+    EntityBatcher(const EntityBatcher&) = delete;
+    EntityBatcher& operator=(const EntityBatcher&) = delete;
+
+    void Begin();
+    // boneTexture 0 = the frame palette passed to Flush(). With
+    // `preskinned`, boneBase is a SkinningPrepass vertex base.
+    void Add(Model* model, const glm::mat4& transform, const glm::vec4& tint = glm::vec4(1.0f),
+             int boneBase = -1, GLuint boneTexture = 0, bool preskinned = false);
+
+    // Opaque groups first, then translucent ones. Expects
+    // `paletteTexture` bound to the bone unit and leaves it bound, with
+    // isInstanced/uInstanceTint/uUseSkinning/uPreskinned off for
+    // individual draws. The skinned vertex texture is bound by the caller.
+    void Flush(Shader& shader, GLuint paletteTexture);
+
+    size_t GetInstanceCount() const { return instanceCount_; }
+
+private:
+    struct Group {
+        Model* model = nullptr;
+        bool translucent = false;
+        bool skinned = false;
+        bool preskinned = false;
+        GLuint boneTexture = 0;
+        std::vector<Instance> instances;
+        GLint first = 0;
+    };
+
+    // Groups persist across frames so their vectors keep capacity.
+    std::vector<Group> groups_;
+    std::vector<Instance> staging_;
+    size_t instanceCount_ = 0;
+    GLuint buffer_ = 0;
+    size_t capacity_ = 0;
+
+    void upload();
+};
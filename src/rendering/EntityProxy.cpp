@@ -0,0 +1,90 @@
+#include "EntityProxy.h"
+#include "EntityBatcher.h"
+#include "../../common/Model.h"
+#include "../../common/Shader.h"
+#include "../../common/GLState.h"
+
+// Skinned units batch too: each instance carries its palette offset,
+// its own frame in the model's baked texture, or its preskinned
+// vertex base.
+bool EntityProxy::AppendInstances(EntityBatcher& batcher, bool depthPass, int skinnedVertexBase) const
+{
+    if (!model)
+        return true;
+
+    if (kind == Kind::Building)
+    {
+        // Shadows use the foundation until construction completes.
+        if (depthPass)
+        {
+            batcher.Add(underConstruction && foundation ? foundation : model, transform);
+            return true;
+        }
+        if (underConstruction)
+        {
+            // Cross-fade the foundation out and the building in, as
+            // per-instance alpha.
+            if (foundation && foundation != model)
+                batcher.Add(foundation, transform, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f - buildProgress));
+            batcher.Add(model, transform, glm::vec4(1.0f, 1.0f, 1.0f, buildProgress));
+            return true;
+        }
+    }
+
+    if (!skinned)
+    {
+        batcher.Add(model, transform);
+        return true;
+    }
+    if (skinnedVertexBase >= 0)
+    {
+        batcher.Add(model, transform, glm::vec4(1.0f), skinnedVertexBase, 0, true);
+        return true;
+    }
+    if (boneBase < 0)
+        return false;
+    batcher.Add(model, transform, glm::vec4(1.0f), boneBase,
+                baked ? model->GetBakedAnimationTexture() : 0);
+    return true;
+}
+
+void EntityProxy::Draw(Shader& shader, int skinnedVertexBase, GLuint paletteTexture) const
+{
+    if (!model)
+        return;
+
+    shader.Use();
+    shader.SetMat4("model", transform);
+    shader.SetFloat("uAlpha", 1.0f);
+
+    if (skinnedVertexBase >= 0)
+    {
+        // Already skinned this frame; the caller binds the stream.
+        shader.SetBool("uUseSkinning", false);
+        shader.SetBool("uPreskinned", true);
+        shader.SetInt("uBoneBase", skinnedVertexBase);
+        model->Draw(shader);
+        shader.SetBool("uPreskinned", false);
+        return;
+    }
+
+    if (skinned && baked && boneBase >= 0)
+    {
+        // Rare path (baked units normally batch): borrow the bone unit
+        // and hand the caller's palette back afterwards.
+        shader.BindBoneTexture(model->GetBakedAnimationTexture(), static_cast<int>(model->GetBoneCount()));
+        shader.SetBool("uUseSkinning", true);
+        shader.SetInt("uBoneBase", boneBase);
+        model->Draw(shader);
+        shader.BindBoneTexture(paletteTexture, 0);
+        return;
+    }
+
+    // The shared palette texture is bound by the caller; only the
+    // offset into it is per unit.
+    const bool canSkin = skinned && !baked && boneBase >= 0;
+    shader.SetBool("uUseSkinning", canSkin);
+    shader.SetInt("uBoneBase", canSkin ? boneBase : 0);
+    shader.SetInt("uBoneCount", canSkin ? static_cast<int>(model->GetBoneCount()) : 0);
+    model->Draw(shader);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class Model;
+class Shader;
+class EntityBatcher;
+
+// ============================================================
+// EntityProxy
+// Draw state of one unit or building, copied out of the entity on
+// the simulation thread (GameEntity::WriteRenderProxy) so the GL
+// thread never touches a GameEntity, which the next tick may delete.
+// Holds what every pass needs: model(s), transform, the construction
+// cross-fade and where the skinning pose comes from.
+// ============================================================
+struct EntityProxy {
+    enum class Kind : uint8_t { Prop, Unit, Building };
+
+    Kind kind = Kind::Prop;
+    Model* model = nullptr;
+    Model* foundation = nullptr;    // buildings: faded out while constructing
+    glm::mat4 transform{1.0f};
+    glm::vec3 position{0.0f};
+    bool underConstruction = false;
+    float buildProgress = 1.0f;
+    // Skinned units: boneBase is the first matrix in the snapshot's
+    // bone palette, or a frame in the model's baked texture when
+    // `baked`; -1 = no pose this tick (drawn in bind pose).
+    bool skinned = false;
+    bool baked = false;
+    int boneBase = -1;
+
+    // Finished buildings go to the cached static shadow layer.
+    bool IsStaticShadowCaster() const { return kind == Kind::Building && !underConstruction; }
+
+    // Queues the proxy for instanced drawing. `skinnedVertexBase` is
+    // its base in this frame's SkinningPrepass, -1 if none. Returns
+    // false when it has to go through Draw() instead.
+    bool AppendInstances(EntityBatcher& batcher, bool depthPass, int skinnedVertexBase) const;
+    // Individual draw; the caller binds the palette and skinned
+    // vertex textures (Scene does it once per pass) and passes the
+    // palette so a baked unit can restore it after borrowing unit 13.
+    void Draw(Shader& shader, int skinnedVertexBase, GLuint paletteTexture) const;
+};
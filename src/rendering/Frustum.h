@@ -0,0 +1,51 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// ============================================================
+// Frustum
+// Six planes extracted from a view-projection matrix
+// (Gribb/Hartmann). Planes point inward and are normalised, so
+// dot(plane, vec4(p, 1)) is a signed distance in world units.
+// ============================================================
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum FromMatrix(const glm::mat4& viewProj)
+    {
+        // glm is column-major: row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+        auto row = [&](int i)
+        {
+            return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        };
+
+        Frustum f;
+        f.planes[0] = row(3) + row(0); // left
+        f.planes[1] = row(3) - row(0); // right
+        f.planes[2] = row(3) + row(1); // bottom
+        f.planes[3] = row(3) - row(1); // top
+        f.planes[4] = row(3) + row(2); // near
+        f.planes[5] = row(3) - row(2); // far
+        for (glm::vec4& p : f.planes)
+        {
+            float len = glm::length(glm::vec3(p));
+            if (len > 0.0f)
+                p /= len;
+        }
+        return f;
+    }
+
+    // Conservative: false only when the box is fully outside one plane.
+    bool IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const
+    {
+        for (const glm::vec4& p : planes)
+        {
+            // Box corner furthest along the plane normal
+            glm::vec3 v(p.x >= 0.0f ? max.x : min.x,
+                        p.y >= 0.0f ? max.y : min.y,
+                        p.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(p), v) + p.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,82 @@
+#include "RenderQueue.h"
+#include "../../common/GLState.h"
+#include <algorithm>
+
+namespace {
+constexpr int kPassShift = 60;
+constexpr int kShaderShift = 48;
+constexpr int kMaterialShift = 24;
+constexpr uint64_t kShaderMask = 0xFFF;
+constexpr uint64_t kMaterialMask = 0xFFFFFF;
+constexpr uint64_t kDepthMask = 0xFFFFFF;
+}
+
+uint64_t RenderQueue::MakeKey(Pass pass, GLuint program, uint32_t material,
+                              float depth, float maxDepth, bool backToFront)
+{
+    float t = maxDepth > 0.0f ? depth / maxDepth : 0.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+    uint64_t d = static_cast<uint64_t>(t * static_cast<float>(kDepthMask));
+    if (backToFront)
+        d = kDepthMask - d;
+
+    return (static_cast<uint64_t>(pass) << kPassShift) |
+           ((static_cast<uint64_t>(program) & kShaderMask) << kShaderShift) |
+           ((static_cast<uint64_t>(material) & kMaterialMask) << kMaterialShift) |
+           (d & kDepthMask);
+}
+
+void RenderQueue::SetPassSetup(Pass pass, std::function<void()> setup)
+{
+    passSetup_[static_cast<size_t>(pass)] = std::move(setup);
+}
+
+void RenderQueue::Submit(uint64_t key, GLuint program, State state, std::function<void()> draw)
+{
+    packets_.push_back({ key, program, state, std::move(draw) });
+}
+
+void RenderQueue::Execute()
+{
+    // Sort indices, not packets: std::function is not cheap to move.
+    // Stable, so equal keys keep submission order.
+    order_.resize(packets_.size());
+    for (size_t i = 0; i < order_.size(); ++i)
+        order_[i] = static_cast<uint32_t>(i);
+    std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b)
+    {
+        return packets_[a].key < packets_[b].key;
+    });
+
+    int currentPass = -1;
+    for (uint32_t index : order_)
+    {
+        const Packet& packet = packets_[index];
+        const int pass = static_cast<int>(packet.key >> kPassShift);
+        if (pass != currentPass)
+        {
+            currentPass = pass;
+            if (static_cast<size_t>(pass) < passSetup_.size() && passSetup_[pass])
+                passSetup_[pass]();
+        }
+
+        if (packet.program != 0)
+            GLState::UseProgram(packet.program);
+        if (packet.state.blend)
+            GLState::Enable(GL_BLEND);
+        else
+            GLState::Disable(GL_BLEND);
+        if (packet.state.cull)
+            GLState::Enable(GL_CULL_FACE);
+        else
+            GLState::Disable(GL_CULL_FACE);
+
+        if (packet.draw)
+            packet.draw();
+    }
+
+    packets_.clear();
+    order_.clear();
+    for (auto& setup : passSetup_)
+        setup = nullptr;
+}
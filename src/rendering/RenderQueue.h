@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <GL/glew.h>
+
+// ============================================================
+// RenderQueue
+// Draw packets for the main pass, sorted by a 64-bit key before
+// they are executed:
+//
+//   63..60 pass   59..48 shader   47..24 material   23..0 depth
+//
+// so packets run pass by pass, then grouped by program and by
+// texture/model inside a pass, then by view depth (front to back,
+// or back to front for blended passes). Execute() applies each
+// packet's program and blend/cull state through GLState, so runs of
+// packets sharing state cost no GL calls, then calls its draw.
+//
+// A pass may register a setup callback (uniforms shared by all its
+// packets); it runs once, before the pass's first packet.
+// ============================================================
+class RenderQueue {
+public:
+    enum class Pass : uint8_t {
+        Opaque,        // terrain, vegetation, impostors
+        Entities,      // units and buildings (blended)
+        Overlay,       // selection rings, debug overlays
+        Water,
+        Transparent,   // placement preview
+        Count
+    };
+
+    // Blending always uses SRC_ALPHA / ONE_MINUS_SRC_ALPHA.
+    struct State {
+        bool blend = false;
+        bool cull = true;
+    };
+
+    static uint64_t MakeKey(Pass pass, GLuint program, uint32_t material,
+                            float depth, float maxDepth, bool backToFront = false);
+
+    void SetPassSetup(Pass pass, std::function<void()> setup);
+    void Submit(uint64_t key, GLuint program, State state, std::function<void()> draw);
+
+    // Sorts, runs and clears every packet and pass setup.
+    void Execute();
+
+    size_t GetPacketCount() const { return packets_.size(); }
+
+private:
+    struct Packet {
+        uint64_t key;
+        GLuint program;
+        State state;
+        std::function<void()> draw;
+    };
+
+    std::vector<Packet> packets_;
+    std::vector<uint32_t> order_;
+    std::array<std::function<void()>, static_cast<size_t>(Pass::Count)> passSetup_;
+};
@@ -0,0 +1,93 @@
+#include "SelectionRings.h"
+#include "../../common/Shader.h"
+#include "../../common/GLState.h"
+#include <cstddef>
+
+SelectionRings::~SelectionRings()
+{
+    if (instanceVBO_) glDeleteBuffers(1, &instanceVBO_);
+    if (quadVBO_) glDeleteBuffers(1, &quadVBO_);
+    if (vao_) GLState::DeleteVertexArrays(1, &vao_);
+}
+
+void SelectionRings::ensureObjects()
+{
+    if (vao_ != 0)
+        return;
+
+    // Unit quad in XZ; the ring pass scales it by the radius, the bar
+    // pass reads x/z as the bar's right/down corners.
+    const float verts[] = {
+        // positions          // uv
+        -1.0f, 0.0f, -1.0f,   0.0f, 1.0f,
+         1.0f, 0.0f, -1.0f,   1.0f, 1.0f,
+         1.0f, 0.0f,  1.0f,   1.0f, 0.0f,
+
+        -1.0f, 0.0f, -1.0f,   0.0f, 1.0f,
+         1.0f, 0.0f,  1.0f,   1.0f, 0.0f,
+        -1.0f, 0.0f,  1.0f,   0.0f, 0.0f
+    };
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &quadVBO_);
+    glGenBuffers(1, &instanceVBO_);
+
+    GLState::BindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+    glEnableVertexAttribArray(2); // iPosRadius
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, posRadius));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3); // iTint
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, tint));
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4); // iHealth
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, health));
+    glVertexAttribDivisor(4, 1);
+
+    GLState::BindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SelectionRings::Add(const glm::vec3& groundPos, float radius, const glm::vec4& tint, float healthFill)
+{
+    instances_.push_back({ glm::vec4(groundPos, radius), tint,
+                           healthFill < 0.0f ? -1.0f : glm::clamp(healthFill, 0.0f, 1.0f) });
+}
+
+void SelectionRings::Draw(Shader& shader, GLuint ringTexture, float barLift, const glm::vec2& barHalfSize)
+{
+    if (instances_.empty())
+        return;
+    ensureObjects();
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+    if (instances_.size() > capacity_)
+        capacity_ = instances_.size() + instances_.size() / 2;
+    // Orphan so last frame's draws never stall the upload.
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances_.size() * sizeof(Instance), instances_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const GLsizei count = static_cast<GLsizei>(instances_.size());
+
+    shader.Use();
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, ringTexture);
+    shader.SetInt("uTexture", 0);
+    shader.SetFloat("uBarLift", barLift);
+    shader.SetVec2("uBarHalfSize", barHalfSize);
+
+    GLState::BindVertexArray(vao_);
+    shader.SetInt("uMode", 0);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    shader.SetInt("uMode", 1);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    GLState::BindVertexArray(0);
+}
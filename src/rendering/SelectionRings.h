@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class Shader;
+
+// ============================================================
+// SelectionRings
+// Ground rings and health bars of the selected units in two
+// instanced draws, whatever the selection size. Each instance is a
+// ground point, a ring radius, a tint and a health fill;
+// selection.vert lays the shared quad flat on the ground for the
+// ring (uMode 0) or turns it into a camera-facing bar above the
+// unit (uMode 1).
+//
+// Usage per frame: Begin(); Add() each unit; Draw().
+// ============================================================
+class SelectionRings {
+public:
+    SelectionRings() = default;
+    ~SelectionRings();
+    SelectionRings(const SelectionRings&) = delete;
+    SelectionRings& operator=(const SelectionRings&) = delete;
+
+    void Begin() { instances_.clear(); }
+    // `healthFill` in [0, 1]; negative draws the ring without a bar.
+    void Add(const glm::vec3& groundPos, float radius, const glm::vec4& tint, float healthFill);
+
+    // `shader` is selection.vert/.frag; FrameBlock supplies the camera.
+    // `barLift` is the bar's height above the ground point and
+    // `barHalfSize` its half width/height, in world units.
+    void Draw(Shader& shader, GLuint ringTexture, float barLift, const glm::vec2& barHalfSize);
+
+    size_t GetCount() const { return instances_.size(); }
+
+private:
+    struct Instance {
+        glm::vec4 posRadius;   // xyz ground point, w ring radius
+        glm::vec4 tint;
+        float health;
+    };
+
+    std::vector<Instance> instances_;
+    GLuint vao_ = 0;
+    GLuint quadVBO_ = 0;
+    GLuint instanceVBO_ = 0;
+    size_t capacity_ = 0;   // in instances
+
+    void ensureObjects();
+};
@@ -0,0 +1,189 @@
+#include "ShadowCascades.h"
+#include "../../common/GLState.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+// 0 = uniform splits, 1 = logarithmic; in between trades near detail
+// against far coverage.
+constexpr float kSplitLambda = 0.75f;
+// Cascade window half-width over the slice's bounding sphere radius;
+// the margin is what lets the window stay put while the camera pans.
+constexpr float kWindowScale = 1.5f;
+}
+
+ShadowCascades::~ShadowCascades()
+{
+    Shutdown();
+}
+
+GLuint ShadowCascades::createDepthArray() const
+{
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24,
+                 resolution_, resolution_, count_, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return texture;
+}
+
+bool ShadowCascades::Init(int resolution, int cascadeCount)
+{
+    Shutdown();
+    resolution_ = std::max(resolution, 1);
+    count_ = std::min(std::max(cascadeCount, 1), kMaxCascades);
+
+    texture_ = createDepthArray();
+    staticTexture_ = createDepthArray();
+
+    bool complete = true;
+    glGenFramebuffers(1, &fbo_);
+    glGenFramebuffers(1, &staticFbo_);
+    for (GLuint fbo : { fbo_, staticFbo_ })
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                  fbo == fbo_ ? texture_ : staticTexture_, 0, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete)
+    {
+        std::cerr << "ShadowCascades: incomplete framebuffer" << std::endl;
+        Shutdown();
+        return false;
+    }
+    InvalidateStatic();
+    return true;
+}
+
+void ShadowCascades::Shutdown()
+{
+    if (fbo_) glDeleteFramebuffers(1, &fbo_);
+    if (staticFbo_) glDeleteFramebuffers(1, &staticFbo_);
+    if (texture_) GLState::DeleteTextures(1, &texture_);
+    if (staticTexture_) GLState::DeleteTextures(1, &staticTexture_);
+    fbo_ = staticFbo_ = 0;
+    texture_ = staticTexture_ = 0;
+    InvalidateStatic();
+}
+
+void ShadowCascades::InvalidateStatic()
+{
+    for (StaticLayer& layer : static_)
+        layer.valid = false;
+}
+
+void ShadowCascades::Update(const glm::mat4& view, float fovY, float aspect,
+                            float nearPlane, float shadowDistance,
+                            const glm::vec3& lightDir, float depthPadding)
+{
+    const float nearZ = std::max(nearPlane, 0.1f);
+    const float farZ = std::max(shadowDistance, nearZ + 1.0f);
+    const float tanY = std::tan(fovY * 0.5f);
+    const float tanX = tanY * aspect;
+    const glm::mat4 invView = glm::inverse(view);
+
+    // Fixed light orientation; only the ortho window moves per cascade.
+    glm::vec3 dir = glm::normalize(lightDir);
+    glm::vec3 up = std::abs(dir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), dir, up);
+
+    float sliceNear = nearZ;
+    for (int i = 0; i < count_; ++i)
+    {
+        const float t = static_cast<float>(i + 1) / static_cast<float>(count_);
+        const float logSplit = nearZ * std::pow(farZ / nearZ, t);
+        const float uniSplit = nearZ + (farZ - nearZ) * t;
+        const float sliceFar = kSplitLambda * logSplit + (1.0f - kSplitLambda) * uniSplit;
+        splits_[i] = sliceFar;
+
+        glm::vec3 corners[8];
+        int c = 0;
+        for (float d : { sliceNear, sliceFar })
+        {
+            for (float sx : { -1.0f, 1.0f })
+            {
+                for (float sy : { -1.0f, 1.0f })
+                    corners[c++] = glm::vec3(invView * glm::vec4(sx * d * tanX, sy * d * tanY, -d, 1.0f));
+            }
+        }
+
+        glm::vec3 center(0.0f);
+        for (const glm::vec3& p : corners)
+            center += p;
+        center /= 8.0f;
+        float radius = 0.0f;
+        for (const glm::vec3& p : corners)
+            radius = std::max(radius, glm::length(p - center));
+        // Quantise so tiny float changes do not rescale the cascade.
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // The window does not follow the camera texel by texel: it is
+        // kWindowScale times the slice's sphere and snapped to a grid of
+        // whole texels about one radius wide, so it only moves (and the
+        // cached static layer only goes stale) once the slice has left
+        // it. Any slice centre inside a grid cell fits in the window.
+        const float half = radius * kWindowScale;
+        const float texel = (2.0f * half) / static_cast<float>(resolution_);
+        const float step = texel * std::floor(radius / texel);
+        glm::vec3 lc = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        lc = (glm::floor(lc / step) + 0.5f) * step;
+
+        // Light looks down -Z: the window spans z in [lc.z - half, lc.z + half].
+        const glm::mat4 lightProj = glm::ortho(lc.x - half, lc.x + half,
+                                               lc.y - half, lc.y + half,
+                                               -lc.z - half - depthPadding,
+                                               -lc.z + half);
+        matrices_[i] = lightProj * lightView;
+        sliceNear = sliceFar;
+    }
+}
+
+bool ShadowCascades::BeginStaticCascade(int index, uint64_t staticKey)
+{
+    StaticLayer& layer = static_[index];
+    if (layer.valid && layer.key == staticKey && layer.matrix == matrices_[index])
+        return false;
+
+    layer.valid = true;
+    layer.key = staticKey;
+    layer.matrix = matrices_[index];
+
+    glBindFramebuffer(GL_FRAMEBUFFER, staticFbo_);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticTexture_, 0, index);
+    glViewport(0, 0, resolution_, resolution_);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    return true;
+}
+
+void ShadowCascades::BeginCascade(int index) const
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFbo_);
+    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, staticTexture_, 0, index);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture_, 0, index);
+    glBlitFramebuffer(0, 0, resolution_, resolution_, 0, 0, resolution_, resolution_,
+                      GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glViewport(0, 0, resolution_, resolution_);
+}
+
+void ShadowCascades::End() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
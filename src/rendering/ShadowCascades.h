@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// ============================================================
+// ShadowCascades
+// Cascaded shadow maps for the directional sun: the camera frustum
+// up to a shadow distance is split into slices (practical split
+// scheme, log/uniform blend), and each slice gets its own ortho
+// light projection in one layer of a depth texture array.
+//
+// Each cascade covers the bounding sphere of its slice with some
+// margin, so its size does not change as the camera rotates, and
+// its window is snapped to a light-space grid about one sphere
+// radius wide (in whole texels); it stays put while the slice moves
+// inside a grid cell, so shadow edges do not shimmer.
+//
+// Static casters (terrain, vegetation, finished buildings) are
+// rendered into a second, cached array. A cascade's cached layer is
+// reused while both its light matrix (which only changes when the
+// window jumps a grid cell) and the caller's static-scene key are
+// unchanged; each frame it is blitted into the live layer and only
+// dynamic casters are drawn on top.
+// ============================================================
+class ShadowCascades {
+public:
+    static constexpr int kMaxCascades = 4;
+
+    ShadowCascades() = default;
+    ~ShadowCascades();
+    ShadowCascades(const ShadowCascades&) = delete;
+    ShadowCascades& operator=(const ShadowCascades&) = delete;
+
+    bool Init(int resolution, int cascadeCount);
+    void Shutdown();
+
+    // lightDir points from the light into the scene. depthPadding
+    // extends each cascade towards the light so casters outside the
+    // slice (hills, tall buildings) still land in the map.
+    void Update(const glm::mat4& view, float fovY, float aspect,
+                float nearPlane, float shadowDistance,
+                const glm::vec3& lightDir, float depthPadding);
+
+    // True when the cached static layer of `index` is stale for
+    // `staticKey`; it is then bound and cleared, and the caller must
+    // draw the static casters before BeginCascade().
+    bool BeginStaticCascade(int index, uint64_t staticKey);
+    // Copies the static layer into live layer `index` and binds it for
+    // the dynamic casters.
+    void BeginCascade(int index) const;
+    void End() const;
+    void InvalidateStatic();
+
+    int GetCount() const { return count_; }
+    int GetResolution() const { return resolution_; }
+    GLuint GetTexture() const { return texture_; }
+    const glm::mat4& GetMatrix(int index) const { return matrices_[index]; }
+    // View-space distance at which cascade `index` ends.
+    float GetSplit(int index) const { return splits_[index]; }
+
+private:
+    GLuint fbo_ = 0;
+    GLuint texture_ = 0;
+    GLuint staticFbo_ = 0;
+    GLuint staticTexture_ = 0;
+    int resolution_ = 0;
+    int count_ = 0;
+    glm::mat4 matrices_[kMaxCascades];
+    float splits_[kMaxCascades] = {};
+
+    struct StaticLayer {
+        bool valid = false;
+        uint64_t key = 0;
+        glm::mat4 matrix{1.0f};
+    };
+    StaticLayer static_[kMaxCascades];
+
+    GLuint createDepthArray() const;
+};
@@ -0,0 +1,101 @@
+#include "SkinningPrepass.h"
+#include "../../common/Model.h"
+#include "../../common/Shader.h"
+#include "../../common/GLState.h"
+
+namespace {
+// tfPosition + tfNormal, interleaved vec3s
+constexpr size_t kBytesPerVertex = 6 * sizeof(float);
+}
+
+SkinningPrepass::~SkinningPrepass()
+{
+    if (texture_) GLState::DeleteTextures(1, &texture_);
+    if (buffer_) glDeleteBuffers(1, &buffer_);
+}
+
+void SkinningPrepass::ensureObjects()
+{
+    if (buffer_ != 0)
+        return;
+
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    maxVertices_ = static_cast<size_t>(maxTexels > 0 ? maxTexels : 0) / 2;
+
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_);   // creates the object for glTexBuffer
+    glGenTextures(1, &texture_);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, texture_);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGB32F, buffer_);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void SkinningPrepass::Begin()
+{
+    ensureObjects();
+    jobs_.clear();
+    vertexCount_ = 0;
+}
+
+int SkinningPrepass::Add(Model* model, GLuint boneTexture, int boneBase)
+{
+    if (!model || boneTexture == 0 || boneBase < 0)
+        return -1;
+    const size_t count = model->GetVertexCount();
+    if (count == 0 || vertexCount_ + count > maxVertices_)
+        return -1;
+
+    const GLint first = static_cast<GLint>(vertexCount_);
+    jobs_.push_back({ model, boneTexture, boneBase, first });
+    vertexCount_ += count;
+    return first;
+}
+
+void SkinningPrepass::Run(Shader& skinShader)
+{
+    if (jobs_.empty())
+        return;
+
+    if (vertexCount_ > capacity_)
+        capacity_ = vertexCount_ + vertexCount_ / 2;
+
+    // Orphan each frame: last frame's passes may still be reading the
+    // old contents.
+    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, buffer_);
+    glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, capacity_ * kBytesPerVertex, nullptr, GL_STREAM_COPY);
+
+    skinShader.Use();
+    GLState::Enable(GL_RASTERIZER_DISCARD);
+
+    GLuint boundBones = 0;
+    for (const Job& job : jobs_)
+    {
+        const size_t count = job.model->GetVertexCount();
+        if (job.boneTexture != boundBones)
+        {
+            GLState::ActiveTexture(GL_TEXTURE13);
+            GLState::BindTexture(GL_TEXTURE_BUFFER, job.boneTexture);
+            boundBones = job.boneTexture;
+        }
+        skinShader.SetInt("uBoneTexture", 13);
+        skinShader.SetInt("uBoneCount", static_cast<int>(job.model->GetBoneCount()));
+        skinShader.SetInt("uBoneBase", job.boneBase);
+
+        // The binding cannot change inside a feedback pass, so each
+        // unit gets its own range and Begin/End pair.
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffer_,
+                          static_cast<GLintptr>(job.firstVertex * kBytesPerVertex),
+                          static_cast<GLsizeiptr>(count * kBytesPerVertex));
+        glBeginTransformFeedback(GL_POINTS);
+        job.model->DrawVertexStream();
+        glEndTransformFeedback();
+    }
+
+    GLState::Disable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+    GLState::ActiveTexture(GL_TEXTURE13);
+    GLState::BindTexture(GL_TEXTURE_BUFFER, 0);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <GL/glew.h>
+
+class Model;
+class Shader;
+
+// ============================================================
+// SkinningPrepass
+// Skins each drawn unit's mesh once per frame with transform
+// feedback (skin_prepass.vert, rasteriser off) into one shared
+// buffer, so the depth cascades and the main pass read finished
+// positions/normals instead of each re-skinning from the bone
+// texture.
+//
+// The buffer is exposed as an RGB32F texture buffer: vertex v of a
+// unit whose base is `b` is texels (b + v) * 2 (position) and +1
+// (normal), in model space. The base reaches simple.vert and
+// shadow_depth.vert the same way a bone base does (uBoneBase or
+// iBoneBase), with uPreskinned set, so preskinned units still batch.
+//
+// Usage per frame: Begin(); Add() each unit; Run().
+// ============================================================
+class SkinningPrepass {
+public:
+    SkinningPrepass() = default;
+    ~SkinningPrepass();
+    SkinningPrepass(const SkinningPrepass&) = delete;
+    SkinningPrepass& operator=(const SkinningPrepass&) = delete;
+
+    void Begin();
+    // Queues `model` skinned from `boneTexture` at `boneBase`. Returns
+    // the unit's vertex base, or -1 when the buffer would outgrow
+    // GL_MAX_TEXTURE_BUFFER_SIZE (the unit then skins in its passes).
+    int Add(Model* model, GLuint boneTexture, int boneBase);
+    // Runs every queued job. Leaves the bone unit (13) unbound.
+    void Run(Shader& skinShader);
+
+    GLuint GetTexture() const { return texture_; }
+    size_t GetVertexCount() const { return vertexCount_; }
+
+private:
+    struct Job {
+        Model* model;
+        GLuint boneTexture;
+        int boneBase;
+        GLint firstVertex;
+    };
+
+    std::vector<Job> jobs_;
+    size_t vertexCount_ = 0;
+    size_t maxVertices_ = 0;
+    GLuint buffer_ = 0;
+    GLuint texture_ = 0;
+    size_t capacity_ = 0;   // in vertices
+
+    void ensureObjects();
+};
@@ -0,0 +1,114 @@
+#include "SphereCuller.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SPHERE_CULLER_SSE 1
+#endif
+
+void SphereCuller::Clear()
+{
+    x_.clear();
+    y_.clear();
+    z_.clear();
+    r_.clear();
+    count_ = 0;
+    visibleCount_ = 0;
+}
+
+void SphereCuller::Reserve(size_t count)
+{
+    const size_t padded = (count + 3) & ~size_t(3);
+    x_.reserve(padded);
+    y_.reserve(padded);
+    z_.reserve(padded);
+    r_.reserve(padded);
+    visible_.reserve(padded);
+}
+
+size_t SphereCuller::Add(const glm::vec3& center, float radius)
+{
+    // Overwrite padding left by the previous Cull(), if any.
+    x_.resize(count_);
+    y_.resize(count_);
+    z_.resize(count_);
+    r_.resize(count_);
+    x_.push_back(center.x);
+    y_.push_back(center.y);
+    z_.push_back(center.z);
+    r_.push_back(radius);
+    return count_++;
+}
+
+size_t SphereCuller::Add(const glm::mat4& transform, const glm::vec3& center, float radius)
+{
+    const float scale = std::sqrt(std::max({ glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+                                             glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+                                             glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2])) }));
+    return Add(glm::vec3(transform * glm::vec4(center, 1.0f)), radius * scale);
+}
+
+void SphereCuller::Cull(const Frustum& frustum)
+{
+    // Pad with spheres that fail every plane (radius -inf).
+    const size_t padded = (count_ + 3) & ~size_t(3);
+    x_.resize(padded, 0.0f);
+    y_.resize(padded, 0.0f);
+    z_.resize(padded, 0.0f);
+    r_.resize(padded, -INFINITY);
+    visible_.assign(padded, 0);
+
+    const float* xs = x_.data();
+    const float* ys = y_.data();
+    const float* zs = z_.data();
+    const float* rs = r_.data();
+    uint8_t* out = visible_.data();
+
+#if SPHERE_CULLER_SSE
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        px[p] = _mm_set1_ps(frustum.planes[p].x);
+        py[p] = _mm_set1_ps(frustum.planes[p].y);
+        pz[p] = _mm_set1_ps(frustum.planes[p].z);
+        pw[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+    for (size_t i = 0; i < padded; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(xs + i);
+        const __m128 y = _mm_loadu_ps(ys + i);
+        const __m128 z = _mm_loadu_ps(zs + i);
+        const __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(rs + i));
+        __m128 inside = _mm_cmpeq_ps(x, x);   // all ones (coordinates are finite)
+        for (int p = 0; p < 6; ++p)
+        {
+            // signed distance >= -radius for every plane
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, px[p]), _mm_mul_ps(y, py[p])),
+                                  _mm_add_ps(_mm_mul_ps(z, pz[p]), pw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+        const int mask = _mm_movemask_ps(inside);
+        out[i + 0] = static_cast<uint8_t>(mask & 1);
+        out[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+        out[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+        out[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+    }
+#else
+    for (size_t i = 0; i < padded; ++i)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4& pl = frustum.planes[p];
+            const float d = xs[i] * pl.x + ys[i] * pl.y + zs[i] * pl.z + pl.w;
+            inside = inside & (d >= -rs[i]);
+        }
+        out[i] = inside ? 1 : 0;
+    }
+#endif
+
+    visibleCount_ = 0;
+    for (size_t i = 0; i < count_; ++i)
+        visibleCount_ += out[i];
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Frustum.h"
+
+// ============================================================
+// SphereCuller
+// World-space bounding spheres in SoA form (x[], y[], z[], r[]),
+// tested against a Frustum four at a time. Arrays are padded to a
+// multiple of four with never-visible spheres so the SIMD loop
+// needs no tail. Without SSE the same loop is written so the
+// compiler can vectorise it.
+//
+// Usage per pass: Clear(); Add() each candidate; Cull(frustum);
+// then IsVisible(i) for the index Add() returned.
+// ============================================================
+class SphereCuller {
+public:
+    void Clear();
+    void Reserve(size_t count);
+    size_t Add(const glm::vec3& center, float radius);
+    // Model-space sphere carried through `transform` (uniform scale
+    // taken from the largest basis column).
+    size_t Add(const glm::mat4& transform, const glm::vec3& center, float radius);
+
+    void Cull(const Frustum& frustum);
+
+    size_t Size() const { return count_; }
+    bool IsVisible(size_t index) const { return visible_[index] != 0; }
+    size_t GetVisibleCount() const { return visibleCount_; }
+
+private:
+    std::vector<float> x_, y_, z_, r_;
+    std::vector<uint8_t> visible_;
+    size_t count_ = 0;
+    size_t visibleCount_ = 0;
+};
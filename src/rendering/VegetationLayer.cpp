@@ -0,0 +1,213 @@
+#include "VegetationLayer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+VegetationLayer::~VegetationLayer()
+{
+    Clear();
+}
+
+void VegetationLayer::Clear()
+{
+    if (matrixBuffer_) glDeleteBuffers(1, &matrixBuffer_);
+    if (impostorBuffer_) glDeleteBuffers(1, &impostorBuffer_);
+    matrixBuffer_ = 0;
+    impostorBuffer_ = 0;
+    chunks_.clear();
+    matrices_.clear();
+    impostors_.clear();
+    slotNode_.clear();
+    nodeSlot_.clear();
+    dirtyChunks_.clear();
+}
+
+void VegetationLayer::Build(const std::vector<glm::mat4>& transforms,
+                            const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                            const glm::vec2& origin, const glm::vec2& extent,
+                            float chunkSize, bool withImpostors)
+{
+    Clear();
+    if (transforms.empty() || chunkSize <= 0.0f)
+        return;
+
+    const int cols = std::max(1, static_cast<int>(std::ceil(extent.x / chunkSize)));
+    const int rows = std::max(1, static_cast<int>(std::ceil(extent.y / chunkSize)));
+    chunks_.resize(static_cast<size_t>(cols) * rows);
+
+    auto chunkOf = [&](const glm::mat4& m)
+    {
+        int c = static_cast<int>((m[3].x - origin.x) / chunkSize);
+        int r = static_cast<int>((m[3].z - origin.y) / chunkSize);
+        c = std::min(std::max(c, 0), cols - 1);
+        r = std::min(std::max(r, 0), rows - 1);
+        return static_cast<uint32_t>(r * cols + c);
+    };
+
+    // Counting sort by chunk; chunks are row-major so neighbouring
+    // visible chunks often merge into one span.
+    const size_t count = transforms.size();
+    std::vector<uint32_t> nodeChunk(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        nodeChunk[i] = chunkOf(transforms[i]);
+        chunks_[nodeChunk[i]].count++;
+    }
+
+    uint32_t offset = 0;
+    for (Chunk& chunk : chunks_)
+    {
+        chunk.offset = offset;
+        offset += chunk.count;
+        chunk.count = 0;
+        chunk.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        chunk.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    }
+
+    matrices_.resize(count);
+    slotNode_.resize(count);
+    nodeSlot_.resize(count);
+    if (withImpostors)
+        impostors_.resize(count);
+
+    const glm::vec3 localCenter = (boundsMin + boundsMax) * 0.5f;
+    const glm::vec3 localHalf = (boundsMax - boundsMin) * 0.5f;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const glm::mat4& m = transforms[i];
+        Chunk& chunk = chunks_[nodeChunk[i]];
+        const uint32_t slot = chunk.offset + chunk.count++;
+
+        matrices_[slot] = m;
+        slotNode_[slot] = static_cast<uint32_t>(i);
+        nodeSlot_[i] = { nodeChunk[i], slot };
+        if (withImpostors)
+            impostors_[slot] = glm::vec4(glm::vec3(m[3]), glm::length(glm::vec3(m[0])));
+
+        // World AABB of the transformed object box (Arvo)
+        glm::vec3 center = glm::vec3(m * glm::vec4(localCenter, 1.0f));
+        glm::vec3 half(0.0f);
+        for (int axis = 0; axis < 3; ++axis)
+            half += glm::abs(glm::vec3(m[axis])) * localHalf[axis];
+        chunk.boundsMin = glm::min(chunk.boundsMin, center - half);
+        chunk.boundsMax = glm::max(chunk.boundsMax, center + half);
+    }
+
+    glGenBuffers(1, &matrixBuffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, matrixBuffer_);
+    glBufferData(GL_ARRAY_BUFFER, matrices_.size() * sizeof(glm::mat4), matrices_.data(), GL_DYNAMIC_DRAW);
+
+    if (withImpostors)
+    {
+        glGenBuffers(1, &impostorBuffer_);
+        glBindBuffer(GL_ARRAY_BUFFER, impostorBuffer_);
+        glBufferData(GL_ARRAY_BUFFER, impostors_.size() * sizeof(glm::vec4), impostors_.data(), GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VegetationLayer::RemoveSwapLast(size_t index, size_t last)
+{
+    if (index >= nodeSlot_.size() || last >= nodeSlot_.size())
+        return;
+
+    // 1) Drop the instance from its chunk by moving the chunk's last
+    //    live slot into the hole. Chunk boxes are left conservative.
+    const NodeSlot removed = nodeSlot_[index];
+    Chunk& chunk = chunks_[removed.chunk];
+    const uint32_t tail = chunk.offset + chunk.count - 1;
+    if (removed.slot != tail)
+    {
+        matrices_[removed.slot] = matrices_[tail];
+        if (!impostors_.empty())
+            impostors_[removed.slot] = impostors_[tail];
+        slotNode_[removed.slot] = slotNode_[tail];
+        nodeSlot_[slotNode_[removed.slot]].slot = removed.slot;
+
+        if (chunk.dirtyBegin == UINT32_MAX)
+            dirtyChunks_.push_back(removed.chunk);
+        chunk.dirtyBegin = std::min(chunk.dirtyBegin, removed.slot);
+        chunk.dirtyEnd = std::max(chunk.dirtyEnd, removed.slot + 1);
+    }
+    chunk.count--;
+
+    // 2) Rename node `last` to `index` to match Scene's arrays.
+    if (index != last)
+    {
+        nodeSlot_[index] = nodeSlot_[last];
+        slotNode_[nodeSlot_[index].slot] = static_cast<uint32_t>(index);
+    }
+    nodeSlot_.pop_back();
+}
+
+void VegetationLayer::Flush()
+{
+    if (dirtyChunks_.empty())
+        return;
+
+    for (uint32_t id : dirtyChunks_)
+    {
+        Chunk& chunk = chunks_[id];
+        const uint32_t end = std::min(chunk.dirtyEnd, chunk.offset + chunk.count);
+        if (chunk.dirtyBegin < end)
+        {
+            const GLsizei n = static_cast<GLsizei>(end - chunk.dirtyBegin);
+            glBindBuffer(GL_ARRAY_BUFFER, matrixBuffer_);
+            glBufferSubData(GL_ARRAY_BUFFER, chunk.dirtyBegin * sizeof(glm::mat4),
+                            n * sizeof(glm::mat4), &matrices_[chunk.dirtyBegin]);
+            if (impostorBuffer_)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, impostorBuffer_);
+                glBufferSubData(GL_ARRAY_BUFFER, chunk.dirtyBegin * sizeof(glm::vec4),
+                                n * sizeof(glm::vec4), &impostors_[chunk.dirtyBegin]);
+            }
+        }
+        chunk.dirtyBegin = UINT32_MAX;
+        chunk.dirtyEnd = 0;
+    }
+    dirtyChunks_.clear();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VegetationLayer::appendSpan(std::vector<InstanceSpan>& spans, const Chunk& chunk)
+{
+    if (!spans.empty())
+    {
+        InstanceSpan& back = spans.back();
+        if (static_cast<uint32_t>(back.first + back.count) == chunk.offset)
+        {
+            back.count += static_cast<GLsizei>(chunk.count);
+            return;
+        }
+    }
+    spans.push_back({ static_cast<GLint>(chunk.offset), static_cast<GLsizei>(chunk.count) });
+}
+
+void VegetationLayer::Cull(const Frustum& frustum, const glm::vec3& eye, float impostorDistance,
+                           VisibleSet& out) const
+{
+    out.meshes.clear();
+    out.impostors.clear();
+
+    const bool useImpostors = impostorBuffer_ != 0 && impostorDistance > 0.0f;
+    const float impostorDistSq = impostorDistance * impostorDistance;
+
+    for (const Chunk& chunk : chunks_)
+    {
+        if (chunk.count == 0 || !frustum.IntersectsAABB(chunk.boundsMin, chunk.boundsMax))
+            continue;
+
+        if (useImpostors)
+        {
+            glm::vec3 closest = glm::clamp(eye, chunk.boundsMin, chunk.boundsMax);
+            glm::vec3 d = closest - eye;
+            if (glm::dot(d, d) > impostorDistSq)
+            {
+                appendSpan(out.impostors, chunk);
+                continue;
+            }
+        }
+        appendSpan(out.meshes, chunk);
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Frustum.h"
+#include "../../common/Model.h"
+
+class Shader;
+
+// ============================================================
+// VegetationLayer
+// Static instanced props (trees, rocks) bucketed into square XZ
+// chunks. All instance matrices live in one persistent GPU buffer
+// in which each chunk owns a contiguous range; chunks are culled
+// against a frustum and only visible ranges are drawn.
+//
+// Node indices mirror Scene's arrays, including the swap-with-last
+// removal, so Scene keeps addressing trees by index. A removal
+// rewrites one slot of one chunk; Flush() uploads just that range.
+//
+// With impostors enabled a second buffer holds vec4(pos, scale)
+// per instance in the same layout, and chunks beyond the impostor
+// distance are drawn as billboards instead of meshes.
+// ============================================================
+class VegetationLayer {
+public:
+    struct VisibleSet {
+        std::vector<InstanceSpan> meshes;
+        std::vector<InstanceSpan> impostors;
+    };
+
+    VegetationLayer() = default;
+    ~VegetationLayer();
+    VegetationLayer(const VegetationLayer&) = delete;
+    VegetationLayer& operator=(const VegetationLayer&) = delete;
+
+    // `boundsMin/Max` are the model's object-space bounds, used to
+    // derive conservative chunk boxes.
+    void Build(const std::vector<glm::mat4>& transforms,
+               const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+               const glm::vec2& origin, const glm::vec2& extent,
+               float chunkSize, bool withImpostors);
+    void Clear();
+
+    // Node `index` is removed and node `last` moves into its slot.
+    void RemoveSwapLast(size_t index, size_t last);
+
+    // Uploads ranges dirtied by RemoveSwapLast.
+    void Flush();
+
+    // Chunks within `impostorDistance` of `eye` (or all of them when
+    // impostors are off or the distance is <= 0) go to `meshes`.
+    void Cull(const Frustum& frustum, const glm::vec3& eye, float impostorDistance,
+              VisibleSet& out) const;
+
+    GLuint GetInstanceBuffer() const { return matrixBuffer_; }
+    GLuint GetImpostorBuffer() const { return impostorBuffer_; }
+    size_t GetChunkCount() const { return chunks_.size(); }
+
+private:
+    struct Chunk {
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        uint32_t offset = 0;            // first slot in the buffers
+        uint32_t count = 0;             // live instances
+        uint32_t dirtyBegin = UINT32_MAX;
+        uint32_t dirtyEnd = 0;
+    };
+
+    struct NodeSlot {
+        uint32_t chunk;
+        uint32_t slot;                  // absolute slot in the buffers
+    };
+
+    std::vector<Chunk> chunks_;
+    std::vector<glm::mat4> matrices_;   // CPU mirror, chunk-ordered
+    std::vector<glm::vec4> impostors_;  // xyz = position, w = scale
+    std::vector<uint32_t> slotNode_;    // slot -> node index
+    std::vector<NodeSlot> nodeSlot_;    // node index -> slot
+    std::vector<uint32_t> dirtyChunks_;
+
+    GLuint matrixBuffer_ = 0;
+    GLuint impostorBuffer_ = 0;
+
+    static void appendSpan(std::vector<InstanceSpan>& spans, const Chunk& chunk);
+};
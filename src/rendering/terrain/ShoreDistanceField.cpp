@@ -0,0 +1,248 @@
+#include "ShoreDistanceField.h"
+#include "ParallelFor.h"
+#include "GLState.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float kInf = 1e20f;
+
+// Felzenszwalb & Huttenlocher 1D squared distance transform.
+void distanceTransform1D(const float* f, int n, float* d, int* v, float* z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -kInf;
+    z[1] = kInf;
+    for (int q = 1; q < n; ++q)
+    {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+        while (s <= z[k])
+        {
+            --k;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kInf;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; ++q)
+    {
+        while (z[k + 1] < q)
+            ++k;
+        float dq = static_cast<float>(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+// Squared distance (in cells) from every cell to the nearest feature cell.
+void distanceTransform2D(const std::vector<uint8_t>& feature, int cols, int rows, std::vector<float>& out)
+{
+    out.assign(static_cast<size_t>(cols) * rows, kInf);
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i] = feature[i] ? 0.0f : kInf;
+
+    const int n = std::max(cols, rows);
+
+    // Pass 1: columns
+    Parallel::ForTiles(cols, 32, [&](int colBegin, int colEnd)
+    {
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n);
+        for (int col = colBegin; col < colEnd; ++col)
+        {
+            for (int row = 0; row < rows; ++row)
+                f[row] = out[static_cast<size_t>(row) * cols + col];
+            distanceTransform1D(f.data(), rows, d.data(), v.data(), z.data());
+            for (int row = 0; row < rows; ++row)
+                out[static_cast<size_t>(row) * cols + col] = d[row];
+        }
+    });
+
+    // Pass 2: rows
+    Parallel::ForTiles(rows, 32, [&](int rowBegin, int rowEnd)
+    {
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n);
+        for (int row = rowBegin; row < rowEnd; ++row)
+        {
+            float* line = &out[static_cast<size_t>(row) * cols];
+            std::copy(line, line + cols, f.begin());
+            distanceTransform1D(f.data(), cols, d.data(), v.data(), z.data());
+            std::copy(d.begin(), d.begin() + cols, line);
+        }
+    });
+}
+
+} // namespace
+
+ShoreDistanceField::~ShoreDistanceField()
+{
+    if (texture_)
+        GLState::DeleteTextures(1, &texture_);
+}
+
+void ShoreDistanceField::Build(int cols, int rows, float cellSize, const glm::vec2& origin,
+                               const std::function<bool(float, float)>& isWater)
+{
+    cols_ = cols;
+    rows_ = rows;
+    cellSize_ = cellSize;
+    origin_ = origin;
+    distances_.clear();
+    waterMask_.clear();
+    if (cols_ <= 0 || rows_ <= 0 || !isWater)
+    {
+        cols_ = rows_ = 0;
+        return;
+    }
+
+    // isWater is called from worker threads and must be read-only.
+    waterMask_.assign(static_cast<size_t>(cols_) * rows_, 0);
+    Parallel::ForTiles(rows_, 16, [&](int rowBegin, int rowEnd)
+    {
+        for (int row = rowBegin; row < rowEnd; ++row)
+        {
+            for (int col = 0; col < cols_; ++col)
+            {
+                float x = origin_.x + (col + 0.5f) * cellSize_;
+                float z = origin_.y + (row + 0.5f) * cellSize_;
+                waterMask_[static_cast<size_t>(row) * cols_ + col] = isWater(x, z) ? 1 : 0;
+            }
+        }
+    });
+
+    computeFromMask();
+}
+
+bool ShoreDistanceField::Load(int cols, int rows, float cellSize, const glm::vec2& origin,
+                              const float* distances, const uint8_t* waterMask, size_t count)
+{
+    if (cols <= 0 || rows <= 0 || !distances || !waterMask ||
+        count != static_cast<size_t>(cols) * static_cast<size_t>(rows))
+        return false;
+
+    cols_ = cols;
+    rows_ = rows;
+    cellSize_ = cellSize;
+    origin_ = origin;
+    distances_.assign(distances, distances + count);
+    waterMask_.assign(waterMask, waterMask + count);
+    return true;
+}
+
+void ShoreDistanceField::computeFromMask()
+{
+    const size_t count = waterMask_.size();
+    std::vector<uint8_t> land(count);
+    for (size_t i = 0; i < count; ++i)
+        land[i] = waterMask_[i] ? 0 : 1;
+
+    std::vector<float> toLand, toWater;
+    distanceTransform2D(land, cols_, rows_, toLand);
+    distanceTransform2D(waterMask_, cols_, rows_, toWater);
+
+    // The shoreline sits half a cell between a water and a land centre.
+    distances_.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        float d = waterMask_[i]
+            ? std::sqrt(toLand[i]) - 0.5f
+            : -(std::sqrt(toWater[i]) - 0.5f);
+        if (!std::isfinite(d))
+            d = waterMask_[i] ? static_cast<float>(cols_ + rows_) : -static_cast<float>(cols_ + rows_);
+        distances_[i] = d * cellSize_;
+    }
+}
+
+float ShoreDistanceField::cellValue(int col, int row) const
+{
+    col = std::clamp(col, 0, cols_ - 1);
+    row = std::clamp(row, 0, rows_ - 1);
+    return distances_[static_cast<size_t>(row) * cols_ + col];
+}
+
+float ShoreDistanceField::Sample(float x, float z) const
+{
+    if (!IsValid())
+        return 0.0f;
+
+    float fx = (x - origin_.x) / cellSize_ - 0.5f;
+    float fz = (z - origin_.y) / cellSize_ - 0.5f;
+    int c0 = static_cast<int>(std::floor(fx));
+    int r0 = static_cast<int>(std::floor(fz));
+    float tx = fx - c0;
+    float tz = fz - r0;
+
+    float a = cellValue(c0, r0);
+    float b = cellValue(c0 + 1, r0);
+    float c = cellValue(c0, r0 + 1);
+    float d = cellValue(c0 + 1, r0 + 1);
+    return glm::mix(glm::mix(a, b, tx), glm::mix(c, d, tx), tz);
+}
+
+glm::vec2 ShoreDistanceField::Gradient(float x, float z) const
+{
+    const float h = cellSize_;
+    float dx = Sample(x + h, z) - Sample(x - h, z);
+    float dz = Sample(x, z + h) - Sample(x, z - h);
+    return glm::vec2(dx, dz) / (2.0f * h);
+}
+
+bool ShoreDistanceField::NearestLand(const glm::vec3& pos, float maxDistance, glm::vec3& out) const
+{
+    if (!IsValid())
+        return false;
+
+    float dist = Sample(pos.x, pos.z);
+    if (dist <= 0.0f)
+    {
+        out = pos;
+        return true;
+    }
+    if (dist > maxDistance)
+        return false;
+
+    glm::vec2 grad = Gradient(pos.x, pos.z);
+    float len = glm::length(grad);
+    if (len < 1e-4f)
+        return false;
+
+    // Step a little past the zero crossing so the result is firmly on land.
+    glm::vec2 dir = grad / len;
+    float step = dist + cellSize_ * 0.75f;
+    out = pos;
+    out.x -= dir.x * step;
+    out.z -= dir.y * step;
+    return true;
+}
+
+void ShoreDistanceField::Upload()
+{
+    if (!IsValid())
+        return;
+
+    if (texture_ == 0)
+        glGenTextures(1, &texture_);
+    GLState::BindTexture(GL_TEXTURE_2D, texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, cols_, rows_, 0, GL_RED, GL_FLOAT, distances_.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLState::BindTexture(GL_TEXTURE_2D, 0);
+}
+
+glm::vec4 ShoreDistanceField::GetRegion() const
+{
+    if (!IsValid())
+        return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    return glm::vec4(origin_.x, origin_.y,
+                     1.0f / (cols_ * cellSize_),
+                     1.0f / (rows_ * cellSize_));
+}
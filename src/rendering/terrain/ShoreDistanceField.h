@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+
+// ============================================================
+// ShoreDistanceField
+// Baked 2D signed distance to the shoreline over the map.
+//   > 0 : inside water, distance to the nearest land
+//   < 0 : on land, distance to the nearest water
+// Built once from the water mask with a two-pass exact EDT.
+// ============================================================
+class ShoreDistanceField {
+public:
+    ShoreDistanceField() = default;
+    ~ShoreDistanceField();
+
+    void Build(int cols, int rows, float cellSize, const glm::vec2& origin,
+               const std::function<bool(float, float)>& isWater);
+
+    // Restore a previously built field (e.g. from the world cache).
+    bool Load(int cols, int rows, float cellSize, const glm::vec2& origin,
+              const float* distances, const uint8_t* waterMask, size_t count);
+
+    bool IsValid() const { return cols_ > 0 && rows_ > 0; }
+
+    // Bilinear sample in world units
+    float Sample(float x, float z) const;
+    glm::vec2 Gradient(float x, float z) const;
+
+    // One gradient step from a water point to the nearest shore.
+    bool NearestLand(const glm::vec3& pos, float maxDistance, glm::vec3& out) const;
+
+    // GPU copy (R32F, linear filtering)
+    void Upload();
+    unsigned int GetTexture() const { return texture_; }
+
+    // xy = world origin, zw = 1 / world extent (for shader UVs)
+    glm::vec4 GetRegion() const;
+
+    int GetCols() const { return cols_; }
+    int GetRows() const { return rows_; }
+    float GetCellSize() const { return cellSize_; }
+    const std::vector<float>& GetData() const { return distances_; }
+    const std::vector<uint8_t>& GetWaterMask() const { return waterMask_; }
+
+private:
+    int cols_ = 0;
+    int rows_ = 0;
+    float cellSize_ = 1.0f;
+    glm::vec2 origin_{0.0f};
+    std::vector<float> distances_;
+    std::vector<uint8_t> waterMask_;
+    unsigned int texture_ = 0;
+
+    float cellValue(int col, int row) const;
+    void computeFromMask();
+};
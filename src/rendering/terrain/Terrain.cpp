@@ -1,9 +1,35 @@
 #include "Terrain.h"
+#include "ParallelFor.h"
+#include "GLState.h"
 #include <GL/glew.h>
 #include <cmath>
 #include <iostream>
 #include <algorithm>
 
+int Terrain::sMapWidth = 600;
+int Terrain::sMapDepth = 600;
+
+void Terrain::SetMapSize(int width, int depth)
+{
+    sMapWidth = std::max(width, 64);
+    sMapDepth = std::max(depth, 64);
+}
+
+glm::vec2 Terrain::LayoutScale()
+{
+    return glm::vec2(sMapWidth / kLayoutSize, sMapDepth / kLayoutSize);
+}
+
+glm::vec2 Terrain::ToLayout(float x, float z)
+{
+    return glm::vec2(x * (kLayoutSize / sMapWidth), z * (kLayoutSize / sMapDepth));
+}
+
+glm::vec2 Terrain::FromLayout(float x, float z)
+{
+    return glm::vec2(x, z) * LayoutScale();
+}
+
 // --- Helper Functions ---
 float getHill(float x, float z, float hx, float hz, float height, float radius) {
 float dx = x - hx;
@@ -38,15 +64,16 @@ return currentPeakH * (factor * factor);
 
 float Terrain::getHeight(float x, float z)
 {
-    // Map size (matches Scene: 600x600, world coords -300..300)
-    const float mapW   = 600.0f;
-    const float mapD   = 600.0f;
+    // Evaluated in authored layout space (600x600, -300..300) so the
+    // cape, lake and rivers stretch with the runtime map size.
+    const float mapW   = kLayoutSize;
+    const float mapD   = kLayoutSize;
     const float halfW  = mapW * 0.5f;
     const float halfD  = mapD * 0.5f;
 
-    // World coords (already centered from constructor usage)
-    float X = x;
-    float Z = z;
+    glm::vec2 layout = ToLayout(x, z);
+    float X = layout.x;
+    float Z = layout.y;
 
     float y     = 0.0f;
     float symX  = std::fabs(X);
@@ -284,60 +311,82 @@ return glm::normalize(glm::cross(tanZ, tanX));
 }
 
 // --- Constructor & Mesh Setup ---
+// Vertices and indices are generated in row tiles on worker threads;
+// each tile writes only its own slice of the preallocated arrays.
 Terrain::Terrain(int w, int d) : width(w), depth(d) {
-float halfW = width / 2.0f;
-float halfD = depth / 2.0f;
+const float halfW = width / 2.0f;
+const float halfD = depth / 2.0f;
+const int rowVerts = width + 1;
+const int tileRows = 32;
 
 // 1. Generate Vertices
-for (int z = 0; z <= depth; ++z) {
-for (int x = 0; x <= width; ++x) {
-    Vertex vertex;
-    float worldX = x - halfW;
-    float worldZ = z - halfD;
-    
-    float worldY = getHeight(worldX, worldZ);
-    vertex.Position = glm::vec3(worldX, worldY, worldZ);
-    vertex.Normal = getNormal(worldX, worldZ);
-    
-    vertex.TexCoords = glm::vec2(worldX / 15.0f, worldZ / 15.0f);
-    
-    vertices.push_back(vertex);
-}
-}
+vertices.resize(static_cast<size_t>(rowVerts) * (depth + 1));
+Parallel::ForTiles(depth + 1, tileRows, [&](int rowBegin, int rowEnd) {
+    for (int z = rowBegin; z < rowEnd; ++z) {
+    for (int x = 0; x <= width; ++x) {
+        Vertex& vertex = vertices[static_cast<size_t>(z) * rowVerts + x];
+        float worldX = x - halfW;
+        float worldZ = z - halfD;
+
+        float worldY = getHeight(worldX, worldZ);
+        vertex.Position = glm::vec3(worldX, worldY, worldZ);
+        vertex.Normal = getNormal(worldX, worldZ);
+
+        vertex.TexCoords = glm::vec2(worldX / 15.0f, worldZ / 15.0f);
+    }
+    }
+});
 
 // 2. Generate Indices
-for (int z = 0; z < depth; ++z) {
-for (int x = 0; x < width; ++x) {
-    int topLeft = (z * (width + 1)) + x;
-    int topRight = topLeft + 1;
-    int bottomLeft = ((z + 1) * (width + 1)) + x;
-    int bottomRight = bottomLeft + 1;
-
-    indices.push_back(topLeft);
-    indices.push_back(bottomLeft);
-    indices.push_back(topRight);
-
-    indices.push_back(topRight);
-    indices.push_back(bottomLeft);
-    indices.push_back(bottomRight);
+buildIndices();
+
+setupMesh(vertices.data(), vertices.size());
 }
+
+// Prebuilt vertices (e.g. from the world cache) are uploaded directly;
+// nothing is kept on the CPU side.
+Terrain::Terrain(int w, int d, const Vertex* prebuilt, size_t count) : width(w), depth(d) {
+buildIndices();
+setupMesh(prebuilt, count);
 }
 
-setupMesh();
+void Terrain::buildIndices() {
+const int rowVerts = width + 1;
+const int tileRows = 32;
+indices.resize(static_cast<size_t>(width) * depth * 6);
+Parallel::ForTiles(depth, tileRows, [&](int rowBegin, int rowEnd) {
+    for (int z = rowBegin; z < rowEnd; ++z) {
+    unsigned int* out = &indices[static_cast<size_t>(z) * width * 6];
+    for (int x = 0; x < width; ++x) {
+        unsigned int topLeft = (z * rowVerts) + x;
+        unsigned int topRight = topLeft + 1;
+        unsigned int bottomLeft = ((z + 1) * rowVerts) + x;
+        unsigned int bottomRight = bottomLeft + 1;
+
+        *out++ = topLeft;
+        *out++ = bottomLeft;
+        *out++ = topRight;
+
+        *out++ = topRight;
+        *out++ = bottomLeft;
+        *out++ = bottomRight;
+    }
+    }
+});
 }
 
-void Terrain::setupMesh() {
+void Terrain::setupMesh(const Vertex* data, size_t count) {
 glGenVertexArrays(1, &VAO);
 glGenBuffers(1, &VBO);
 glGenBuffers(1, &EBO);
 
-glBindVertexArray(VAO);
+GLState::BindVertexArray(VAO);
 
 glBindBuffer(GL_ARRAY_BUFFER, VBO);
-glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+glBufferData(GL_ARRAY_BUFFER, count * sizeof(Vertex), data, GL_STATIC_DRAW);
 
 glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
 glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
 glEnableVertexAttribArray(0);
@@ -348,17 +397,17 @@ glEnableVertexAttribArray(1);
 glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
 glEnableVertexAttribArray(2);
 
-glBindVertexArray(0);
+GLState::BindVertexArray(0);
 }
 
 void Terrain::Draw(unsigned int shaderProgram) {
-glBindVertexArray(VAO);
+GLState::BindVertexArray(VAO);
 glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-glBindVertexArray(0);
+GLState::BindVertexArray(0);
 }
 
 Terrain::~Terrain() {
-glDeleteVertexArrays(1, &VAO);
+GLState::DeleteVertexArrays(1, &VAO);
 glDeleteBuffers(1, &VBO);
 glDeleteBuffers(1, &EBO);
 }
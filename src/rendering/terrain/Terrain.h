@@ -11,17 +11,38 @@ struct Vertex {
 class Terrain {
 public:
     Terrain(int width, int depth);
+    Terrain(int width, int depth, const Vertex* prebuilt, size_t count);
     ~Terrain();
     static float getHeight(float x, float z);
     static glm::vec3 getNormal(float x, float z);
+
+    // Runtime map size (world units, centred on the origin).
+    // Must be set before the terrain and anything sampling it is built.
+    static void SetMapSize(int width, int depth);
+    static int MapWidth()  { return sMapWidth; }
+    static int MapDepth()  { return sMapDepth; }
+
+    // The cape, lake and rivers are authored for a kLayoutSize map;
+    // these convert between world and authored layout coordinates.
+    static constexpr float kLayoutSize = 600.0f;
+    static glm::vec2 LayoutScale();
+    static glm::vec2 ToLayout(float x, float z);
+    static glm::vec2 FromLayout(float x, float z);
     void Draw(unsigned int shaderProgram);
 
+    // Generated vertices (empty when built from prebuilt data)
+    const std::vector<Vertex>& GetVertices() const { return vertices; }
+
 private:
+    static int sMapWidth;
+    static int sMapDepth;
+
     int width, depth;
     unsigned int VAO, VBO, EBO;
     
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
-    void setupMesh();
+    void buildIndices();
+    void setupMesh(const Vertex* data, size_t count);
 };
\ No newline at end of file